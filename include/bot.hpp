@@ -0,0 +1,29 @@
+#ifndef BOT
+#define BOT
+
+#include "agent.hpp"
+using namespace std;
+
+class Hand;
+
+// A simple computer player that never draws by choice, always plays the card it draws when it can,
+// saves its wild cards for last, and names the color it holds the most of.
+// It keeps no state, so one GreedyAgent may be shared by any number of seats and threads.
+class GreedyAgent : public PlayerAgent
+{
+    public:
+        bool chooseDraw( const Game&, const Player& );
+        Card chooseCard( const Game&, const Player& );
+        bool choosePlayDrawn( const Game&, const Player&, Card );
+        int chooseColor( const Game&, const Player& );
+};
+
+int getMostHeldColor( const Hand& );
+
+// The greedy player's choice straight from a state of any rule set, for programs that play the variants, which Game
+// does not: it also always stacks a penalty and jumps in when it can, and swaps hands with the seat holding the fewest cards.
+// Under the standard rules it makes the same moves as a GreedyAgent.
+template < class State >
+Move chooseGreedyMove( const State&, const MoveList& );
+
+#endif
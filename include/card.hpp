@@ -1,17 +1,25 @@
 #ifndef CARD
 #define CARD
 
+#include <assert.h>
+#include <stdint.h>
+#include <string>
 using namespace std;
 
-const char COLOR_CHARS[] = { 'r', 'y', 'g', 'b', '_' };
+constexpr char COLOR_CHARS[] = { 'r', 'y', 'g', 'b', '_' };
+constexpr const char* COLOR_NAMES[] = { "Red", "Yellow", "Green", "Blue", "None" };
 const string COLOR_STRINGS[] = { "Red", "Yellow", "Green", "Blue", "None" };
 
-const char VALUE_CHARS[] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'D', 'R', 'S', 'W', 'X' };
+constexpr char VALUE_CHARS[] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'D', 'R', 'S', 'W', 'X' };
+constexpr const char* VALUE_NAMES[] = { "0", "1", "2", "3", "4", "5", "6", "7", "8", "9", "Draw2", "Reverse", "Skip", "Wild", "Draw4 Wild" };
 const string VALUE_STRINGS[] = { "0", "1", "2", "3", "4", "5", "6", "7", "8", "9", "Draw2", "Reverse", "Skip", "Wild", "Draw4 Wild" };
 
 // The total number of cards in a deck, including duplicates
 const int TOTAL_CARDS = 108;
 
+// The most decks a game can shuffle together
+const int MAX_DECKS = 8;
+
 const int N_COLORS = 4;
 const int NO_COLOR_INDEX = 4;
 
@@ -37,22 +45,181 @@ const int N_NUMBER_CARDS = 2;
 const int N_ACTION_CARDS = 2;
 const int N_WILD_CARDS = 4;
 
+// The most duplicates of any one card in a game, with every deck in play
+const int MAX_CARD_COPIES = N_WILD_CARDS * MAX_DECKS;
+
 const int ACTION_SCORE = 20;
 const int WILD_SCORE = 50;
 
-// An Uno card with a color and value (e.g. a number or action)
+// Every distinct card is identified by a one-byte id
+// Colored cards are numbered by color and then value, followed by the two wild cards, which have no color
+// This is also the order hands are sorted in
+const int N_COLORED_VALUES = LAST_ACTION_INDEX + 1;
+const int FIRST_WILD_ID = N_COLORS * N_COLORED_VALUES;
+const int N_CARD_IDS = FIRST_WILD_ID + LAST_WILD_INDEX - FIRST_WILD_INDEX + 1;
+
+// The longest long name is "Yellow Reverse"
+const int MAX_LONG_NAME_LENGTH = 16;
+
+// A set of card ids, where bit i is set if id i is in the set
+typedef uint64_t CardMask;
+
+// Returns the lowest id in the given set.
+// 
+// PRE: mask != 0
+// POST: 0 <= return value < N_CARD_IDS
+inline int
+lowestCardId( CardMask mask )
+{
+    return __builtin_ctzll( mask );
+}
+
+enum CardCategory
+{
+    NUMBER_CARD,
+    ACTION_CARD,
+    WILD_CARD
+};
+
+// Returns the id of the card with the given color and value.
+constexpr int
+cardId( int color, int value )
+{
+    return color == NO_COLOR_INDEX ? FIRST_WILD_ID + value - FIRST_WILD_INDEX : color * N_COLORED_VALUES + value;
+}
+
+// Properties of every card id, computed at compile time so that cards never need to branch on their value
+struct CardTables
+{
+    unsigned char colors[ N_CARD_IDS ];
+    unsigned char values[ N_CARD_IDS ];
+    unsigned char scores[ N_CARD_IDS ];
+    unsigned char categories[ N_CARD_IDS ];
+    unsigned char copies[ N_CARD_IDS ]; // How many of the card are in a full deck
+    char shortNames[ N_CARD_IDS ][ 3 ];
+    char longNames[ N_CARD_IDS ][ MAX_LONG_NAME_LENGTH ];
+
+    // colorMasks[ color ] is the set of cards of that color; NO_COLOR_INDEX gives the empty set
+    CardMask colorMasks[ N_COLORS + 1 ];
+
+    // playable[ stock ][ wildColor ] is the set of cards that can be played on the stock
+    // wildColor only matters when the stock is wild; NO_COLOR_INDEX then allows only wild cards
+    CardMask playable[ N_CARD_IDS ][ N_COLORS + 1 ];
+
+    // currentColors[ stock ][ wildColor ] is the set of cards of the color in play: the stock's color,
+    // or the color chosen for it if it is wild
+    CardMask currentColors[ N_CARD_IDS ][ N_COLORS + 1 ];
+};
+
+// Computes every entry of the card tables.
+constexpr CardTables
+buildCardTables()
+{
+    CardTables tables = {};
+
+    for ( int id = 0; id < N_CARD_IDS; id++ )
+    {
+        int color = id >= FIRST_WILD_ID ? NO_COLOR_INDEX : id / N_COLORED_VALUES;
+        int value = id >= FIRST_WILD_ID ? FIRST_WILD_INDEX + id - FIRST_WILD_ID : id % N_COLORED_VALUES;
+        tables.colors[ id ] = color;
+        tables.values[ id ] = value;
+        if ( color != NO_COLOR_INDEX )
+        {
+            tables.colorMasks[ color ] |= CardMask( 1 ) << id;
+        }
+
+        // Wild cards are worth the most, then action cards, and number cards are worth their face value
+        if ( value >= FIRST_WILD_INDEX )
+        {
+            tables.categories[ id ] = WILD_CARD;
+            tables.scores[ id ] = WILD_SCORE;
+            tables.copies[ id ] = N_WILD_CARDS;
+        }
+        else if ( value >= FIRST_ACTION_INDEX )
+        {
+            tables.categories[ id ] = ACTION_CARD;
+            tables.scores[ id ] = ACTION_SCORE;
+            tables.copies[ id ] = N_ACTION_CARDS;
+        }
+        else
+        {
+            tables.categories[ id ] = NUMBER_CARD;
+            tables.scores[ id ] = value;
+            tables.copies[ id ] = value == FIRST_NUMBER_INDEX ? N_0_CARDS : N_NUMBER_CARDS;
+        }
+
+        tables.shortNames[ id ][ 0 ] = COLOR_CHARS[ color ];
+        tables.shortNames[ id ][ 1 ] = VALUE_CHARS[ value ];
+
+        // Wild cards are named by just their value; other cards are named by color and value (e.g. Red Draw2)
+        int length = 0;
+        if ( color != NO_COLOR_INDEX )
+        {
+            for ( const char* c = COLOR_NAMES[ color ]; *c != '\0'; c++ )
+            {
+                tables.longNames[ id ][ length++ ] = *c;
+            }
+            tables.longNames[ id ][ length++ ] = ' ';
+        }
+        for ( const char* c = VALUE_NAMES[ value ]; *c != '\0'; c++ )
+        {
+            tables.longNames[ id ][ length++ ] = *c;
+        }
+    }
+
+    // A card can be played if it is wild, or if its color or value matches the stock
+    // If the stock is wild, the color chosen for it takes the place of the stock's color and value
+    for ( int stock = 0; stock < N_CARD_IDS; stock++ )
+    {
+        for ( int wildColor = 0; wildColor <= N_COLORS; wildColor++ )
+        {
+            CardMask playable = 0;
+            for ( int id = 0; id < N_CARD_IDS; id++ )
+            {
+                bool canPlay = false;
+                if ( tables.categories[ id ] == WILD_CARD )
+                {
+                    canPlay = true;
+                }
+                else if ( tables.categories[ stock ] == WILD_CARD )
+                {
+                    canPlay = tables.colors[ id ] == wildColor;
+                }
+                else
+                {
+                    canPlay = tables.colors[ id ] == tables.colors[ stock ] || tables.values[ id ] == tables.values[ stock ];
+                }
+
+                if ( canPlay )
+                {
+                    playable |= CardMask( 1 ) << id;
+                }
+            }
+            tables.playable[ stock ][ wildColor ] = playable;
+            int currentColor = tables.categories[ stock ] == WILD_CARD ? wildColor : tables.colors[ stock ];
+            tables.currentColors[ stock ][ wildColor ] = tables.colorMasks[ currentColor ];
+        }
+    }
+
+    return tables;
+}
+
+// An Uno card with a color and value (e.g. a number or action), stored as a one-byte id
 class Card
 {
     public:
         Card();
         Card( int, int );
+        static Card fromId( int );
 
+        int getId() const;
         int getColor() const;
         int getValue() const;
         string getColorAsString() const;
         string getValueAsString() const;
         string toStringShort() const;
         string toStringLong() const;
+        const char* getShortName() const;
         void printShort() const;
         void printLong() const;
 
@@ -64,9 +231,99 @@ class Card
         bool isEqual( Card ) const;
         bool isLessThan( Card ) const;
         bool isGreaterThan( Card ) const;
+
+        static constexpr CardTables TABLES = buildCardTables();
     private:
-        int color;
-        int value;
+        unsigned char id;
 };
 
+// The accessors below are called for every card on every turn, so they are defined here to be inlined
+// Each is a single load from the card tables
+
+// Returns the one-byte id of the card.
+// 
+// PRE: none
+// POST: 0 <= return value < N_CARD_IDS
+inline int
+Card::getId() const
+{
+    return id;
+}
+
+// Returns the integer color of the card.
+// 
+// PRE: none
+// POST: 0 <= return value < N_COLORS, or return value == NO_COLOR_INDEX
+inline int
+Card::getColor() const
+{
+    return TABLES.colors[ id ];
+}
+
+// Returns the integer value of the card.
+// 
+// PRE: none
+// POST: 0 <= return value < N_VALUES
+inline int
+Card::getValue() const
+{
+    return TABLES.values[ id ];
+}
+
+// Returns the point value of the card.
+// 
+// PRE: none
+// POST: none
+inline int
+Card::getScore() const
+{
+    return TABLES.scores[ id ];
+}
+
+// Returns true if this card is an action card.
+// In this implementation, wild cards are not considered action cards.
+// 
+// PRE: none
+// POST: none
+inline bool
+Card::isAction() const
+{
+    return TABLES.categories[ id ] == ACTION_CARD;
+}
+
+// Returns true if this card is a wild card.
+// 
+// PRE: none
+// POST: none
+inline bool
+Card::isWild() const
+{
+    return id >= FIRST_WILD_ID;
+}
+
+// Returns true if this card can be played on the given card.
+// 
+// PRE: if the other card is a wild card and this one is not, wildColor must be valid (0 <= wildColor < N_COLORS)
+//      otherwise 0 <= wildColor <= NO_COLOR_INDEX
+// POST: none
+inline bool
+Card::canPlayOn( Card other, int wildColor ) const
+{
+    // Assert that wildColor is valid
+    // It should not be required otherwise because a wild card might not have been played yet
+    assert( isWild() || !other.isWild() || ( wildColor >= 0 && wildColor < N_COLORS ) );
+
+    return ( TABLES.playable[ other.id ][ wildColor ] >> id ) & 1;
+}
+
+// Returns true if this card equals the given card.
+// 
+// PRE: none
+// POST: none
+inline bool
+Card::isEqual( Card other ) const
+{
+    return id == other.id;
+}
+
 #endif
\ No newline at end of file
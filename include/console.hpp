@@ -0,0 +1,40 @@
+#ifndef CONSOLE
+#define CONSOLE
+
+#include "agent.hpp"
+#include "events.hpp"
+#include "state.hpp"
+using namespace std;
+
+// An agent that prompts a human at the terminal for every decision.
+// A single ConsoleAgent may be shared by every seat for hot-seat play.
+class ConsoleAgent : public PlayerAgent
+{
+    public:
+        void confirmForcedDraw( const Game&, const Player& );
+        bool chooseDraw( const Game&, const Player& );
+        Card chooseCard( const Game&, const Player& );
+        bool choosePlayDrawn( const Game&, const Player&, Card );
+        int chooseColor( const Game&, const Player& );
+};
+
+// An event sink that narrates the round to cout.
+// The player whose turn it is is told what they draw, unless their hand is hidden because a computer plays it.
+class ConsoleEvents : public GameEvents
+{
+    public:
+        ConsoleEvents();
+        void hideHand( int );
+        void onFirstStock( const Game&, int, Card );
+        void onDraw( const Game&, int, Card );
+        void onTableEmpty( const Game&, int );
+        void onPlay( const Game&, int, Card );
+        void onDrawPenalty( const Game&, int, int nCards, int nDrawn );
+        void onReverse( const Game&, int );
+        void onSkip( const Game&, int );
+        void onColorChosen( const Game&, int, int color );
+    private:
+        bool hidden[ MAX_PLAYERS ]; // Whether each player's cards are kept off the terminal
+};
+
+#endif
@@ -0,0 +1,158 @@
+#ifndef CORPUS
+#define CORPUS
+
+#include <mutex>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "replay.hpp"
+#include "writer.hpp"
+using namespace std;
+
+// The first field of a corpus's meta file ("UNOC", in the machine's byte order), and its format version.
+// A corpus written on a machine of the other byte order fails the check rather than being misread.
+const uint32_t CORPUS_MAGIC = 0x434f4e55;
+const uint32_t CORPUS_VERSION = 2;
+
+// The value of the card column for a move that plays no card
+const uint8_t CORPUS_NO_CARD = 0xff;
+
+// The value of the winner column for a round that was abandoned
+const uint8_t CORPUS_NO_PLAYER = 0xff;
+
+// Every column of a corpus. The game columns have a row per game (and the round and move offsets one more);
+// the round columns have a row per round dealt, and the move columns a row per decision, each in the order they were played.
+enum CorpusColumnId
+{
+    CORPUS_SEED, // uint64_t: the seed the game's shuffles came from
+    CORPUS_STREAM, // uint64_t: the stream of the seed the game used
+    CORPUS_PLAYER_COUNT, // uint8_t
+    CORPUS_GOAL_SCORE, // uint32_t
+    CORPUS_WINNER, // uint8_t: the seat of the player who reached the goal score
+    CORPUS_ROUND_COUNT, // uint16_t: the rounds dealt, including any abandoned
+    CORPUS_TURN_COUNT, // uint32_t: the turns played, across every round
+    CORPUS_ROUND_OFFSET, // uint64_t: the first round row of each game, and after the last game the number of round rows
+    CORPUS_ROUND_FIRST_CARD, // uint8_t: the id of the card turned up to start the discard pile
+    CORPUS_ROUND_WINNER, // uint8_t: the seat of the player who went out, or CORPUS_NO_PLAYER
+    CORPUS_ROUND_POINTS, // uint16_t: the points the winner scored for the round
+    CORPUS_MOVE_OFFSET, // uint64_t: the first move row of each game, and after the last game the number of move rows
+    CORPUS_MOVE_ROUND, // uint16_t: the round of its game the move was made in, from 0
+    CORPUS_MOVE_TURN, // uint16_t: the turn of its round the move was made in, from 0
+    CORPUS_MOVE_PLAYER, // uint8_t: the seat of the player who made the move
+    CORPUS_MOVE_TYPE, // uint8_t: a MoveType
+    CORPUS_MOVE_CARD, // uint8_t: the id of the card played, or CORPUS_NO_CARD
+    CORPUS_MOVE_COLOR, // uint8_t: the color named, or NO_COLOR_INDEX
+    CORPUS_MOVE_HAND_SIZE, // uint8_t: the cards in the player's hand before the move
+    N_CORPUS_COLUMNS
+};
+
+// The columns of a corpus, or of rows to append to one, as arrays in memory. Rows are indexed directly:
+// the winner of game g is winners[ g ], and its moves are the move rows from moveOffsets[ g ] up to moveOffsets[ g + 1 ].
+struct CorpusColumns
+{
+    uint64_t nGames;
+    uint64_t nRounds;
+    uint64_t nMoves;
+    const uint64_t* seeds;
+    const uint64_t* streams;
+    const uint8_t* playerCounts;
+    const uint32_t* goalScores;
+    const uint8_t* winners;
+    const uint16_t* roundCounts;
+    const uint32_t* turnCounts;
+    const uint64_t* roundOffsets; // nGames + 1 rows
+    const uint8_t* roundFirstCards;
+    const uint8_t* roundWinners;
+    const uint16_t* roundPoints;
+    const uint64_t* moveOffsets; // nGames + 1 rows
+    const uint16_t* moveRounds;
+    const uint16_t* moveTurns;
+    const uint8_t* movePlayers;
+    const uint8_t* moveTypes;
+    const uint8_t* moveCards;
+    const uint8_t* moveColors;
+    const uint8_t* moveHandSizes;
+};
+
+// One game's rows, gathered while it is played, so that games played on many threads can each be appended whole.
+// It records decisions like a ReplayRecorder: through a RecordingAgent, with the caller marking each round and turn.
+// Beginning the next game keeps its memory, so a thread can reuse one for every game it plays.
+class CorpusGame : public DecisionRecorder
+{
+    public:
+        CorpusGame();
+        void beginGame( const ReplayHeader& );
+        void beginRound();
+        void endDeal( const GameState& );
+        void beginTurn();
+        void recordDecision( const Game&, const MoveList&, Move );
+        void endRound( int, int );
+        void endGame( const GameState& );
+        CorpusColumns getRows() const;
+    private:
+        uint64_t seed;
+        uint64_t stream;
+        uint8_t playerCount;
+        uint32_t goalScore;
+        uint8_t winner;
+        uint16_t roundCount; // The rounds begun so far
+        uint32_t turnCount; // The turns of the game begun so far
+        uint16_t turn; // The turns of the current round begun so far
+        uint64_t roundOffsets[ 2 ];
+        vector< uint8_t > roundFirstCards;
+        vector< uint8_t > roundWinners;
+        vector< uint16_t > roundPoints;
+        uint64_t moveOffsets[ 2 ];
+        vector< uint16_t > moveRounds;
+        vector< uint16_t > moveTurns;
+        vector< uint8_t > movePlayers;
+        vector< uint8_t > moveTypes;
+        vector< uint8_t > moveCards;
+        vector< uint8_t > moveColors;
+        vector< uint8_t > moveHandSizes;
+};
+
+// Writes a corpus: a directory holding one file per column, each a bare array of fixed-width values,
+// so a reader can map a column and index it with no parsing at all.
+// The meta file, which holds the row counts, is written last, so a corpus whose writer never closed cannot be opened.
+// Rows may be appended from any number of threads at once; each append lands whole.
+class CorpusWriter
+{
+    public:
+        CorpusWriter();
+        ~CorpusWriter();
+        bool open( const string& );
+        void append( const CorpusColumns& );
+        bool close();
+        uint64_t getGameCount() const;
+    private:
+        string directory;
+        BufferedWriter columns[ N_CORPUS_COLUMNS ];
+        uint64_t nGames;
+        uint64_t nRounds;
+        uint64_t nMoves;
+        bool opened;
+        mutex appendMutex;
+};
+
+// Reads a corpus by mapping each of its column files into memory. Nothing is copied or parsed:
+// the operating system pages columns in as they are touched, so a scan that reads only a few columns
+// only ever reads those columns from the disk.
+class Corpus
+{
+    public:
+        Corpus();
+        ~Corpus();
+        bool open( const string& );
+        void close();
+        const CorpusColumns& getColumns() const;
+    private:
+        CorpusColumns view;
+        void* mappings[ N_CORPUS_COLUMNS ];
+        size_t mappingSizes[ N_CORPUS_COLUMNS ];
+
+        Corpus( const Corpus& );
+        Corpus& operator=( const Corpus& );
+};
+
+#endif
@@ -2,6 +2,7 @@
 #define DECK
 
 #include "card.hpp"
+#include "random.hpp"
 using namespace std;
 
 // A stack-like implementation of a deck of cards
@@ -14,11 +15,12 @@ class Deck
         void push( Card );
         Card pop();
         Card peek() const;
+        Card getCardAt( int ) const;
         int getSize() const;
         bool isFull() const;
         bool isEmpty() const;
         void clear();
-        void shuffle();
+        void shuffle( Random& );
     private:
         int size; // The current size of the deck
         int capacity; // The maximum capacity of the deck
@@ -0,0 +1,57 @@
+#ifndef EVENTS
+#define EVENTS
+
+#include "card.hpp"
+using namespace std;
+
+class Game;
+
+// A sink for everything that happens during a round.
+// Every method does nothing by default, so a sink only overrides the events it cares about.
+// Each event names the player it concerns by index; the game can be asked for their name and hand.
+class GameEvents
+{
+    public:
+        virtual ~GameEvents();
+        virtual void onDeal( const Game&, int, Card );
+        virtual void onFirstStock( const Game&, int, Card );
+        virtual void onDraw( const Game&, int, Card );
+        virtual void onTableEmpty( const Game&, int );
+        virtual void onPlay( const Game&, int, Card );
+        virtual void onPenaltyCard( const Game&, int, Card );
+        virtual void onDrawPenalty( const Game&, int, int nCards, int nDrawn );
+        virtual void onReverse( const Game&, int );
+        virtual void onSkip( const Game&, int );
+        virtual void onColorChosen( const Game&, int, int color );
+        virtual void onReshuffle( const Game& );
+        virtual void onRoundScored( const Game&, int, int points );
+};
+
+// The most sinks one EventFanout can forward to
+const int MAX_EVENT_SINKS = 8;
+
+// A sink that forwards every event to several other sinks, in the order they were added,
+// so that e.g. the console and a bot's belief tracker can both follow one game.
+class EventFanout : public GameEvents
+{
+    public:
+        EventFanout();
+        void add( GameEvents* );
+        void onDeal( const Game&, int, Card );
+        void onFirstStock( const Game&, int, Card );
+        void onDraw( const Game&, int, Card );
+        void onTableEmpty( const Game&, int );
+        void onPlay( const Game&, int, Card );
+        void onPenaltyCard( const Game&, int, Card );
+        void onDrawPenalty( const Game&, int, int nCards, int nDrawn );
+        void onReverse( const Game&, int );
+        void onSkip( const Game&, int );
+        void onColorChosen( const Game&, int, int color );
+        void onReshuffle( const Game& );
+        void onRoundScored( const Game&, int, int points );
+    private:
+        GameEvents* sinks[ MAX_EVENT_SINKS ];
+        int nSinks;
+};
+
+#endif
@@ -2,42 +2,52 @@
 #define GAME
 
 #include <iostream>
-#include "player.hpp"
-#include "table.hpp"
+#include "agent.hpp"
+#include "events.hpp"
+#include "move.hpp"
+#include "state.hpp"
 using namespace std;
 
-const int MAX_PLAYERS = 6;
-const int STARTING_HAND_SIZE = 7;
-
-// A class to contain all game objects and facilitate interactions between them.
+// A class to connect a GameState to the people playing it.
+// The rules live in GameState; Game adds the players' names, the PlayerAgent that makes each player's decisions,
+// and the optional GameEvents sink. processPlayerTurn() asks the current player's agent to pick moves from legalMoves(),
+// and each move applied through Game is reported to the sink, so the rules themselves never touch cin or cout.
 class Game
 {
     public:
-        Game( string[], int );
+        Game( string[], PlayerAgent*[], int, int, GameEvents* = NULL );
+        void seed( uint64_t, uint64_t );
+        void setLazyShuffle( bool );
         void initializeRound();
-        void nextPlayer();
         void printTurnHeader() const;
         void processPlayerTurn();
+        void legalMoves( MoveList& ) const;
+        bool isLegalPlay( Card ) const;
+        UndoRecord apply( Move );
+        void undo( const UndoRecord& );
         bool roundIsOver() const;
-        Player& getRoundWinner();
+        int getRoundWinnerIndex() const;
         void scoreRound();
         void printScores() const;
         bool gameIsOver() const;
+
+        const GameState& getState() const;
+        string getPlayerName( int ) const;
+        int getPlayerCount() const;
+        int getCurrentPlayerIndex() const;
+        const Player& getPlayer( int ) const;
+        Card getStock() const;
+        int getWildColor() const;
+        bool isReversed() const;
+        int getPhase() const;
+        Card getDrawnCard() const;
     private:
-        Table table;
-        Player players[ MAX_PLAYERS ];
-        int nPlayers;
-        int currentPlayerIndex;
-        bool reverse;
-        bool skip;
-        int wildColor;
+        GameState state;
+        string names[ MAX_PLAYERS ];
+        PlayerAgent* agents[ MAX_PLAYERS ];
+        GameEvents* events;
 
-        int getColorInput() const;
-        int getNextPlayerIndex() const;
-        void drawCard();
-        Card getCardInput() const;
-        void drawUpTo( Player&, int );
-        void processCardAction( Card );
+        void reportMove( const UndoRecord& ) const;
 };
 
 #endif
@@ -2,9 +2,16 @@
 #define HAND
 
 #include "card.hpp"
+#include "zobrist.hpp"
 using namespace std;
 
-// A list of cards that is always sorted
+// The most cards a hand can hold: all but 1 of the cards in the largest game (one must always be face up)
+const int HAND_CAPACITY = MAX_DECKS * TOTAL_CARDS - 1;
+
+// A multiset of cards, stored as the number of copies of each card id.
+// add and remove( Card ) are O(1), including keeping its Zobrist hash up to date;
+// cards are indexed and iterated in sorted order (by id), so getCardAt and removeCardAt walk the distinct ids
+// and cost O(N_CARD_IDS). Hot paths that already hold the card should call remove( Card ).
 class Hand
 {
     public:
@@ -16,16 +23,23 @@ class Hand
         int getSize() const;
         bool isFull() const;
         bool isEmpty() const;
+        void remove( Card );
         void removeCardAt( int );
         void clear();
+        int count( Card ) const;
+        bool contains( Card ) const;
+        CardMask getMask() const;
+        CardMask playableMask( Card, int ) const;
         int find( Card ) const;
         int findString( string s ) const;
         int getScore() const;
+        uint64_t getHash() const;
     private:
-        int size; // The current size of the hand
-        int capacity; // The maximum capacity of the hand
-        Card cards[ TOTAL_CARDS - 1 ];
-        bool isSorted() const;
+        unsigned char counts[ N_CARD_IDS ]; // The number of copies of each card id
+        CardMask mask; // The ids with at least one copy
+        short size; // The current size of the hand
+        short score; // The sum of the scores of every card
+        uint64_t hash; // The Zobrist hash of the cards, kept up to date as they are added and removed
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,106 @@
+#ifndef LOG
+#define LOG
+
+#include <string>
+#include <vector>
+#include "bits.hpp"
+#include "events.hpp"
+#include "writer.hpp"
+using namespace std;
+
+// The first bytes of every session of a log ("UNOL", read least significant byte first), and its format version
+const uint64_t LOG_MAGIC = 0x4c4f4e55;
+const int LOG_VERSION = 1;
+
+// The width of each field of a log record, in bits
+const int LOG_MAGIC_BITS = 32;
+const int LOG_VERSION_BITS = 8;
+const int LOG_TYPE_BITS = 4;
+const int LOG_PLAYER_BITS = 3; // Enough for MAX_PLAYERS seats
+const int LOG_CARD_BITS = 6; // Enough for N_CARD_IDS card ids
+const int LOG_COLOR_BITS = 3; // Enough for the colors and NO_COLOR_INDEX
+const int LOG_PENALTY_BITS = 3; // Enough for the 4 cards of a Draw4 Wild
+const int LOG_POINTS_BITS = 16;
+const int LOG_GOAL_BITS = 32;
+
+// The kinds of record in a log. Every record starts with its type, and all but the last few go on with a player index.
+enum LogEventType
+{
+    LOG_GAME_START, // A game began: its seed and stream, the number of players, and the goal score
+    LOG_DEAL, // A card was dealt to a player
+    LOG_FIRST_STOCK, // The first stock of a round was turned over
+    LOG_DRAW, // A player drew a card on their turn
+    LOG_TABLE_EMPTY, // A player could not draw because the table was empty
+    LOG_PLAY, // A player played a card
+    LOG_PENALTY_CARD, // A player drew a card for a Draw2 or Draw4 Wild
+    LOG_DRAW_PENALTY, // A player was made to draw: the cards owed and the cards actually drawn
+    LOG_REVERSE, // A player reversed the direction of play
+    LOG_SKIP, // A player was skipped
+    LOG_COLOR_CHOSEN, // A player named the color of a wild card
+    LOG_RESHUFFLE, // The discard pile became the draw pile
+    LOG_ROUND_SCORED, // A player won a round and scored its points
+    LOG_END = 15 // The end of a session; another session may follow from the next byte
+};
+
+// One record of a log, as read back by EventLogReader. Only the fields its type uses are set.
+struct LogEvent
+{
+    unsigned char type;
+    unsigned char playerIndex;
+    Card card; // The card dealt, turned over, drawn, or played
+    int value; // The color named, the cards owed, the points scored, or the goal score
+    int count; // The cards actually drawn for a penalty, or the number of players
+    uint64_t seed; // The seed and stream a game was started with
+    uint64_t stream;
+};
+
+// An event sink that records every event of the games it follows as a compact binary log.
+// Records are bit-packed, with no padding between them: a play or a draw takes 13 bits, and a card 6 of them.
+// They go through a BufferedWriter, so logging a game costs a few memory writes per event and the occasional large write.
+// Each log opened on a writer is a session, which starts with LOG_MAGIC and ends with a LOG_END record padded to a byte,
+// so sessions can be appended to one file one after another.
+class EventLog : public GameEvents
+{
+    public:
+        EventLog( BufferedWriter& );
+        ~EventLog();
+        void beginGame( uint64_t, uint64_t, int, int );
+        void finish();
+
+        void onDeal( const Game&, int, Card );
+        void onFirstStock( const Game&, int, Card );
+        void onDraw( const Game&, int, Card );
+        void onTableEmpty( const Game&, int );
+        void onPlay( const Game&, int, Card );
+        void onPenaltyCard( const Game&, int, Card );
+        void onDrawPenalty( const Game&, int, int nCards, int nDrawn );
+        void onReverse( const Game&, int );
+        void onSkip( const Game&, int );
+        void onColorChosen( const Game&, int, int color );
+        void onReshuffle( const Game& );
+        void onRoundScored( const Game&, int, int points );
+    private:
+        BufferedWriter& out;
+        BitWriter bits;
+        bool finished;
+
+        void writeCardEvent( int, int, Card );
+};
+
+// Reads the records of a log file written by EventLog, session after session.
+// A session that never finished (e.g. because its process died) ends what can be read.
+class EventLogReader
+{
+    public:
+        EventLogReader();
+        bool open( const string& );
+        bool next( LogEvent& );
+        bool isCorrupt() const;
+    private:
+        vector< unsigned char > data;
+        BitReader bits;
+        bool inSession;
+        bool corrupt;
+};
+
+#endif
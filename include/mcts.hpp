@@ -0,0 +1,63 @@
+#ifndef MCTS
+#define MCTS
+
+#include <chrono>
+#include <vector>
+#include "agent.hpp"
+#include "belief.hpp"
+#include "pool.hpp"
+#include "random.hpp"
+#include "state.hpp"
+using namespace std;
+
+// A playout is abandoned after this many moves; this only happens if every hand is stuck with the table empty
+const int MAX_PLAYOUT_MOVES = 1000;
+
+// The time a search may take by default. A turn needs at most two searches (whether to draw, then whether to play the
+// drawn card), so a bot filling a seat at this budget keeps its turns under 100 ms
+const int DEFAULT_MCTS_MILLIS_PER_MOVE = 40;
+
+// One node of a search tree: the position reached by making a move from its parent.
+// Nodes refer to each other by index into their tree's node array, so a tree can grow without invalidating them.
+struct MctsNode
+{
+    Move move; // The move that led here from the parent
+    unsigned char moverIndex; // The player who made the move
+    int parent;
+    int firstChild;
+    int nextSibling;
+    int visits;
+    int availability; // The number of visits to the parent in which the move was legal
+    float wins; // The number of those visits' playouts the mover won
+};
+
+// A computer player that searches with Information Set Monte Carlo Tree Search.
+// Each iteration deals the cards it cannot see into a random, consistent arrangement (a determinization),
+// walks down the tree choosing among the moves legal in that arrangement, and finishes the round with a random playout.
+// The search is root-parallel: every thread grows its own tree from the same position, and their root statistics are
+// summed to pick the move. A search stops when the time budget runs out or, if set, after a fixed number of iterations.
+// The threads share nothing while searching, not even a transposition table (see transposition.hpp).
+// Without a belief tracker for the searching seat, determinizations deal the unseen cards uniformly at random.
+// An MctsAgent may be shared by several seats, but not used by several games at once.
+class MctsAgent : public PlayerAgent
+{
+    public:
+        MctsAgent( int nThreads, int millisPerMove, uint64_t seed, int iterationsPerMove = 0 );
+        Move chooseMove( const Game&, const MoveList& );
+
+        Move search( const GameState&, const MoveList& );
+        long getLastPlayouts() const;
+        void setBeliefTracker( int, const BeliefTracker* );
+    private:
+        WorkStealingPool pool;
+        int millisPerMove;
+        int iterationsPerMove;
+        Random random;
+        vector< vector< MctsNode > > trees; // One tree per thread, kept between searches so their memory is reused
+        long lastPlayouts;
+        const BeliefTracker* trackers[ MAX_PLAYERS ]; // The tracker to determinize with for each seat, or NULL
+
+        long growTree( vector< MctsNode >&, const GameState&, Random&, chrono::steady_clock::time_point );
+};
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef MOVE
+#define MOVE
+
+#include "card.hpp"
+using namespace std;
+
+// The kinds of decision a player can make
+enum MoveType
+{
+    PLAY_CARD, // Play a card from the hand (naming a color if it is wild)
+    DRAW_CARD, // Draw a card instead of playing
+    PLAY_DRAWN, // Play the card just drawn (naming a color if it is wild)
+    KEEP_DRAWN, // Keep the card just drawn and end the turn
+    CHOOSE_COLOR, // Name the color of a wild card turned over as the first stock
+    SWAP_HANDS, // Swap hands with another player after playing a 7 (only under the 7-0 rule)
+    PASS // Decline to jump in (only under the jump-in rule)
+};
+
+// The most legal moves any position can have: a hand can hold at most 16 playable colored cards
+// (the 13 of the stock's color and 3 of its value in other colors), plus 4 colors for each of the 2 wild cards, plus drawing.
+// Under the 7-0 rule a player also chooses among every other seat, so BasicGameState only allows that rule at tables of at
+// most MAX_MOVES + 1 seats.
+const int MAX_MOVES = 32;
+
+// A single decision by the current player, small enough to pass by value
+class Move
+{
+    public:
+        Move();
+        Move( int, Card, int );
+        static Move playCard( Card, int );
+        static Move drawCard();
+        static Move playDrawn( Card, int );
+        static Move keepDrawn();
+        static Move chooseColor( int );
+        static Move swapHands( int );
+        static Move pass();
+
+        int getType() const;
+        Card getCard() const;
+        int getColor() const;
+        int getTarget() const;
+        bool isEqual( Move ) const;
+        string toString() const;
+    private:
+        unsigned char type;
+        Card card; // The card played, for PLAY_CARD and PLAY_DRAWN
+        unsigned char color; // The color named for a wild card, otherwise NO_COLOR_INDEX
+        unsigned char target; // The player to swap hands with, for SWAP_HANDS
+};
+
+// A fixed-capacity list of moves, meant to live on the stack so that generating moves never allocates
+class MoveList
+{
+    public:
+        MoveList();
+        void clear();
+        void add( Move );
+        int getSize() const;
+        bool isEmpty() const;
+        Move get( int ) const;
+        int find( Move ) const;
+    private:
+        Move moves[ MAX_MOVES ];
+        int size;
+};
+
+#endif
@@ -5,21 +5,24 @@
 #include "table.hpp"
 using namespace std;
 
+// A seat's hand and score. Players hold no names, so a GameState made of them stays trivially copyable.
 class Player
 {
     public:
         Player();
-        Player( string );
-        string getName() const;
         int getScore() const;
         Hand& getHand();
+        const Hand& getHand() const;
         void setScore( int );
-        Card drawCard( Table& );
-        void drawCards( int nCards, Table& );
-        void playCard( Card, Table&, int wildColor );
-        void playCardIndex( int, Table&, int wildColor );
+        template < int N_DECKS >
+        Card drawCard( BasicTable< N_DECKS >& );
+        template < int N_DECKS >
+        void drawCards( int nCards, BasicTable< N_DECKS >& );
+        template < int N_DECKS >
+        void playCard( Card, BasicTable< N_DECKS >&, int wildColor );
+        template < int N_DECKS >
+        void playCardIndex( int, BasicTable< N_DECKS >&, int wildColor );
     private:
-        string name;
         int score;
         Hand hand;
 };
@@ -0,0 +1,20 @@
+#ifndef POOL
+#define POOL
+
+#include <functional>
+using namespace std;
+
+// A pool of worker threads that runs a batch of independent, numbered tasks.
+// Each worker starts with an equal share of the task indices and, once its share runs out,
+// steals half of the remaining share of another worker, so uneven task lengths never leave a core idle.
+class WorkStealingPool
+{
+    public:
+        WorkStealingPool( int );
+        int getThreadCount() const;
+        void run( int, const function< void( int, int ) >& );
+    private:
+        int nThreads;
+};
+
+#endif
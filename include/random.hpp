@@ -0,0 +1,28 @@
+#ifndef RANDOM
+#define RANDOM
+
+#include <stdint.h>
+using namespace std;
+
+// A small, fast pseudorandom number generator (PCG32: a 64-bit LCG with a permuted 32-bit output).
+// Every Table owns one, so games never contend for shared random state, and any game can be reproduced from its seed.
+// Generators with the same seed but different streams produce independent sequences, which lets parallel workers
+// share one seed and use, e.g., their game number as the stream.
+class Random
+{
+    public:
+        Random();
+        Random( uint64_t, uint64_t );
+        void seed( uint64_t, uint64_t );
+        uint32_t next();
+        uint32_t nextBelow( uint32_t );
+        uint64_t getHash() const;
+        uint64_t getState() const;
+        uint64_t getIncrement() const;
+        void setState( uint64_t, uint64_t );
+    private:
+        uint64_t state;
+        uint64_t increment; // Always odd; selects the stream
+};
+
+#endif
@@ -0,0 +1,159 @@
+#ifndef REPLAY
+#define REPLAY
+
+#include <string>
+#include <vector>
+#include "agent.hpp"
+#include "bits.hpp"
+#include "state.hpp"
+#include "writer.hpp"
+using namespace std;
+
+// The first bytes of every session of a replay file ("UNOR", read least significant byte first), and its format version
+const uint64_t REPLAY_MAGIC = 0x524f4e55;
+const int REPLAY_VERSION = 3;
+
+// The last bytes of every session ("UNOI"), which end the trailer that locates its index
+const uint64_t REPLAY_INDEX_MAGIC = 0x494f4e55;
+
+// The width of each field of a replay file, in bits
+const int REPLAY_MAGIC_BITS = 32;
+const int REPLAY_VERSION_BITS = 8;
+const int REPLAY_PLAYER_BITS = 3; // Enough for MAX_PLAYERS seats
+const int REPLAY_GOAL_BITS = 32;
+const int REPLAY_TURN_LIMIT_BITS = 32;
+const int REPLAY_COUNT_BITS = 32; // Keyframe intervals, turns, and the sizes of an index
+const int REPLAY_GENERATOR_BITS = 64; // Each half of the state of a shuffling generator
+const int REPLAY_OFFSET_BITS = 64;
+
+// The size of the trailer that ends a session: the offset of its index and its length, and REPLAY_INDEX_MAGIC
+const int REPLAY_TRAILER_BYTES = ( 2 * REPLAY_OFFSET_BITS + REPLAY_MAGIC_BITS ) / 8;
+
+// Everything besides the players' decisions that determines a game
+struct ReplayHeader
+{
+    uint64_t seed; // The seed and stream the game's shuffles came from
+    uint64_t stream;
+    int nPlayers;
+    int goalScore;
+    int maxTurnsPerRound; // A round was abandoned after this many turns, or never if 0
+    bool lazyShuffle;
+};
+
+// A destination for the decisions a RecordingAgent passes on
+class DecisionRecorder
+{
+    public:
+        virtual ~DecisionRecorder();
+        virtual void recordDecision( const Game&, const MoveList&, Move ) = 0;
+};
+
+// Records games as their seeds and the decisions their players made, which is all it takes to play them again.
+// Each decision is stored as its index in the list of legal moves, in just enough bits to tell that list apart,
+// and a decision with only one legal move is not stored at all, so a typical turn costs a few bits.
+// At the start of every keyframeInterval-th round of a game, the recorder also stores a keyframe, from which a replay can
+// resume without replaying the rounds before it. Between rounds, all that is left of the rounds before is the scores
+// and the state of the shuffling generator, so a keyframe holds just those, field by field: about 20 bytes.
+// Like EventLog, a recorder writes one session of its file. A session starts with REPLAY_MAGIC and ends with an index
+// of where each game and keyframe starts, followed by a trailer, so a reader can find the index from the end of the file.
+class ReplayRecorder : public DecisionRecorder
+{
+    public:
+        ReplayRecorder( BufferedWriter&, int = 0 );
+        ~ReplayRecorder();
+        void beginGame( const ReplayHeader& );
+        void beginRound( const GameState& );
+        void beginTurn();
+        void recordDecision( const Game&, const MoveList&, Move );
+        void finish();
+
+        static int getChoiceBits( int );
+    private:
+        BufferedWriter& out;
+        BitWriter bits;
+        uint64_t sessionStart; // The bytes the writer had written when the session started
+        int keyframeInterval;
+        int gameTurn; // The turns of the current game started so far
+        int gameRound; // The rounds of the current game started so far
+        vector< uint64_t > gameOffsets; // Where each game starts, in bytes from the start of the session
+        vector< uint32_t > gameKeyframes; // The index of each game's first keyframe
+        vector< uint64_t > keyframeOffsets; // Where each keyframe starts
+        vector< uint32_t > keyframeTurns; // The turn of its game that starts the round each keyframe was taken before
+        bool finished;
+
+        uint64_t getOffset() const;
+};
+
+// An agent that passes every decision on to another agent and records the move it chose.
+// One RecordingAgent may be shared by every seat of a game, as long as its inner agent may be.
+class RecordingAgent : public PlayerAgent
+{
+    public:
+        RecordingAgent( PlayerAgent&, DecisionRecorder& );
+        Move chooseMove( const Game&, const MoveList& );
+    private:
+        PlayerAgent& inner;
+        DecisionRecorder& recorder;
+};
+
+// Plays back the games of a replay file straight on a GameState, with no agents or events.
+// replayNext() plays whole games in order; seek() jumps to any turn of any game by loading the last keyframe before it
+// and replaying the few rounds after it, and playTurn() steps forward from there.
+class Replayer
+{
+    public:
+        Replayer();
+        bool open( const string& );
+        bool replayNext();
+        bool seek( int, int );
+        bool playTurn();
+        const GameState& getState() const;
+        const ReplayHeader& getHeader() const;
+        int getTurn() const;
+        int getGameCount() const;
+        uint64_t getDecisionCount() const;
+        bool isIndexed() const;
+        bool isCorrupt() const;
+    private:
+        // Where a game of the file starts, and the keyframes it has
+        struct GameEntry
+        {
+            size_t offset; // In bytes from the start of the file
+            int firstKeyframe; // The index in keyframes of its first keyframe
+            int nKeyframes;
+            int keyframeInterval;
+        };
+
+        // Where a keyframe starts in the file, and the turn that starts the round it was taken before
+        struct KeyframeEntry
+        {
+            size_t offset;
+            int turn;
+        };
+
+        vector< unsigned char > data;
+        BitReader bits;
+        GameState state;
+        ReplayHeader header; // The header of the current game
+        vector< GameEntry > games;
+        vector< KeyframeEntry > keyframes;
+        uint64_t nDecisions; // The decisions replayed so far, including forced ones
+        int keyframeInterval; // The keyframe interval of the current session, in rounds
+        int gameTurn; // The turns of the current game played so far
+        int gameRound; // The rounds of the current game dealt so far
+        bool inSession;
+        bool inGame;
+        bool inRound; // Whether the current round has been dealt and is still being played
+        bool turnStarted; // Whether the current turn's round has been dealt and its keyframe passed
+        bool indexed;
+        bool corrupt;
+
+        bool beginSession();
+        bool beginGame();
+        bool startTurn();
+        bool readDecision( const MoveList&, Move& );
+        bool readKeyframe();
+        void buildIndex();
+};
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef RULES
+#define RULES
+
+using namespace std;
+
+// The values of the number cards with an effect when SEVEN_ZERO is on
+const int SWAP_HANDS_VALUE = 7;
+const int ROTATE_HANDS_VALUE = 0;
+
+// Rule sets, passed to BasicGameState as a template parameter.
+// Every rule is a compile-time constant, so a game state is compiled separately for each rule set and the rules it
+// leaves off cost nothing at all; there is no runtime switch on the rules anywhere in the hot path.
+// A new rule set can derive from one of these and override some of its rules, but must also be instantiated at the
+// bottom of state.cpp.
+
+// The rules of the spec this game was written to: Draw2 and Draw4 Wild do not skip the player who draws,
+// and nothing else is allowed
+struct StandardRules
+{
+    static constexpr bool DRAW2_SKIPS = false; // The player who draws for a Draw2 also loses their turn
+    static constexpr bool DRAW4_SKIPS = false; // The player who draws for a Draw4 Wild also loses their turn
+    static constexpr bool STACKING = false; // A Draw2 or Draw4 Wild may be answered with another of the same kind,
+                                            // passing on the combined penalty
+    static constexpr bool SEVEN_ZERO = false; // Playing a 7 swaps hands with a chosen player,
+                                              // and playing a 0 passes every hand on in the direction of play
+    static constexpr bool JUMP_IN = false; // A player holding a card identical to the stock may play it out of turn
+    static constexpr bool DRAW_UNTIL_PLAYABLE = false; // A player who draws keeps drawing until they draw a playable card
+};
+
+// The official rules: the player who draws for a Draw2 or Draw4 Wild also loses their turn
+struct OfficialRules : StandardRules
+{
+    static constexpr bool DRAW2_SKIPS = true;
+    static constexpr bool DRAW4_SKIPS = true;
+};
+
+// The official rules with every popular house rule
+struct HouseRules : OfficialRules
+{
+    static constexpr bool STACKING = true;
+    static constexpr bool SEVEN_ZERO = true;
+    static constexpr bool JUMP_IN = true;
+    static constexpr bool DRAW_UNTIL_PLAYABLE = true;
+};
+
+// Table sizes, passed to BasicGameState as its second template parameter.
+// The seats and the card pool are sized for the limits at compile time, so a standard state stays a few hundred bytes
+// and only the states compiled for large tables pay for them. Hands hold counts of each card rather than slots, so their
+// size does not depend on the limits at all.
+// A new set of limits with a new deck count must also be instantiated at the bottom of table.cpp and player.cpp.
+
+// A single deck and at most 6 seats, as Game, the agents, and the programs play
+struct StandardLimits
+{
+    static constexpr int MAX_SEATS = 6;
+    static constexpr int N_DECKS = 1;
+};
+
+// Tournament tables: up to 64 seats, dealt from 5 decks shuffled together (4 would not cover 64 starting hands)
+struct TournamentLimits
+{
+    static constexpr int MAX_SEATS = 64;
+    static constexpr int N_DECKS = 5;
+};
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef SOLVER
+#define SOLVER
+
+#include "state.hpp"
+#include "transposition.hpp"
+using namespace std;
+
+// The transposition table's depth of a position whose every line was followed to the end of the round
+const int SOLVED_DEPTH = 255;
+
+// The deepest a solver may search, in moves; deeper values would not fit beside SOLVED_DEPTH in a table entry
+const int MAX_SOLVER_DEPTH = SOLVED_DEPTH - 1;
+
+// What solving a position found
+struct SolverResult
+{
+    int outcome; // 1 if the player to move can force a win, -1 if they cannot avoid a loss, 0 if the search could not tell
+    int scoreSwing; // The points the round is worth to the winner: at least this many, or exactly if exact is true
+    Move bestMove;
+    bool exact; // True if every line was followed to the end of the round, so scoreSwing is exact
+    int depth; // The depth of the last search, in moves
+    long nodes; // The number of positions searched, across every iteration
+};
+
+// A solver for the end of a round when the location of every card is known: a finished game being analyzed with its
+// real draw pile, or a determinization. The draw pile and its generator are part of the position, so draws are not
+// chance events, and the round is a game of perfect information.
+// The search is paranoid: the player to move maximizes their result and every opponent minimizes it, which is exact
+// for two players and the guaranteed result for more. It is an alpha-beta search with iterative deepening up to a depth
+// cap, making and unmaking moves on one state and remembering results in a transposition table, so positions reached
+// by playing the same cards in a different order are solved once.
+// A player may always draw instead of playing, so some lines never end; those count as undecided at the depth cap.
+// Each side prefers undecided to losing, so a decided outcome is proven even when some lines were cut off.
+// With no hand above 4 cards, a depth cap of 16 takes a median of about 5 ms, but the slowest of 40 such endgames takes
+// from a tenth of a second to a few seconds (uno_check times them; seeds 1-6 ranged from 106 ms to 3.4 s).
+// uno_replay solve solves any recorded position with its real draw pile.
+class EndgameSolver
+{
+    public:
+        EndgameSolver( int log2TableSize, int maxDepth );
+        static bool isEndgame( const GameState&, int );
+        SolverResult solve( const GameState& );
+    private:
+        TranspositionTable table;
+        int maxDepth;
+        int rootIndex; // The player to move in the position being solved
+        uint64_t rootKey; // Mixed into every hash, since values depend on whose point of view they are from
+        long nodes;
+
+        int search( GameState&, int, int, int, bool& );
+};
+
+#endif
@@ -0,0 +1,133 @@
+#ifndef STATE
+#define STATE
+
+#include <type_traits>
+#include "move.hpp"
+#include "player.hpp"
+#include "rules.hpp"
+#include "table.hpp"
+using namespace std;
+
+// The most players Game, the agents, and the programs support
+const int MAX_PLAYERS = StandardLimits::MAX_SEATS;
+const int STARTING_HAND_SIZE = 7;
+
+// The programs abandon a round after this many turns; this only happens if every hand is stuck with the table empty.
+// Recordings store the limit they were made with, and the reinforcement learning interface keeps its own copy for C
+// callers, UNO_MAX_TURNS_PER_ROUND, which env.cpp checks against this one.
+const int MAX_TURNS_PER_ROUND = 10000;
+
+// The points of a turn at which the current player must make a decision
+enum GamePhase
+{
+    PLAY_PHASE, // Play a card from the hand or draw
+    DRAWN_CARD_PHASE, // Play or keep the playable card just drawn
+    FIRST_COLOR_PHASE, // Name the color of the wild card turned over as the first stock
+    PENALTY_PHASE, // Pass on a stacked Draw2 or Draw4 Wild penalty with another of the same kind, or start drawing it
+    FORCED_DRAW_PHASE, // Keep drawing: the rest of a stacked penalty, or until drawing a playable card
+    SWAP_PHASE, // Choose the player to swap hands with after playing a 7
+    JUMP_IN_PHASE // Play a card identical to the stock out of turn, or pass
+};
+
+// Everything needed to take back one move, returned by GameState::apply() and passed to GameState::undo().
+// It holds only the cards that moved and the few fields the move changed, so it is far cheaper than copying the state.
+struct UndoRecord
+{
+    Move move;
+    TableState table; // The piles and generator before the move
+    Card drawnCard; // The state's drawn card before the move
+    Card drawn[ MAX_REWIND_DRAWS ]; // The cards the move drew, in order
+    unsigned char nDrawn;
+    unsigned char targetIndex; // The player who drew the cards or was skipped
+    unsigned char playerIndex; // The player who made the move
+    unsigned char wildColor;
+    unsigned char phase;
+    unsigned char pendingPenalty;
+    unsigned char jumpTurnIndex;
+    unsigned char jumpPlayerIndex;
+    bool reverse;
+    bool skip;
+    int turnNumber;
+};
+
+// The complete state of a game and the rules that change it: the piles, every hand and score, and whose turn it is.
+// It holds no pointers, names, or agents, so it is trivially copyable and only a few hundred bytes;
+// a server can park any number of idle tables as plain GameStates, and a search can copy one freely.
+// Game wraps a GameState with the players' names, their agents, and an event sink.
+// The rules and the table size are template parameters (see rules.hpp); GameState, which Game and the search agents use,
+// plays the standard rules at a standard table, and the others are compiled into their own classes with no runtime cost.
+template < class Rules, class Limits = StandardLimits >
+class BasicGameState
+{
+    static_assert( Limits::MAX_SEATS >= 2 && Limits::MAX_SEATS <= 255, "A seat index must fit in a byte" );
+    static_assert( Limits::MAX_SEATS * STARTING_HAND_SIZE < Limits::N_DECKS * TOTAL_CARDS,
+                   "There must be enough cards to deal every seat a starting hand" );
+    static_assert( !Rules::SEVEN_ZERO || Limits::MAX_SEATS - 1 <= MAX_MOVES,
+                   "Under the 7-0 rule, a move list must hold a swap with every other seat" );
+
+    public:
+        BasicGameState( int, int );
+        void seed( uint64_t, uint64_t );
+        void setLazyShuffle( bool );
+        void setGenerator( const Random& );
+        void setScore( int, int );
+        void initializeRound();
+        void nextPlayer();
+        void legalMoves( MoveList& ) const;
+        bool isLegalPlay( Card ) const;
+        UndoRecord apply( Move );
+        void undo( const UndoRecord& );
+        void determinize( int, Random& );
+        void dealUnseen( int, const Card[], Random& );
+        bool roundIsOver() const;
+        int getRoundWinnerIndex() const;
+        void scoreRound();
+        bool gameIsOver() const;
+        uint64_t getHash() const;
+
+        int getGoalScore() const;
+        int getPlayerCount() const;
+        int getCurrentPlayerIndex() const;
+        int getTurnNumber() const;
+        int getNextPlayerIndex() const;
+        const Player& getPlayer( int ) const;
+        const BasicTable< Limits::N_DECKS >& getTable() const;
+        Card getStock() const;
+        int getWildColor() const;
+        bool isReversed() const;
+        int getPhase() const;
+        Card getDrawnCard() const;
+    private:
+        BasicTable< Limits::N_DECKS > table;
+        Player players[ Limits::MAX_SEATS ];
+        int goalScore;
+        unsigned char nPlayers;
+        unsigned char currentPlayerIndex;
+        unsigned char wildColor;
+        unsigned char phase;
+        bool reverse;
+        bool skip;
+        Card drawnCard; // The card just drawn, during DRAWN_CARD_PHASE
+        int turnNumber; // Counts completed turns, so a caller can tell when the turn has ended
+        unsigned char pendingPenalty; // The cards still to be drawn for a stacked penalty
+        unsigned char jumpTurnIndex; // During JUMP_IN_PHASE, the player whose turn it will be if nobody jumps in
+        unsigned char jumpPlayerIndex; // During JUMP_IN_PHASE, the player who played the stock
+
+        CardMask legalPlayMask() const;
+        void endTurn();
+        void endPlay( int );
+        int findJumpIn( int ) const;
+        void rotateHands( bool );
+        void drawUpTo( int, int, UndoRecord& );
+        void playCard( Card, int, UndoRecord& );
+        void processCardAction( Card, UndoRecord& );
+};
+
+typedef BasicGameState< StandardRules > GameState;
+typedef BasicGameState< OfficialRules > OfficialGameState;
+typedef BasicGameState< HouseRules > HouseGameState;
+typedef BasicGameState< OfficialRules, TournamentLimits > TournamentGameState;
+
+static_assert( is_trivially_copyable< GameState >::value, "GameState must stay trivially copyable" );
+
+#endif
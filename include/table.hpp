@@ -4,23 +4,77 @@
 #include <iostream>
 #include "card.hpp"
 #include "deck.hpp"
+#include "random.hpp"
+#include "zobrist.hpp"
 using namespace std;
 
+// The most cards drawn from the table by a single move (the penalty of a Draw4 Wild)
+const int MAX_REWIND_DRAWS = 4;
+
+// The position of both piles and the state of the shuffling generator, saved so that Table::rewind() can undo a move.
+// The cards themselves are not saved: every shuffle can be replayed from the generator state, so it can be undone in place.
+struct TableState
+{
+    Random random;
+    short discardBase;
+    short discardSize;
+    short drawSize;
+};
+
 // A class containing the draw and discard piles and acting as an interface for interacting with them.
-class Table
+// Both piles live in one circular pool of cards, ordered (going forward from discardBase):
+// the discard pile from bottom to top, the free slots of cards in players' hands, then the draw pile from top to bottom.
+// The draw pile ends where the discard pile begins, so when the draw pile runs out,
+// every discard but the top one becomes the new draw pile just by moving the partition; no cards are copied.
+// In lazy shuffle mode the draw pile is never shuffled as a whole: each draw instead picks a random card from the pile
+// (one step of a Fisher-Yates shuffle), which deals cards with the same distribution but only pays for the cards drawn.
+// The number of full decks shuffled together is a template parameter, so the pool is exactly as large as the game needs.
+template < int N_DECKS >
+class BasicTable
 {
     public:
-        Table();
+        static_assert( N_DECKS >= 1 && N_DECKS <= MAX_DECKS, "A table must have between 1 and MAX_DECKS decks" );
+        static constexpr int CAPACITY = N_DECKS * TOTAL_CARDS; // The number of cards in the game
+
+        BasicTable();
+        void seed( uint64_t, uint64_t );
+        const Random& getGenerator() const;
+        void setGenerator( const Random& );
+        void setLazyShuffle( bool );
+        bool isLazyShuffle() const;
         void initialize();
         int getTotalCards() const;
+        int getDrawSize() const;
+        int getDiscardSize() const;
         bool canDrawCard() const;
         bool canDrawCards( int ) const;
         Card drawCard();
         void playCard( Card, int wildColor );
         Card getStock() const;
+        uint64_t getHash() const;
+        uint64_t getDrawHash() const;
+        Card getDiscardCardAt( int ) const;
+        Card getDrawCardAt( int ) const;
+        void setDrawCardAt( int, Card );
+        TableState getState() const;
+        void rewind( const TableState&, bool played, const Card drawn[], int nDrawn );
     private:
-        Deck draw;
-        Deck discard;
+        Card pool[ CAPACITY ];
+        short discardBase; // The index of the bottom card of the discard pile
+        short discardSize; // The current size of the discard pile
+        short drawSize; // The current size of the draw pile; its top card is drawSize cards before discardBase
+        uint64_t discardHash; // The sum of the Zobrist keys of every discard
+        bool lazyShuffle;
+        Random random;
+
+        static int wrapIndex( int );
+        int getDrawTop() const;
+        void shuffleDraw();
+        void unshuffleDraw( Random );
+        void hashDiscard();
 };
 
-#endif
\ No newline at end of file
+// A table with a single deck, as Game and the agents play
+typedef BasicTable< 1 > Table;
+
+#endif
@@ -0,0 +1,56 @@
+#ifndef TRANSPOSITION
+#define TRANSPOSITION
+
+#include <atomic>
+#include <stdint.h>
+#include <vector>
+using namespace std;
+
+// The move index stored with a position whose best move is not known
+const int NO_MOVE_INDEX = 0xff;
+
+// How a stored value relates to the true value of its position
+enum BoundType
+{
+    EXACT_BOUND, // The value is exact
+    LOWER_BOUND, // The true value is at least the value (the search failed high)
+    UPPER_BOUND // The true value is at most the value (the search failed low)
+};
+
+// What a transposition table remembers about one position
+struct TranspositionEntry
+{
+    short value;
+    unsigned char depth; // How deep the search that found the value went
+    unsigned char bound; // A BoundType
+    unsigned char moveIndex; // The best move's index in the position's legal moves, or NO_MOVE_INDEX
+};
+
+// A fixed-size table of search results, indexed by position hash, that any number of threads may read and write at once
+// without locks. Each slot holds an entry packed into one 64-bit word and the XOR of that word with the position's hash.
+// A reader accepts an entry only if the two XOR back to the hash it is looking for, so an entry torn by a concurrent write
+// just looks like a miss, never like a wrong answer (Hyatt's lockless hashing).
+// Each hash maps to a single slot, which is replaced unless it holds a deeper result for the same position.
+// EndgameSolver is its user. MctsAgent does not use one: each iteration deals the hidden cards afresh, so the positions its
+// threads reach almost never repeat, and what lines of play have in common is already shared through the trees.
+// uno_check hammers one table from several threads and checks that no torn entry is ever returned.
+class TranspositionTable
+{
+    public:
+        TranspositionTable( int );
+        int getSize() const;
+        void clear();
+        bool probe( uint64_t, TranspositionEntry& ) const;
+        void store( uint64_t, const TranspositionEntry& );
+    private:
+        struct Slot
+        {
+            atomic< uint64_t > check; // The packed entry XOR the hash of its position
+            atomic< uint64_t > data; // The packed entry
+        };
+
+        vector< Slot > slots;
+        uint64_t indexMask;
+};
+
+#endif
@@ -0,0 +1,86 @@
+#ifndef UNO_ENV
+#define UNO_ENV
+
+#include <stdint.h>
+
+// A plain C interface to a batch of Uno games, for reinforcement learning trainers in other languages.
+// Every game is one round of the standard rules between n_players seats; a game whose round ends is dealt a new round
+// at once, so every game always has a decision pending. All buffers are owned by the caller and filled in place,
+// one row per game, so a trainer can pass the memory of its own arrays and nothing is copied on the way back.
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// The layout of an observation, from the point of view of the player whose decision it is
+#define UNO_OBS_HAND 0 // 54 values: the number of copies of each card id in the player's hand
+#define UNO_OBS_STOCK 54 // 54 values: 1 for the id of the stock
+#define UNO_OBS_WILD_COLOR 108 // 5 values: 1 for the color named for a wild stock, or for index 4 if the stock is not wild
+#define UNO_OBS_OPPONENTS 113 // 5 values: the hand sizes of the next seats in seat order, 0 past the last seat
+#define UNO_OBS_REVERSED 118 // 1 value: 1 if the direction of play is reversed
+#define UNO_OBS_PHASE 119 // 3 values: 1 for choosing a play, deciding on a drawn card, or naming the first color
+#define UNO_OBS_DRAW_SIZE 122 // 1 value: the number of cards in the draw pile
+#define UNO_OBS_DISCARDS 123 // 54 values: the number of copies of each card id in the discard pile
+#define UNO_OBS_HISTORY 177 // 8 values: 1 + the ids of the top discards, the stock first, or 0 past the bottom
+#define UNO_OBS_SIZE 185
+
+// The actions: an action is legal in a game if its entry of the game's mask is 1
+#define UNO_ACTION_PLAY 0 // 52 actions: play the colored card with this id (or the drawn card, if it is this card)
+#define UNO_ACTION_PLAY_WILD 52 // 4 actions: play a Wild (or the drawn Wild) naming each color
+#define UNO_ACTION_PLAY_DRAW4 56 // 4 actions: play a Draw4 Wild (or the drawn Draw4 Wild) naming each color
+#define UNO_ACTION_DRAW 60 // 1 action: draw a card, or keep the card just drawn
+#define UNO_ACTION_CHOOSE_COLOR 61 // 4 actions: name each color for a Wild turned over as the first stock
+#define UNO_N_ACTIONS 65
+
+// A round is abandoned after this many turns; this only happens if every hand is stuck with the table empty
+#define UNO_MAX_TURNS_PER_ROUND 10000
+
+// The flags uno_env_step() sets for each game
+#define UNO_DONE_NONE 0 // The round goes on
+#define UNO_DONE_ROUND_OVER 1 // The round ended with a winner
+#define UNO_DONE_TRUNCATED 2 // The round was abandoned at UNO_MAX_TURNS_PER_ROUND turns, with no winner
+
+typedef struct UnoEnv UnoEnv;
+
+// Returns a new batch of n_games games between n_players seats, or NULL if either is out of range
+// (1 <= n_games, 2 <= n_players <= 6). The games must be reset before they are stepped.
+UnoEnv* uno_env_create( int n_games, int n_players );
+
+// Frees a batch returned by uno_env_create().
+void uno_env_destroy( UnoEnv* env );
+
+// Returns the number of games in the batch.
+int uno_env_game_count( const UnoEnv* env );
+
+// Returns the number of seats in every game.
+int uno_env_player_count( const UnoEnv* env );
+
+// Seeds every game from seeds[ n_games ] (game g uses stream g of seeds[ g ]) and deals each a new round.
+void uno_env_reset( UnoEnv* env, const uint64_t* seeds );
+
+// Makes actions[ g ] in every game g. Fills rewards[ n_games * n_players ] with each seat's reward, in seat order
+// within each game: when a round ends, the winner gets the points of every other hand and every other seat loses the
+// points of its own hand; otherwise every reward is 0. Sets dones[ n_games ] to UNO_DONE_ROUND_OVER for the games whose
+// round ended, to UNO_DONE_TRUNCATED for the games whose round was abandoned (every reward 0, so a trainer should
+// bootstrap rather than treat it as terminal), and to UNO_DONE_NONE for the rest; both kinds have already been dealt
+// a new round.
+// Returns 0, or -1 without changing any game if some action is not legal in its game.
+int uno_env_step( UnoEnv* env, const int32_t* actions, float* rewards, uint8_t* dones );
+
+// Fills obs[ n_games * UNO_OBS_SIZE ] with every game's observation; counts above 127 are clamped.
+void uno_env_observe( const UnoEnv* env, int8_t* obs );
+
+// Fills obs[ n_games * UNO_OBS_SIZE ] with every game's observation, as floats.
+void uno_env_observe_float( const UnoEnv* env, float* obs );
+
+// Fills masks[ n_games * UNO_N_ACTIONS ] with 1 for every legal action of every game and 0 for the rest.
+void uno_env_action_masks( const UnoEnv* env, uint8_t* masks );
+
+// Fills players[ n_games ] with the seat whose decision is pending in every game.
+void uno_env_current_players( const UnoEnv* env, int32_t* players );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,39 @@
+#ifndef WRITER
+#define WRITER
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+using namespace std;
+
+// The default size of a writer's buffer
+const size_t WRITE_BUFFER_SIZE = 1 << 16;
+
+// An append-only file writer that collects small writes in a buffer and hands them to the file in large batches,
+// so a stream of small records costs one system call per buffer rather than one per record.
+// A writer owns its file: it is flushed and closed when the writer is destroyed.
+class BufferedWriter
+{
+    public:
+        BufferedWriter( size_t = WRITE_BUFFER_SIZE );
+        ~BufferedWriter();
+        bool open( const string& );
+        bool isOpen() const;
+        bool hasFailed() const;
+        void write( const void*, size_t );
+        void flush();
+        void close();
+        uint64_t getBytesWritten() const;
+    private:
+        FILE* file;
+        vector< char > buffer;
+        size_t size; // The number of bytes waiting in the buffer
+        uint64_t bytesWritten; // The number of bytes written since the file was opened, including those still buffered
+        bool failed; // Set once a write to the file has failed
+
+        BufferedWriter( const BufferedWriter& );
+        BufferedWriter& operator=( const BufferedWriter& );
+};
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef ZOBRIST
+#define ZOBRIST
+
+#include <stdint.h>
+#include "card.hpp"
+using namespace std;
+
+// The seed of the generator that fills the key tables; any value works, but changing it changes every hash
+const uint64_t ZOBRIST_SEED = 0x5eed0f0a2b1c3d4eULL;
+
+// Returns the next output of a SplitMix64 generator with the given state, advancing the state.
+// It is constexpr so the key tables are built at compile time.
+constexpr uint64_t
+splitMix64( uint64_t& state )
+{
+    state += 0x9e3779b97f4a7c15ULL;
+    uint64_t z = state;
+    z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+    z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111ebULL;
+    return z ^ ( z >> 31 );
+}
+
+// Returns a well-mixed 64-bit key for the given small value, as SplitMix64 would output seeded with it.
+// Used for fields with too many combinations to give each its own key.
+constexpr uint64_t
+mixKey( uint64_t value )
+{
+    uint64_t state = value ^ ZOBRIST_SEED;
+    return splitMix64( state );
+}
+
+// Random keys for Zobrist hashing: the hash of a position is the XOR of the keys of everything in it, so adding or
+// removing a card updates it with a single XOR.
+// A hand is a multiset, so it holds the key for each copy of a card it has: handCards[ id ][ k ] for the ( k + 1 )th copy.
+// The discard pile is hashed by adding (not XORing) the keys of its cards, which hashes a multiset without counting
+// copies, and the stock gets a key of its own since it is the one discard the rules read.
+struct ZobristKeys
+{
+    uint64_t handCards[ N_CARD_IDS ][ MAX_CARD_COPIES ];
+    uint64_t discardCards[ N_CARD_IDS ];
+    uint64_t stocks[ N_CARD_IDS ];
+};
+
+// Fills the key tables from a SplitMix64 generator.
+constexpr ZobristKeys
+buildZobristKeys()
+{
+    ZobristKeys keys = {};
+    uint64_t state = ZOBRIST_SEED;
+
+    for ( int id = 0; id < N_CARD_IDS; id++ )
+    {
+        for ( int copy = 0; copy < MAX_CARD_COPIES; copy++ )
+        {
+            keys.handCards[ id ][ copy ] = splitMix64( state );
+        }
+        keys.discardCards[ id ] = splitMix64( state );
+        keys.stocks[ id ] = splitMix64( state );
+    }
+
+    return keys;
+}
+
+constexpr ZobristKeys ZOBRIST_KEYS = buildZobristKeys();
+
+#endif
@@ -0,0 +1,526 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "corpus.hpp"
+#include "move.hpp"
+#include "pool.hpp"
+#include "state.hpp"
+using namespace std;
+
+// Each task of a scan covers this many consecutive games, so a task is long enough to outweigh scheduling it
+// and short enough that uneven games still spread evenly across the workers
+const int GAMES_PER_TASK = 4096;
+
+// The points histogram groups round scores into buckets of this many points
+const int POINTS_PER_BUCKET = 25;
+const int N_POINT_BUCKETS = 65536 / POINTS_PER_BUCKET + 1;
+
+// The number of values a one-byte column can hold
+const int N_BYTE_VALUES = 256;
+
+// The name each filter and query uses for each MoveType, in the order of the enum
+const char* const MOVE_TYPE_NAMES[] = { "play", "draw", "playdrawn", "keep", "color", "swap", "pass" };
+const int N_MOVE_TYPES = sizeof( MOVE_TYPE_NAMES ) / sizeof( MOVE_TYPE_NAMES[ 0 ] );
+
+// What a query counts: games, rounds or moves, each row of which must pass every filter of its own level
+enum QueryKind
+{
+    GAMES_QUERY, // Game wins by seat
+    ROUNDS_QUERY, // Round wins by seat
+    POINTS_QUERY, // A histogram of the points scored per round
+    HANDS_QUERY // A histogram of the mover's hand size per move
+};
+
+// The filters of a query. Each applies to one level of the corpus, and a filter of a negative value passes every row.
+// A row passes only if its game passes the game filters, its round the round filters, and so on down; a game or round
+// passes the filters of a level below it if any of its rows there pass.
+struct QueryFilter
+{
+    // Game filters
+    int nPlayers;
+    int goalScore;
+    int winner;
+
+    // Round filters
+    int round;
+    bool filtersFirstCard;
+    bool firstCards[ N_BYTE_VALUES ]; // Indexed by card id: whether a round may start with the card
+
+    // Move filters
+    int moveType;
+    int seat;
+    bool filtersCard;
+    bool cards[ N_BYTE_VALUES ]; // Indexed by the card column: whether a move may play the card
+};
+
+// The totals of a scan, kept by each worker and summed once every worker is done
+struct QueryTotals
+{
+    int nSeats; // The most players of any game counted
+    uint64_t games;
+    uint64_t gameWins[ MAX_PLAYERS ];
+    uint64_t rounds;
+    uint64_t roundWins[ MAX_PLAYERS ];
+    uint64_t abandonedRounds;
+    uint64_t points;
+    uint64_t pointBuckets[ N_POINT_BUCKETS ];
+    uint64_t moves;
+    uint64_t handSizes[ N_BYTE_VALUES ];
+};
+
+void printUsage( const char* );
+bool parseQuery( const string&, QueryKind& );
+bool parseFilter( const string&, QueryFilter&, int& );
+bool parseCardValue( const string&, bool[] );
+void scanGames( const CorpusColumns&, QueryKind, const QueryFilter&, uint64_t, uint64_t, QueryTotals&, vector< char >& );
+void addTotals( QueryTotals&, const QueryTotals& );
+void printResults( QueryKind, const QueryTotals& );
+void printPercent( uint64_t, uint64_t );
+
+// Filters and aggregates a corpus written by uno_sim across every core
+// Usage: uno_query <corpus directory> <games|rounds|points|hands> [filter=value ...]
+int main( int argc, char* argv[] )
+{
+    // Read the arguments
+    QueryKind kind;
+    if ( argc < 3 || !parseQuery( argv[ 2 ], kind ) )
+    {
+        printUsage( argv[ 0 ] );
+        return 1;
+    }
+    QueryFilter filter = QueryFilter();
+    filter.nPlayers = -1;
+    filter.goalScore = -1;
+    filter.winner = -1;
+    filter.round = -1;
+    filter.moveType = -1;
+    filter.seat = -1;
+    int nThreads = thread::hardware_concurrency();
+    for ( int argIndex = 3; argIndex < argc; argIndex++ )
+    {
+        if ( !parseFilter( argv[ argIndex ], filter, nThreads ) )
+        {
+            cout << "Unknown filter: " << argv[ argIndex ] << endl;
+            printUsage( argv[ 0 ] );
+            return 1;
+        }
+    }
+    if ( nThreads < 1 )
+    {
+        nThreads = 1;
+    }
+
+    Corpus corpus;
+    if ( !corpus.open( argv[ 1 ] ) )
+    {
+        cout << "Cannot open a corpus in " << argv[ 1 ] << endl;
+        return 1;
+    }
+    const CorpusColumns& columns = corpus.getColumns();
+
+    // Scan the games in blocks, totalling per worker
+    vector< QueryTotals > threadTotals( nThreads, QueryTotals() );
+    vector< vector< char > > threadRounds( nThreads );
+    int nTasks = ( columns.nGames + GAMES_PER_TASK - 1 ) / GAMES_PER_TASK;
+    WorkStealingPool pool( nThreads );
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    pool.run( nTasks, [ & ]( int taskIndex, int threadIndex )
+    {
+        uint64_t firstGame = uint64_t( taskIndex ) * GAMES_PER_TASK;
+        uint64_t endGame = min( firstGame + GAMES_PER_TASK, columns.nGames );
+        scanGames( columns, kind, filter, firstGame, endGame, threadTotals[ threadIndex ], threadRounds[ threadIndex ] );
+    } );
+    QueryTotals total = QueryTotals();
+    for ( int threadIndex = 0; threadIndex < nThreads; threadIndex++ )
+    {
+        addTotals( total, threadTotals[ threadIndex ] );
+    }
+    double seconds = chrono::duration< double >( chrono::steady_clock::now() - start ).count();
+
+    // Print the results
+    cout << "Scanned " << columns.nGames << " games (" << columns.nRounds << " rounds, " << columns.nMoves << " moves) on ";
+    cout << nThreads << " threads in " << fixed << setprecision( 3 ) << seconds << " s" << endl;
+    printResults( kind, total );
+    return 0;
+}
+
+// Prints how to run the query tool.
+// 
+// PRE: none
+// POST: none
+void printUsage( const char* program )
+{
+    cout << "Usage: " << program << " <corpus directory> <games|rounds|points|hands> [filter=value ...]" << endl;
+    cout << "  games: the share of games each seat won" << endl;
+    cout << "  rounds: the share of rounds each seat won" << endl;
+    cout << "  points: a histogram of the points scored per round" << endl;
+    cout << "  hands: a histogram of how many cards the player held before each move" << endl;
+    cout << "Game filters:" << endl;
+    cout << "  players=<n>, goal=<score>, winner=<seat, from 1>" << endl;
+    cout << "Round filters:" << endl;
+    cout << "  round=<n>: the round of its game, from 0" << endl;
+    cout << "  first=<value>: the value of the card that started the discard pile (e.g. Reverse, Draw4, 7)" << endl;
+    cout << "Move filters:" << endl;
+    cout << "  move=<type>: one of play, draw, playdrawn, keep, color, swap, pass" << endl;
+    cout << "  card=<value>: the value of the card played" << endl;
+    cout << "  seat=<seat>: the seat of the player moving, from 1" << endl;
+    cout << "Rows must pass the filters of their own level and every level above it; a game or round passes" << endl;
+    cout << "the filters of a level below it if any of its rows there do. threads=<n> sets the number of threads." << endl;
+}
+
+// Reads the name of a query into kind. Returns false if it names no query.
+// 
+// PRE: none
+// POST: none
+bool parseQuery( const string& name, QueryKind& kind )
+{
+    const char* const names[] = { "games", "rounds", "points", "hands" };
+    for ( int i = 0; i < int( sizeof( names ) / sizeof( names[ 0 ] ) ); i++ )
+    {
+        if ( name == names[ i ] )
+        {
+            kind = QueryKind( i );
+            return true;
+        }
+    }
+    return false;
+}
+
+// Reads one filter=value argument into the filter, or a threads=n argument into nThreads.
+// Returns false if the argument is not a known filter with a valid value.
+// 
+// PRE: none
+// POST: none
+bool parseFilter( const string& arg, QueryFilter& filter, int& nThreads )
+{
+    size_t equals = arg.find( '=' );
+    if ( equals == string::npos )
+    {
+        return false;
+    }
+    string name = arg.substr( 0, equals );
+    string value = arg.substr( equals + 1 );
+    int number = atoi( value.c_str() );
+
+    if ( name == "players" )
+    {
+        filter.nPlayers = number;
+    }
+    else if ( name == "goal" )
+    {
+        filter.goalScore = number;
+    }
+    else if ( name == "winner" )
+    {
+        filter.winner = number - 1;
+        return filter.winner >= 0;
+    }
+    else if ( name == "round" )
+    {
+        filter.round = number;
+    }
+    else if ( name == "first" )
+    {
+        filter.filtersFirstCard = true;
+        return parseCardValue( value, filter.firstCards );
+    }
+    else if ( name == "move" )
+    {
+        for ( int type = 0; type < N_MOVE_TYPES; type++ )
+        {
+            if ( value == MOVE_TYPE_NAMES[ type ] )
+            {
+                filter.moveType = type;
+                return true;
+            }
+        }
+        return false;
+    }
+    else if ( name == "card" )
+    {
+        filter.filtersCard = true;
+        return parseCardValue( value, filter.cards );
+    }
+    else if ( name == "seat" )
+    {
+        filter.seat = number - 1;
+        return filter.seat >= 0;
+    }
+    else if ( name == "threads" )
+    {
+        nThreads = number;
+    }
+    else
+    {
+        return false;
+    }
+    return number >= 0 && !value.empty();
+}
+
+// Marks every card id of the given value (its name, as in VALUE_NAMES, or its character, as in VALUE_CHARS,
+// in either case; "Draw4" also names the Draw4 Wild) in the given table of card ids, which may already have others marked.
+// Returns false if the value names no card.
+// 
+// PRE: ids has N_BYTE_VALUES entries
+// POST: ids[ CORPUS_NO_CARD ] is unchanged
+bool parseCardValue( const string& name, bool ids[] )
+{
+    // Find the value
+    int value = -1;
+    for ( int i = 0; i < N_VALUES; i++ )
+    {
+        bool matchesChar = name.size() == 1 && toupper( name[ 0 ] ) == toupper( VALUE_CHARS[ i ] );
+        if ( matchesChar || strcasecmp( name.c_str(), VALUE_NAMES[ i ] ) == 0 )
+        {
+            value = i;
+        }
+    }
+    if ( strcasecmp( name.c_str(), "Draw4" ) == 0 )
+    {
+        value = DRAW4_WILD_INDEX;
+    }
+    if ( value < 0 )
+    {
+        return false;
+    }
+
+    // Mark every card of the value
+    for ( int id = 0; id < N_CARD_IDS; id++ )
+    {
+        if ( Card::fromId( id ).getValue() == value )
+        {
+            ids[ id ] = true;
+        }
+    }
+    return true;
+}
+
+// Adds the rows of the given games that pass the filter to the totals. Each level is filtered before the one below it
+// is touched: the game columns decide whether a game's rounds are read at all, and its rounds whether its moves are,
+// so a query reads the columns of a level only for the games that can still match there, and only the columns it needs.
+// rounds is scratch space, reused from one call to the next.
+// 
+// PRE: firstGame <= endGame <= columns.nGames
+// POST: none
+void scanGames( const CorpusColumns& columns, QueryKind kind, const QueryFilter& filter,
+                uint64_t firstGame, uint64_t endGame, QueryTotals& totals, vector< char >& rounds )
+{
+    // Assert the preconditions
+    assert( firstGame <= endGame && endGame <= columns.nGames );
+
+    // Define convenience variables
+    bool filtersRounds = filter.round >= 0 || filter.filtersFirstCard;
+    bool filtersMoves = filter.moveType >= 0 || filter.seat >= 0 || filter.filtersCard;
+    bool readsRounds = filtersRounds || kind == ROUNDS_QUERY || kind == POINTS_QUERY;
+    bool readsMoves = filtersMoves || kind == HANDS_QUERY;
+
+    // The passes of each round of the current game: 0 if it failed the round filters, 1 if it passed them,
+    // and 2 if one of its moves also passed the move filters
+    const char ROUND_FAILED = 0;
+    const char ROUND_PASSED = 1;
+    const char ROUND_HAS_MOVE = 2;
+
+    for ( uint64_t game = firstGame; game < endGame; game++ )
+    {
+        // Apply the game filters
+        if ( ( filter.nPlayers >= 0 && columns.playerCounts[ game ] != filter.nPlayers )
+             || ( filter.goalScore >= 0 && int( columns.goalScores[ game ] ) != filter.goalScore )
+             || ( filter.winner >= 0 && columns.winners[ game ] != filter.winner ) )
+        {
+            continue;
+        }
+
+        // Apply the round filters
+        uint64_t firstRound = columns.roundOffsets[ game ];
+        int nRounds = columns.roundOffsets[ game + 1 ] - firstRound;
+        bool anyRoundPassed = !filtersRounds;
+        if ( readsRounds )
+        {
+            rounds.assign( nRounds, ROUND_PASSED );
+            for ( int round = 0; round < nRounds && filtersRounds; round++ )
+            {
+                if ( ( filter.round >= 0 && round != filter.round )
+                     || ( filter.filtersFirstCard && !filter.firstCards[ columns.roundFirstCards[ firstRound + round ] ] ) )
+                {
+                    rounds[ round ] = ROUND_FAILED;
+                }
+                anyRoundPassed |= rounds[ round ] != ROUND_FAILED;
+            }
+            if ( !anyRoundPassed )
+            {
+                continue;
+            }
+        }
+
+        // Apply the move filters, counting the moves that pass them if that is the query
+        bool anyMovePassed = !filtersMoves;
+        if ( readsMoves )
+        {
+            for ( uint64_t move = columns.moveOffsets[ game ]; move < columns.moveOffsets[ game + 1 ]; move++ )
+            {
+                if ( ( filtersRounds && rounds[ columns.moveRounds[ move ] ] == ROUND_FAILED )
+                     || ( filter.moveType >= 0 && columns.moveTypes[ move ] != filter.moveType )
+                     || ( filter.seat >= 0 && columns.movePlayers[ move ] != filter.seat )
+                     || ( filter.filtersCard && !filter.cards[ columns.moveCards[ move ] ] ) )
+                {
+                    continue;
+                }
+                anyMovePassed = true;
+                if ( kind == HANDS_QUERY )
+                {
+                    totals.moves++;
+                    totals.handSizes[ columns.moveHandSizes[ move ] ]++;
+                }
+                else if ( kind == GAMES_QUERY )
+                {
+                    // One move is all it takes for the game to pass
+                    break;
+                }
+                else
+                {
+                    rounds[ columns.moveRounds[ move ] ] = ROUND_HAS_MOVE;
+                }
+            }
+            if ( !anyMovePassed )
+            {
+                continue;
+            }
+        }
+
+        // Count the game, or each of its rounds that passed
+        totals.nSeats = max( totals.nSeats, int( columns.playerCounts[ game ] ) );
+        if ( kind == GAMES_QUERY )
+        {
+            totals.games++;
+            totals.gameWins[ columns.winners[ game ] ]++;
+        }
+        else if ( kind == ROUNDS_QUERY || kind == POINTS_QUERY )
+        {
+            char passed = filtersMoves ? ROUND_HAS_MOVE : ROUND_PASSED;
+            for ( int round = 0; round < nRounds; round++ )
+            {
+                if ( rounds[ round ] != passed )
+                {
+                    continue;
+                }
+                int winner = columns.roundWinners[ firstRound + round ];
+                int points = columns.roundPoints[ firstRound + round ];
+                totals.rounds++;
+                if ( winner == CORPUS_NO_PLAYER )
+                {
+                    totals.abandonedRounds++;
+                    continue;
+                }
+                totals.roundWins[ winner ]++;
+                totals.points += points;
+                totals.pointBuckets[ points / POINTS_PER_BUCKET ]++;
+            }
+        }
+    }
+}
+
+// Adds the second totals to the first.
+// 
+// PRE: none
+// POST: none
+void addTotals( QueryTotals& total, const QueryTotals& other )
+{
+    total.nSeats = max( total.nSeats, other.nSeats );
+    total.games += other.games;
+    total.rounds += other.rounds;
+    total.abandonedRounds += other.abandonedRounds;
+    total.points += other.points;
+    total.moves += other.moves;
+    for ( int playerIndex = 0; playerIndex < MAX_PLAYERS; playerIndex++ )
+    {
+        total.gameWins[ playerIndex ] += other.gameWins[ playerIndex ];
+        total.roundWins[ playerIndex ] += other.roundWins[ playerIndex ];
+    }
+    for ( int bucket = 0; bucket < N_POINT_BUCKETS; bucket++ )
+    {
+        total.pointBuckets[ bucket ] += other.pointBuckets[ bucket ];
+    }
+    for ( int size = 0; size < N_BYTE_VALUES; size++ )
+    {
+        total.handSizes[ size ] += other.handSizes[ size ];
+    }
+}
+
+// Prints the result of the given query from its totals.
+// 
+// PRE: none
+// POST: none
+void printResults( QueryKind kind, const QueryTotals& total )
+{
+    if ( kind == GAMES_QUERY )
+    {
+        cout << "Games matched: " << total.games << endl;
+        cout << "Win rate by seat:" << endl;
+        for ( int playerIndex = 0; playerIndex < total.nSeats; playerIndex++ )
+        {
+            cout << "  Seat " << playerIndex + 1 << ": ";
+            printPercent( total.gameWins[ playerIndex ], total.games );
+        }
+    }
+    else if ( kind == ROUNDS_QUERY )
+    {
+        uint64_t scoredRounds = total.rounds - total.abandonedRounds;
+        cout << "Rounds matched: " << total.rounds << " (" << total.abandonedRounds << " abandoned)" << endl;
+        cout << "Average points per round: " << setprecision( 2 ) << ( scoredRounds > 0 ? double( total.points ) / scoredRounds : 0.0 ) << endl;
+        cout << "Win rate by seat:" << endl;
+        for ( int playerIndex = 0; playerIndex < total.nSeats; playerIndex++ )
+        {
+            cout << "  Seat " << playerIndex + 1 << ": ";
+            printPercent( total.roundWins[ playerIndex ], scoredRounds );
+        }
+    }
+    else if ( kind == POINTS_QUERY )
+    {
+        uint64_t scoredRounds = total.rounds - total.abandonedRounds;
+        cout << "Rounds matched: " << scoredRounds << " scored, " << total.abandonedRounds << " abandoned" << endl;
+        cout << "Points per round:" << endl;
+        for ( int bucket = 0; bucket < N_POINT_BUCKETS; bucket++ )
+        {
+            if ( total.pointBuckets[ bucket ] > 0 )
+            {
+                cout << "  " << setw( 5 ) << bucket * POINTS_PER_BUCKET << "-" << setw( 5 ) << left
+                     << ( bucket + 1 ) * POINTS_PER_BUCKET - 1 << right << " ";
+                printPercent( total.pointBuckets[ bucket ], scoredRounds );
+            }
+        }
+    }
+    else
+    {
+        uint64_t cards = 0;
+        for ( int size = 0; size < N_BYTE_VALUES; size++ )
+        {
+            cards += uint64_t( size ) * total.handSizes[ size ];
+        }
+        cout << "Moves matched: " << total.moves << endl;
+        cout << "Average hand size: " << setprecision( 2 ) << ( total.moves > 0 ? double( cards ) / total.moves : 0.0 ) << endl;
+        cout << "Hand size before the move:" << endl;
+        for ( int size = 0; size < N_BYTE_VALUES; size++ )
+        {
+            if ( total.handSizes[ size ] > 0 )
+            {
+                cout << "  " << setw( 3 ) << size << " cards: ";
+                printPercent( total.handSizes[ size ], total.moves );
+            }
+        }
+    }
+}
+
+// Prints a count and the share of the whole it makes up, followed by a newline.
+// 
+// PRE: none
+// POST: none
+void printPercent( uint64_t count, uint64_t whole )
+{
+    cout << setw( 10 ) << count << "  " << fixed << setprecision( 2 ) << setw( 6 ) << ( whole > 0 ? 100.0 * count / whole : 0.0 ) << "%" << endl;
+}
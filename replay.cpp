@@ -0,0 +1,373 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include "bot.hpp"
+#include "game.hpp"
+#include "replay.hpp"
+#include "solver.hpp"
+using namespace std;
+
+// A recording stores a keyframe before every this many rounds by default, so seeking replays at most this many rounds
+const int DEFAULT_KEYFRAME_INTERVAL = 4;
+
+// The solver searches at most this many moves ahead by default, with a transposition table of 2 ^ this many slots
+const int DEFAULT_SOLVER_DEPTH = 16;
+const int SOLVER_LOG2_TABLE_SIZE = 20;
+
+// Above this many cards in a hand, a solve is unlikely to see the end of the round
+const int SOLVER_ENDGAME_HAND_SIZE = 4;
+
+void printUsage( const char* );
+int record( const string&, int, int, int, uint64_t, int );
+int play( const string& );
+int seek( const string&, int, int );
+int solve( const string&, int, int, int );
+GameState recordGame( const ReplayHeader&, ReplayRecorder& );
+uint64_t mixFingerprint( uint64_t, const GameState& );
+
+// Records games between computer players as seeds and decisions, replays a recorded file and checks it,
+// or jumps to one turn of one recorded game and prints or solves the position there
+// Usage: uno_replay record <file> [games] [players] [goal score] [seed] [keyframe interval]
+//        uno_replay play <file>
+//        uno_replay seek <file> <game> <turn>
+//        uno_replay solve <file> <game> <turn> [depth]
+int main( int argc, char* argv[] )
+{
+    if ( argc >= 3 && strcmp( argv[ 1 ], "record" ) == 0 )
+    {
+        // Read the arguments, falling back to the defaults for any that are missing
+        int nGames = argc > 3 ? atoi( argv[ 3 ] ) : 1000;
+        int nPlayers = argc > 4 ? atoi( argv[ 4 ] ) : 4;
+        int goalScore = argc > 5 ? atoi( argv[ 5 ] ) : 500;
+        uint64_t seed = argc > 6 ? strtoull( argv[ 6 ], NULL, 10 ) : time( 0 );
+        int keyframeInterval = argc > 7 ? atoi( argv[ 7 ] ) : DEFAULT_KEYFRAME_INTERVAL;
+        if ( nGames >= 0 && nPlayers >= 2 && nPlayers <= MAX_PLAYERS && goalScore >= 1 && keyframeInterval >= 0 )
+        {
+            return record( argv[ 2 ], nGames, nPlayers, goalScore, seed, keyframeInterval );
+        }
+    }
+    else if ( argc == 3 && strcmp( argv[ 1 ], "play" ) == 0 )
+    {
+        return play( argv[ 2 ] );
+    }
+    else if ( argc == 5 && strcmp( argv[ 1 ], "seek" ) == 0 )
+    {
+        return seek( argv[ 2 ], atoi( argv[ 3 ] ), atoi( argv[ 4 ] ) );
+    }
+    else if ( ( argc == 5 || argc == 6 ) && strcmp( argv[ 1 ], "solve" ) == 0 )
+    {
+        int depth = argc > 5 ? atoi( argv[ 5 ] ) : DEFAULT_SOLVER_DEPTH;
+        if ( depth >= 1 && depth <= MAX_SOLVER_DEPTH )
+        {
+            return solve( argv[ 2 ], atoi( argv[ 3 ] ), atoi( argv[ 4 ] ), depth );
+        }
+    }
+
+    printUsage( argv[ 0 ] );
+    return 1;
+}
+
+// Prints how to run the replayer.
+// 
+// PRE: none
+// POST: none
+void printUsage( const char* program )
+{
+    cout << "Usage: " << program << " record <file> [games] [players] [goal score] [seed] [keyframe interval]" << endl;
+    cout << "       " << program << " play <file>" << endl;
+    cout << "       " << program << " seek <file> <game> <turn>" << endl;
+    cout << "       " << program << " solve <file> <game> <turn> [depth]" << endl;
+    cout << "  record: plays games between greedy computer players and writes them to the file" << endl;
+    cout << "  play: replays every game in the file and prints a fingerprint of their final positions" << endl;
+    cout << "  seek: prints the position at the start of a turn of a game, both counted from 0" << endl;
+    cout << "  solve: solves the round from the start of a turn of a game with its real draw pile, searching at most depth"
+         << " moves ahead (1-" << MAX_SOLVER_DEPTH << ", default " << DEFAULT_SOLVER_DEPTH << ")" << endl;
+    cout << "  games: number of games to play (default 1000)" << endl;
+    cout << "  players: 2-" << MAX_PLAYERS << " (default 4)" << endl;
+    cout << "  goal score: points needed to win a game (default 500)" << endl;
+    cout << "  seed: seed shared by every game; game n uses stream n (default: the current time)" << endl;
+    cout << "  keyframe interval: rounds between keyframes, or 0 for none (default " << DEFAULT_KEYFRAME_INTERVAL << ")" << endl;
+}
+
+// Plays the given number of games between greedy computer players, writes them to a new replay file at the given path,
+// and prints the size of the recording and the fingerprint replaying it should reproduce. Returns the exit status.
+// 
+// PRE: nGames >= 0; 2 <= nPlayers <= MAX_PLAYERS; goalScore >= 1; keyframeInterval >= 0
+// POST: none
+int record( const string& path, int nGames, int nPlayers, int goalScore, uint64_t seed, int keyframeInterval )
+{
+    // The writer appends, so start from an empty file
+    BufferedWriter writer;
+    remove( path.c_str() );
+    if ( !writer.open( path ) )
+    {
+        cout << "Cannot open " << path << endl;
+        return 1;
+    }
+
+    // Play and record every game
+    uint64_t fingerprint = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    {
+        ReplayRecorder recorder( writer, keyframeInterval );
+        for ( int gameIndex = 0; gameIndex < nGames; gameIndex++ )
+        {
+            ReplayHeader header = ReplayHeader();
+            header.seed = seed;
+            header.stream = gameIndex;
+            header.nPlayers = nPlayers;
+            header.goalScore = goalScore;
+            header.maxTurnsPerRound = MAX_TURNS_PER_ROUND;
+            header.lazyShuffle = true;
+            fingerprint = mixFingerprint( fingerprint, recordGame( header, recorder ) );
+        }
+    }
+    double seconds = chrono::duration< double >( chrono::steady_clock::now() - start ).count();
+    writer.close();
+    if ( writer.hasFailed() )
+    {
+        cout << "Cannot write " << path << endl;
+        return 1;
+    }
+
+    // Print the results
+    cout << fixed << setprecision( 2 );
+    cout << nGames << " games of " << nPlayers << " players to " << goalScore << " points recorded to " << path << endl;
+    cout << "Seed: " << seed << endl;
+    cout << "Time: " << seconds << " s" << endl;
+    cout << "Bytes: " << writer.getBytesWritten() << " (" << writer.getBytesWritten() / double( max( nGames, 1 ) )
+         << " per game)" << endl;
+    cout << "Fingerprint: " << hex << fingerprint << dec << endl;
+
+    return 0;
+}
+
+// Replays every game of the replay file at the given path and prints how fast it went,
+// and a fingerprint of the games' final positions to compare with the one printed when they were recorded.
+// Returns the exit status.
+// 
+// PRE: none
+// POST: none
+int play( const string& path )
+{
+    Replayer replayer;
+    if ( !replayer.open( path ) )
+    {
+        cout << "Cannot open " << path << endl;
+        return 1;
+    }
+
+    // Replay every game
+    long nGames = 0;
+    uint64_t fingerprint = 0;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    while ( replayer.replayNext() )
+    {
+        fingerprint = mixFingerprint( fingerprint, replayer.getState() );
+        nGames++;
+    }
+    double seconds = chrono::duration< double >( chrono::steady_clock::now() - start ).count();
+
+    // Print the results
+    cout << fixed << setprecision( 2 );
+    cout << nGames << " games replayed from " << path << endl;
+    cout << "Time: " << seconds << " s" << endl;
+    cout << "Decisions: " << replayer.getDecisionCount() << endl;
+    cout << "Decisions/sec: " << replayer.getDecisionCount() / seconds << endl;
+    cout << "Fingerprint: " << hex << fingerprint << dec << endl;
+    if ( replayer.isCorrupt() )
+    {
+        cout << "The file is cut off or corrupt after the last game replayed" << endl;
+        return 1;
+    }
+
+    return 0;
+}
+
+// Jumps to the start of the given turn of the given game of the replay file at the given path,
+// and prints the position there and how long it took to reach. Returns the exit status.
+// 
+// PRE: none
+// POST: none
+int seek( const string& path, int gameIndex, int turn )
+{
+    Replayer replayer;
+    if ( !replayer.open( path ) )
+    {
+        cout << "Cannot open " << path << endl;
+        return 1;
+    }
+    if ( !replayer.isIndexed() )
+    {
+        cout << "The file has a session with no index, so it cannot be searched" << endl;
+        return 1;
+    }
+
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    bool found = replayer.seek( gameIndex, turn );
+    double seconds = chrono::duration< double >( chrono::steady_clock::now() - start ).count();
+    if ( !found )
+    {
+        cout << "The file has no turn " << turn << " of game " << gameIndex << " (it has " << replayer.getGameCount()
+             << " games)" << endl;
+        return 1;
+    }
+
+    // Print the position
+    const GameState& state = replayer.getState();
+    cout << fixed << setprecision( 2 );
+    cout << "Game " << gameIndex << " (stream " << replayer.getHeader().stream << "), turn " << turn << endl;
+    cout << "Time: " << seconds * 1e6 << " us (" << replayer.getDecisionCount() << " decisions replayed)" << endl;
+    if ( state.gameIsOver() )
+    {
+        cout << "The game is over" << endl;
+    }
+    else
+    {
+        cout << "Turn of the round: " << state.getTurnNumber() << endl;
+        cout << "Stock: " << state.getStock().toStringLong() << endl;
+        cout << "Current player: Player " << state.getCurrentPlayerIndex() + 1 << endl;
+    }
+    for ( int playerIndex = 0; playerIndex < state.getPlayerCount(); playerIndex++ )
+    {
+        const Player& player = state.getPlayer( playerIndex );
+        cout << "  Player " << playerIndex + 1 << ": " << player.getHand().getSize() << " cards, " << player.getScore()
+             << " points" << endl;
+    }
+
+    return 0;
+}
+
+// Jumps to the start of the given turn of the given game of the replay file at the given path, solves the round from
+// there with the draw pile as it really was, searching at most the given number of moves ahead, and prints what the
+// current player could have achieved and how. Returns the exit status.
+// 
+// PRE: 1 <= depth <= MAX_SOLVER_DEPTH
+// POST: none
+int solve( const string& path, int gameIndex, int turn, int depth )
+{
+    Replayer replayer;
+    if ( !replayer.open( path ) )
+    {
+        cout << "Cannot open " << path << endl;
+        return 1;
+    }
+    if ( !replayer.isIndexed() )
+    {
+        cout << "The file has a session with no index, so it cannot be searched" << endl;
+        return 1;
+    }
+    if ( !replayer.seek( gameIndex, turn ) )
+    {
+        cout << "The file has no turn " << turn << " of game " << gameIndex << " (it has " << replayer.getGameCount()
+             << " games)" << endl;
+        return 1;
+    }
+    const GameState& state = replayer.getState();
+    if ( state.gameIsOver() || state.roundIsOver() )
+    {
+        cout << "The game is over, so there is nothing to solve" << endl;
+        return 1;
+    }
+
+    // Solve the round
+    EndgameSolver solver( SOLVER_LOG2_TABLE_SIZE, depth );
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    SolverResult result = solver.solve( state );
+    double seconds = chrono::duration< double >( chrono::steady_clock::now() - start ).count();
+
+    // Print the result
+    int playerIndex = state.getCurrentPlayerIndex();
+    cout << fixed << setprecision( 2 );
+    cout << "Game " << gameIndex << " (stream " << replayer.getHeader().stream << "), turn " << turn << endl;
+    cout << "Hand sizes:";
+    for ( int i = 0; i < state.getPlayerCount(); i++ )
+    {
+        cout << " " << state.getPlayer( i ).getHand().getSize();
+    }
+    cout << endl;
+    cout << "Time: " << seconds * 1e3 << " ms (" << result.nodes << " positions, depth " << result.depth << ")" << endl;
+    if ( result.outcome == 0 )
+    {
+        cout << "Player " << playerIndex + 1 << " can neither force a win nor be forced to lose within " << result.depth
+             << " moves" << endl;
+    }
+    else
+    {
+        cout << "Player " << playerIndex + 1 << ( result.outcome > 0 ? " can force a win" : " cannot avoid a loss" )
+             << ", worth " << ( result.exact ? "exactly " : "at least " ) << result.scoreSwing << " points" << endl;
+    }
+    cout << "Best move: " << result.bestMove.toString() << endl;
+    if ( !EndgameSolver::isEndgame( state, SOLVER_ENDGAME_HAND_SIZE ) )
+    {
+        cout << "(A hand holds more than " << SOLVER_ENDGAME_HAND_SIZE << " cards, so lines are likely cut off at the depth)"
+             << endl;
+    }
+
+    return 0;
+}
+
+// Plays one complete game between greedy computer players, records it, and returns its final position.
+// 
+// PRE: header describes a game the simulator could play
+// POST: none
+GameState recordGame( const ReplayHeader& header, ReplayRecorder& recorder )
+{
+    // The greedy agent has no state, so every seat can share it and its recording agent
+    GreedyAgent greedy;
+    RecordingAgent agent( greedy, recorder );
+    string names[ MAX_PLAYERS ];
+    PlayerAgent* agents[ MAX_PLAYERS ];
+    for ( int i = 0; i < header.nPlayers; i++ )
+    {
+        names[ i ] = "Player " + to_string( i + 1 );
+        agents[ i ] = &agent;
+    }
+
+    // Game loop (each iteration is a round)
+    recorder.beginGame( header );
+    Game game( names, agents, header.nPlayers, header.goalScore );
+    game.seed( header.seed, header.stream );
+    game.setLazyShuffle( header.lazyShuffle );
+    while ( !game.gameIsOver() )
+    {
+        recorder.beginRound( game.getState() );
+        game.initializeRound();
+
+        // Round loop (each iteration is a turn)
+        int turns = 0;
+        while ( !game.roundIsOver() && turns < header.maxTurnsPerRound )
+        {
+            recorder.beginTurn();
+            game.processPlayerTurn();
+            turns++;
+        }
+
+        if ( game.roundIsOver() )
+        {
+            game.scoreRound();
+        }
+    }
+
+    return game.getState();
+}
+
+// Folds the final position of one more game, with its scores, into a fingerprint of a sequence of games.
+// 
+// PRE: none
+// POST: none
+uint64_t mixFingerprint( uint64_t fingerprint, const GameState& state )
+{
+    fingerprint = ( fingerprint ^ state.getHash() ) * 0x9e3779b97f4a7c15ULL;
+    for ( int playerIndex = 0; playerIndex < state.getPlayerCount(); playerIndex++ )
+    {
+        fingerprint = ( fingerprint ^ state.getPlayer( playerIndex ).getScore() ) * 0x9e3779b97f4a7c15ULL;
+    }
+
+    return fingerprint;
+}
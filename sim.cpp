@@ -0,0 +1,451 @@
+#include <chrono>
+#include <cstdlib>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "belief.hpp"
+#include "bot.hpp"
+#include "corpus.hpp"
+#include "game.hpp"
+#include "mcts.hpp"
+#include "pool.hpp"
+using namespace std;
+
+// The rule sets a run can play, named on the command line by RULES_STRINGS.
+// Only the standard rules are played through Game, with agents; the others play straight on their own game states.
+enum SimRules
+{
+    STANDARD_SIM_RULES, // GameState
+    OFFICIAL_SIM_RULES, // OfficialGameState
+    HOUSE_SIM_RULES, // HouseGameState
+    TOURNAMENT_SIM_RULES, // TournamentGameState
+    N_SIM_RULES
+};
+const string RULES_STRINGS[ N_SIM_RULES ] = { "standard", "official", "house", "tournament" };
+
+// Statistics gathered by one worker thread, aligned to a cache line so workers never share one
+struct alignas( 64 ) SimStats
+{
+    long games;
+    long rounds;
+    long turns;
+    long abandonedRounds;
+    long wins[ TournamentLimits::MAX_SEATS ];
+};
+
+// How every game of a run is played
+struct SimOptions
+{
+    int nPlayers;
+    int goalScore;
+    uint64_t seed;
+    int rules; // One of SimRules
+    bool mctsSeats[ MAX_PLAYERS ]; // Whether each seat is played by the search agent rather than the greedy one
+    int mctsMillisPerMove;
+    int mctsIterationsPerMove; // If positive, searches run this many iterations instead of using their time
+};
+
+void printUsage( const char* );
+bool readSeats( const string&, bool[] );
+int readRules( const string& );
+int playGame( const SimOptions&, int, SimStats&, CorpusGame* );
+template < class State >
+int playRulesGame( const SimOptions&, int, SimStats& );
+
+// Plays many complete games between computer players across every core and prints aggregate statistics,
+// optionally writing every move of every game to a corpus
+// Usage: uno_sim [options] [games] [players] [threads] [goal score] [seed] [corpus directory]
+int main( int argc, char* argv[] )
+{
+    // Read the options, which may come anywhere, and leave the other arguments in order
+    SimOptions options = SimOptions();
+    options.mctsMillisPerMove = DEFAULT_MCTS_MILLIS_PER_MOVE;
+    vector< string > args;
+    bool valid = true;
+    for ( int i = 1; i < argc; i++ )
+    {
+        string arg = argv[ i ];
+        if ( arg == "--mcts" && i + 1 < argc )
+        {
+            valid &= readSeats( argv[ ++i ], options.mctsSeats );
+        }
+        else if ( arg == "--mcts-iterations" && i + 1 < argc )
+        {
+            options.mctsIterationsPerMove = atoi( argv[ ++i ] );
+            valid &= options.mctsIterationsPerMove >= 1;
+        }
+        else if ( arg == "--rules" && i + 1 < argc )
+        {
+            options.rules = readRules( argv[ ++i ] );
+            valid &= options.rules != -1;
+        }
+        else if ( arg.compare( 0, 2, "--" ) == 0 )
+        {
+            valid = false;
+        }
+        else
+        {
+            args.push_back( arg );
+        }
+    }
+
+    // Read the arguments, falling back to the defaults for any that are missing
+    int nGames = args.size() > 0 ? atoi( args[ 0 ].c_str() ) : 10000;
+    options.nPlayers = args.size() > 1 ? atoi( args[ 1 ].c_str() ) : 4;
+    int nThreads = args.size() > 2 ? atoi( args[ 2 ].c_str() ) : thread::hardware_concurrency();
+    options.goalScore = args.size() > 3 ? atoi( args[ 3 ].c_str() ) : 500;
+    options.seed = args.size() > 4 ? strtoull( args[ 4 ].c_str(), NULL, 10 ) : time( 0 );
+    string corpusPath = args.size() > 5 ? args[ 5 ] : "";
+    int nPlayers = options.nPlayers;
+    int goalScore = options.goalScore;
+    uint64_t seed = options.seed;
+    if ( nThreads < 1 )
+    {
+        nThreads = 1;
+    }
+    for ( int playerIndex = max( nPlayers, 0 ); playerIndex < MAX_PLAYERS; playerIndex++ )
+    {
+        valid &= !options.mctsSeats[ playerIndex ];
+    }
+
+    // The agents and the corpus only follow a GameState, so they only play the standard rules
+    bool standard = options.rules == STANDARD_SIM_RULES;
+    int maxPlayers = options.rules == TOURNAMENT_SIM_RULES ? TournamentLimits::MAX_SEATS : MAX_PLAYERS;
+    for ( int playerIndex = 0; playerIndex < MAX_PLAYERS && !standard; playerIndex++ )
+    {
+        valid &= !options.mctsSeats[ playerIndex ];
+    }
+    valid &= standard || corpusPath.empty();
+    if ( !valid || args.size() > 6 || nGames < 0 || nPlayers < 2 || nPlayers > maxPlayers || goalScore < 1 )
+    {
+        printUsage( argv[ 0 ] );
+        return 1;
+    }
+
+    // Each worker gathers a game's moves on its own, and appends them to the corpus once the game is over
+    CorpusWriter corpus;
+    vector< CorpusGame > threadGames( corpusPath.empty() ? 0 : nThreads );
+    if ( !corpusPath.empty() && !corpus.open( corpusPath ) )
+    {
+        cout << "Cannot create a corpus in " << corpusPath << endl;
+        return 1;
+    }
+
+    // Play every game, accumulating statistics per worker
+    vector< SimStats > threadStats( nThreads, SimStats() );
+    WorkStealingPool pool( nThreads );
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    pool.run( nGames, [ & ]( int gameIndex, int threadIndex )
+    {
+        SimStats& stats = threadStats[ threadIndex ];
+        CorpusGame* corpusGame = threadGames.empty() ? NULL : &threadGames[ threadIndex ];
+        int winnerIndex = 0;
+        switch ( options.rules )
+        {
+            case STANDARD_SIM_RULES:
+                winnerIndex = playGame( options, gameIndex, stats, corpusGame );
+                break;
+            case OFFICIAL_SIM_RULES:
+                winnerIndex = playRulesGame< OfficialGameState >( options, gameIndex, stats );
+                break;
+            case HOUSE_SIM_RULES:
+                winnerIndex = playRulesGame< HouseGameState >( options, gameIndex, stats );
+                break;
+            case TOURNAMENT_SIM_RULES:
+                winnerIndex = playRulesGame< TournamentGameState >( options, gameIndex, stats );
+                break;
+        }
+        stats.games++;
+        stats.wins[ winnerIndex ]++;
+        if ( corpusGame != NULL )
+        {
+            corpus.append( corpusGame->getRows() );
+        }
+    } );
+    if ( !corpusPath.empty() && !corpus.close() )
+    {
+        cout << "Cannot write the corpus in " << corpusPath << endl;
+        return 1;
+    }
+    double seconds = chrono::duration< double >( chrono::steady_clock::now() - start ).count();
+
+    // Merge the statistics of every worker
+    SimStats total = SimStats();
+    for ( int threadIndex = 0; threadIndex < nThreads; threadIndex++ )
+    {
+        const SimStats& stats = threadStats[ threadIndex ];
+        total.games += stats.games;
+        total.rounds += stats.rounds;
+        total.turns += stats.turns;
+        total.abandonedRounds += stats.abandonedRounds;
+        for ( int playerIndex = 0; playerIndex < nPlayers; playerIndex++ )
+        {
+            total.wins[ playerIndex ] += stats.wins[ playerIndex ];
+        }
+    }
+
+    // Print the results
+    double games = max( total.games, 1L );
+    cout << fixed << setprecision( 2 );
+    cout << total.games << " games of " << nPlayers << " players to " << goalScore << " points on " << nThreads << " threads" << endl;
+    if ( !standard )
+    {
+        cout << "Rules: " << RULES_STRINGS[ options.rules ] << endl;
+    }
+    cout << "Seed: " << seed << endl;
+    cout << "Time: " << seconds << " s" << endl;
+    cout << "Games/sec: " << total.games / seconds << endl;
+    cout << "Rounds/sec: " << total.rounds / seconds << endl;
+    cout << "Average rounds per game: " << total.rounds / games << endl;
+    cout << "Average turns per round: " << total.turns / double( max( total.rounds, 1L ) ) << endl;
+    cout << "Abandoned rounds: " << total.abandonedRounds << endl;
+    cout << "Win rates:" << endl;
+    for ( int playerIndex = 0; playerIndex < nPlayers; playerIndex++ )
+    {
+        bool mctsSeat = playerIndex < MAX_PLAYERS && options.mctsSeats[ playerIndex ];
+        cout << "  Seat " << playerIndex + 1 << ( mctsSeat ? " (ISMCTS)" : "" ) << ": "
+             << 100.0 * total.wins[ playerIndex ] / games << "%" << endl;
+    }
+    if ( !corpusPath.empty() )
+    {
+        cout << "Corpus: " << corpus.getGameCount() << " games written to " << corpusPath << endl;
+    }
+
+    return 0;
+}
+
+// Prints how to run the simulator.
+// 
+// PRE: none
+// POST: none
+void printUsage( const char* program )
+{
+    cout << "Usage: " << program << " [options] [games] [players] [threads] [goal score] [seed] [corpus directory]" << endl;
+    cout << "  games: number of games to play (default 10000)" << endl;
+    cout << "  players: 2-" << MAX_PLAYERS << ", or 2-" << TournamentLimits::MAX_SEATS << " under the tournament rules (default 4)" << endl;
+    cout << "  threads: worker threads (default: one per core)" << endl;
+    cout << "  goal score: points needed to win a game (default 500)" << endl;
+    cout << "  seed: seed shared by every game; game n uses stream n (default: the current time)" << endl;
+    cout << "  corpus directory: where to write a columnar corpus of every move of every game (default: none)" << endl;
+    cout << "Options:" << endl;
+    cout << "  --mcts <seats>: seats played by the ISMCTS agent instead of the greedy one, e.g. 1 or 1,3 (default: none)" << endl;
+    cout << "  --mcts-iterations <n>: search n iterations per move, so games are reproducible (default: "
+         << DEFAULT_MCTS_MILLIS_PER_MOVE << " ms per move)" << endl;
+    cout << "  --rules <rules>: standard, official, house or tournament (default: standard)" << endl;
+    cout << "    official: a Draw2 or Draw4 Wild also skips the player who draws" << endl;
+    cout << "    house: the official rules with stacking, 7-0, jump-in, and drawing until playable" << endl;
+    cout << "    tournament: the official rules at up to " << TournamentLimits::MAX_SEATS << " seats, dealt from "
+         << TournamentLimits::N_DECKS << " decks" << endl;
+    cout << "    Every seat plays greedily under any but the standard rules, which alone allow --mcts and a corpus" << endl;
+}
+
+// Reads a comma-separated list of seats, numbered from 1, into the given flags.
+// Returns false if any seat is not a number from 1 to MAX_PLAYERS.
+// 
+// PRE: seats has MAX_PLAYERS elements
+// POST: every seat in the list is set
+bool readSeats( const string& list, bool seats[] )
+{
+    size_t start = 0;
+    while ( start <= list.size() )
+    {
+        size_t end = list.find( ',', start );
+        if ( end == string::npos )
+        {
+            end = list.size();
+        }
+        int seat = atoi( list.substr( start, end - start ).c_str() );
+        if ( seat < 1 || seat > MAX_PLAYERS )
+        {
+            return false;
+        }
+        seats[ seat - 1 ] = true;
+        start = end + 1;
+    }
+
+    return true;
+}
+
+// Returns the SimRules named by the given string, or -1 if it names none.
+// 
+// PRE: none
+// POST: return value is -1 or a SimRules
+int readRules( const string& name )
+{
+    for ( int rules = 0; rules < N_SIM_RULES; rules++ )
+    {
+        if ( name == RULES_STRINGS[ rules ] )
+        {
+            return rules;
+        }
+    }
+
+    return -1;
+}
+
+// Plays one complete game between computer players and returns the index of the winner.
+// The game's shuffles come from its own stream of the shared seed, so it can be reproduced regardless of which thread ran it;
+// so are its searches, if they run a fixed number of iterations.
+// If corpusGame is not NULL, it gathers every move of the game.
+// 
+// PRE: 2 <= options.nPlayers <= MAX_PLAYERS; options.goalScore >= 1
+// POST: stats will include the rounds and turns played
+int playGame( const SimOptions& options, int gameIndex, SimStats& stats, CorpusGame* corpusGame )
+{
+    // The greedy agent has no state, so every seat can share it, and the recording agent that wraps it when there is a corpus
+    // One search agent on this worker's thread plays every search seat, each following the round through its own tracker
+    int nPlayers = options.nPlayers;
+    ReplayHeader header = ReplayHeader();
+    header.seed = options.seed;
+    header.stream = gameIndex;
+    header.nPlayers = nPlayers;
+    header.goalScore = options.goalScore;
+    header.maxTurnsPerRound = MAX_TURNS_PER_ROUND;
+    header.lazyShuffle = true;
+    CorpusGame noCorpusGame;
+    GreedyAgent greedy;
+    MctsAgent mcts( 1, options.mctsMillisPerMove, options.seed ^ ( uint64_t( gameIndex ) << 32 ), options.mctsIterationsPerMove );
+    RecordingAgent recorder( greedy, corpusGame != NULL ? *corpusGame : noCorpusGame );
+    RecordingAgent mctsRecorder( mcts, corpusGame != NULL ? *corpusGame : noCorpusGame );
+    vector< BeliefTracker > trackers;
+    trackers.reserve( nPlayers );
+    EventFanout events;
+    bool anyMcts = false;
+    string names[ MAX_PLAYERS ];
+    PlayerAgent* agents[ MAX_PLAYERS ];
+    for ( int i = 0; i < nPlayers; i++ )
+    {
+        names[ i ] = "Player " + to_string( i + 1 );
+        agents[ i ] = corpusGame != NULL ? static_cast< PlayerAgent* >( &recorder ) : &greedy;
+        trackers.push_back( BeliefTracker( i ) );
+        if ( options.mctsSeats[ i ] )
+        {
+            agents[ i ] = corpusGame != NULL ? static_cast< PlayerAgent* >( &mctsRecorder ) : &mcts;
+            events.add( &trackers[ i ] );
+            mcts.setBeliefTracker( i, &trackers[ i ] );
+            anyMcts = true;
+        }
+    }
+
+    // Game loop (each iteration is a round)
+    // Games between greedy players need no events, so they are not reported at all
+    Game game( names, agents, nPlayers, options.goalScore, anyMcts ? &events : NULL );
+    game.seed( header.seed, header.stream );
+    game.setLazyShuffle( header.lazyShuffle );
+    if ( corpusGame != NULL )
+    {
+        corpusGame->beginGame( header );
+    }
+    while ( !game.gameIsOver() )
+    {
+        if ( corpusGame != NULL )
+        {
+            corpusGame->beginRound();
+        }
+        game.initializeRound();
+        if ( corpusGame != NULL )
+        {
+            corpusGame->endDeal( game.getState() );
+        }
+
+        // Round loop (each iteration is a turn)
+        int turns = 0;
+        while ( !game.roundIsOver() && turns < MAX_TURNS_PER_ROUND )
+        {
+            if ( corpusGame != NULL )
+            {
+                corpusGame->beginTurn();
+            }
+            game.processPlayerTurn();
+            turns++;
+        }
+
+        stats.rounds++;
+        stats.turns += turns;
+        if ( game.roundIsOver() )
+        {
+            int winnerIndex = game.getRoundWinnerIndex();
+            int scoreBefore = game.getPlayer( winnerIndex ).getScore();
+            game.scoreRound();
+            if ( corpusGame != NULL )
+            {
+                corpusGame->endRound( winnerIndex, game.getPlayer( winnerIndex ).getScore() - scoreBefore );
+            }
+        }
+        else
+        {
+            stats.abandonedRounds++;
+        }
+    }
+
+    if ( corpusGame != NULL )
+    {
+        corpusGame->endGame( game.getState() );
+    }
+
+    // The only player who can have reached the goal is the winner of the last round
+    for ( int playerIndex = 0; playerIndex < nPlayers; playerIndex++ )
+    {
+        if ( game.getPlayer( playerIndex ).getHand().isEmpty() )
+        {
+            return playerIndex;
+        }
+    }
+
+    // Because the game is over, this should not be reached
+    return 0;
+}
+
+// Plays one complete game of the given state's rules between greedy players and returns the index of the winner.
+// Game only plays the standard rules, so the game is played straight on the state, each move chosen by chooseGreedyMove();
+// under the standard rules this plays exactly the game playGame() does.
+// 
+// PRE: 2 <= options.nPlayers <= the state's seat limit; options.goalScore >= 1
+// POST: stats will include the rounds and turns played
+template < class State >
+int playRulesGame( const SimOptions& options, int gameIndex, SimStats& stats )
+{
+    State state( options.nPlayers, options.goalScore );
+    state.seed( options.seed, gameIndex );
+    state.setLazyShuffle( true );
+
+    // Game loop (each iteration is a round)
+    MoveList moves;
+    while ( !state.gameIsOver() )
+    {
+        state.initializeRound();
+
+        // Round loop (each iteration is a move; the state counts the turns)
+        while ( !state.roundIsOver() && state.getTurnNumber() < MAX_TURNS_PER_ROUND )
+        {
+            state.legalMoves( moves );
+            state.apply( chooseGreedyMove( state, moves ) );
+        }
+
+        stats.rounds++;
+        stats.turns += state.getTurnNumber();
+        if ( state.roundIsOver() )
+        {
+            state.scoreRound();
+        }
+        else
+        {
+            stats.abandonedRounds++;
+        }
+    }
+
+    // The only player who can have reached the goal is the winner of the last round
+    for ( int playerIndex = 0; playerIndex < options.nPlayers; playerIndex++ )
+    {
+        if ( state.getPlayer( playerIndex ).getHand().isEmpty() )
+        {
+            return playerIndex;
+        }
+    }
+
+    // Because the game is over, this should not be reached
+    return 0;
+}
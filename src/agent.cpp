@@ -0,0 +1,115 @@
+#include <assert.h>
+#include "agent.hpp"
+#include "game.hpp"
+#include "player.hpp"
+using namespace std;
+
+// Destroys the agent. Agents are always used through PlayerAgent pointers, so the destructor must be virtual.
+// 
+// PRE: none
+// POST: none
+PlayerAgent::~PlayerAgent()
+{
+}
+
+// Called before the player is made to draw because they have no playable card.
+// Agents that do not need to acknowledge this (i.e. anything but a human) can ignore it.
+// 
+// PRE: the player has no card that can be played on the stock
+// POST: none
+void
+PlayerAgent::confirmForcedDraw( const Game&, const Player& )
+{
+}
+
+// Decides whether to draw rather than play a card. By default, never draws by choice.
+// 
+// PRE: the player has at least one card that can legally be played
+// POST: return value == false
+bool
+PlayerAgent::chooseDraw( const Game&, const Player& )
+{
+    return false;
+}
+
+// Picks a card to play. By default, plays the legal card with the lowest id.
+// 
+// PRE: the player has at least one card that can legally be played
+// POST: return value will be a card in the player's hand that can legally be played
+Card
+PlayerAgent::chooseCard( const Game& game, const Player& )
+{
+    // The moves list every legal card in order of id, before the draw
+    MoveList moves;
+    game.legalMoves( moves );
+    assert( moves.get( 0 ).getType() == PLAY_CARD );
+
+    return moves.get( 0 ).getCard();
+}
+
+// Decides whether to play the card just drawn. By default, always plays it.
+// 
+// PRE: the drawn card can legally be played
+// POST: return value == true
+bool
+PlayerAgent::choosePlayDrawn( const Game&, const Player&, Card )
+{
+    return true;
+}
+
+// Picks the color for a wild card. By default, names red.
+// 
+// PRE: none
+// POST: 0 <= return value < N_COLORS
+int
+PlayerAgent::chooseColor( const Game&, const Player& )
+{
+    return 0;
+}
+
+// Picks one of the given legal moves for the current player by asking the question that fits the game's phase.
+// 
+// PRE: moves is the non-empty list of legal moves for the current player of game
+// POST: return value is one of the moves in the list
+Move
+PlayerAgent::chooseMove( const Game& game, const MoveList& moves )
+{
+    // Assert the preconditions
+    assert( !moves.isEmpty() );
+
+    // Define convenience variables
+    const Player& player = game.getPlayer( game.getCurrentPlayerIndex() );
+
+    switch ( game.getPhase() )
+    {
+        // Only the color is left to decide
+        case FIRST_COLOR_PHASE:
+            return Move::chooseColor( chooseColor( game, player ) );
+        // Decide whether to play the drawn card, then name its color if needed
+        case DRAWN_CARD_PHASE:
+        {
+            Card drawnCard = game.getDrawnCard();
+            if ( !choosePlayDrawn( game, player, drawnCard ) )
+            {
+                return Move::keepDrawn();
+            }
+            return Move::playDrawn( drawnCard, drawnCard.isWild() ? chooseColor( game, player ) : NO_COLOR_INDEX );
+        }
+        // Drawing is always the last move listed, so any other move means there is a card to play
+        // Game plays the standard rules, so this is PLAY_PHASE; the house-rule phases never reach an agent
+        default:
+        {
+            if ( moves.getSize() == 1 )
+            {
+                confirmForcedDraw( game, player );
+                return Move::drawCard();
+            }
+            if ( chooseDraw( game, player ) )
+            {
+                return Move::drawCard();
+            }
+            Card card = chooseCard( game, player );
+            return Move::playCard( card, card.isWild() ? chooseColor( game, player ) : NO_COLOR_INDEX );
+        }
+    }
+}
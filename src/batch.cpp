@@ -0,0 +1,836 @@
+#include <assert.h>
+#include <string.h>
+#include "batch.hpp"
+#include "deck.hpp"
+#include "state.hpp"
+#if defined( __x86_64__ ) || defined( __i386__ )
+#include <immintrin.h>
+#endif
+using namespace std;
+
+// The id of the Draw4 Wild, which may only be played without a card of the current color
+const int DRAW4_WILD_ID = cardId( NO_COLOR_INDEX, DRAW4_WILD_INDEX );
+
+// The one-byte turn fields are handled 16 games at a time as signed bytes, so every seat index, and the
+// index of the seat two steps on before it wraps, must stay below 128
+static_assert( 3 * MAX_PLAYERS < 128, "Seat indices must fit in a signed byte" );
+
+// Returns the given pool index wrapped around to the start of a game's pool.
+// 
+// PRE: 0 <= index < 2 * TOTAL_CARDS
+// POST: 0 <= return value < TOTAL_CARDS
+static int
+wrapIndex( int index )
+{
+    return index >= TOTAL_CARDS ? index - TOTAL_CARDS : index;
+}
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+// Returns four one-byte fields, zero-extended into the four 64-bit lanes of a vector.
+// 
+// PRE: bytes has at least 4 readable bytes
+// POST: none
+__attribute__(( target( "avx2" ) )) static inline __m256i
+loadBytesAvx2( const unsigned char* bytes )
+{
+    int word;
+    memcpy( &word, bytes, sizeof( word ) );
+    return _mm256_cvtepu8_epi64( _mm_cvtsi32_si128( word ) );
+}
+
+// Fills masks[ game ] as BatchEngine::legalPlayMasks() does, four games at a time, with the hand and the two card tables
+// read by 64-bit gathers. Returns the number of games filled, the largest multiple of 4 no greater than nGames;
+// the caller fills the rest one game at a time.
+// 
+// PRE: the CPU supports AVX2; every array has nGames entries, and handMasks has one per seat and game
+// POST: 0 <= return value <= nGames
+__attribute__(( target( "avx2" ) )) static int
+legalPlayMasksAvx2( int nGames, const unsigned char* players, const unsigned char* stocks, const unsigned char* wildColors,
+                    const unsigned char* drawnCards, const unsigned char* phases, const unsigned char* winners,
+                    const CardMask* handMasks, CardMask* masks )
+{
+    // Define convenience variables
+    const long long* hands = reinterpret_cast< const long long* >( handMasks );
+    const long long* playableTable = reinterpret_cast< const long long* >( &Card::TABLES.playable[ 0 ][ 0 ] );
+    const long long* colorTable = reinterpret_cast< const long long* >( &Card::TABLES.currentColors[ 0 ][ 0 ] );
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi64x( 1 );
+    const __m256i draw4 = _mm256_set1_epi64x( CardMask( 1 ) << DRAW4_WILD_ID );
+    const __m256i gameCount = _mm256_set1_epi64x( nGames );
+    const __m256i wildColorCount = _mm256_set1_epi64x( N_COLORS + 1 );
+    const __m256i noWinner = _mm256_set1_epi64x( NO_WINNER );
+    const __m256i playPhase = _mm256_set1_epi64x( PLAY_PHASE );
+    const __m256i drawnPhase = _mm256_set1_epi64x( DRAWN_CARD_PHASE );
+    __m256i games = _mm256_setr_epi64x( 0, 1, 2, 3 );
+
+    int game = 0;
+    for ( ; game + 4 <= nGames; game += 4 )
+    {
+        // Gather each game's hand and its row of the card tables; the products fit in the low 32 bits of each lane
+        __m256i handIndex = _mm256_add_epi64( _mm256_mul_epu32( loadBytesAvx2( players + game ), gameCount ), games );
+        __m256i hand = _mm256_i64gather_epi64( hands, handIndex, 8 );
+        __m256i tableIndex = _mm256_add_epi64( _mm256_mul_epu32( loadBytesAvx2( stocks + game ), wildColorCount ),
+                                               loadBytesAvx2( wildColors + game ) );
+        __m256i playable = _mm256_and_si256( hand, _mm256_i64gather_epi64( playableTable, tableIndex, 8 ) );
+        __m256i currentColor = _mm256_and_si256( hand, _mm256_i64gather_epi64( colorTable, tableIndex, 8 ) );
+
+        // A Draw4 Wild is blocked in the lanes whose hand holds a card of the current color
+        __m256i blocked = _mm256_andnot_si256( _mm256_cmpeq_epi64( currentColor, zero ), draw4 );
+        playable = _mm256_andnot_si256( blocked, playable );
+
+        // Select the playable cards or the drawn card by phase, or nothing if the round is over
+        __m256i drawn = _mm256_sllv_epi64( one, loadBytesAvx2( drawnCards + game ) );
+        __m256i phase = loadBytesAvx2( phases + game );
+        __m256i inRound = _mm256_cmpeq_epi64( loadBytesAvx2( winners + game ), noWinner );
+        __m256i inPlay = _mm256_and_si256( _mm256_cmpeq_epi64( phase, playPhase ), inRound );
+        __m256i inDrawn = _mm256_and_si256( _mm256_cmpeq_epi64( phase, drawnPhase ), inRound );
+        __m256i result = _mm256_or_si256( _mm256_and_si256( playable, inPlay ), _mm256_and_si256( drawn, inDrawn ) );
+        _mm256_storeu_si256( reinterpret_cast< __m256i* >( masks + game ), result );
+
+        games = _mm256_add_epi64( games, _mm256_set1_epi64x( 4 ) );
+    }
+    return game;
+}
+#endif
+
+#ifdef __SSE2__
+// Ends the turn in the games whose turn ended, as BatchEngine::endTurns() does, sixteen games at a time with one byte
+// per game. Returns the number of games handled, the largest multiple of 16 no greater than nGames;
+// the caller handles the rest one game at a time.
+// 
+// PRE: 2 <= nPlayers <= MAX_PLAYERS; every array has nGames entries; ends, reversed and skipped hold only 0 or 1
+// POST: 0 <= return value <= nGames
+static int
+endTurnsSse2( int nGames, int nPlayers, const unsigned char* ends, const unsigned char* reversed, const unsigned char* winners,
+              unsigned char* players, unsigned char* phases, unsigned char* skipped, int* turnNumbers )
+{
+    // Define convenience variables
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8( 1 );
+    const __m128i seats = _mm_set1_epi8( nPlayers );
+    const __m128i lastSeat = _mm_set1_epi8( nPlayers - 1 );
+    const __m128i backwards = _mm_set1_epi8( nPlayers - 2 );
+    const __m128i noWinner = _mm_set1_epi8( char( NO_WINNER ) );
+    const __m128i playPhase = _mm_set1_epi8( PLAY_PHASE );
+
+    int game = 0;
+    for ( ; game + 16 <= nGames; game += 16 )
+    {
+        // Turn each 0-or-1 field into a mask of 0 or all ones
+        __m128i end = _mm_loadu_si128( reinterpret_cast< const __m128i* >( ends + game ) );
+        __m128i ending = _mm_sub_epi8( zero, end );
+        __m128i reversing = _mm_sub_epi8( zero, _mm_loadu_si128( reinterpret_cast< const __m128i* >( reversed + game ) ) );
+        __m128i skip = _mm_loadu_si128( reinterpret_cast< const __m128i* >( skipped + game ) );
+        __m128i skipping = _mm_sub_epi8( zero, skip );
+        __m128i player = _mm_loadu_si128( reinterpret_cast< const __m128i* >( players + game ) );
+        __m128i phase = _mm_loadu_si128( reinterpret_cast< const __m128i* >( phases + game ) );
+
+        // Step one seat (nPlayers - 1 when reversed), twice when skipping, and wrap
+        __m128i step = _mm_add_epi8( one, _mm_and_si128( backwards, reversing ) );
+        __m128i next = _mm_add_epi8( player, _mm_add_epi8( step, _mm_and_si128( step, skipping ) ) );
+        next = _mm_sub_epi8( next, _mm_and_si128( seats, _mm_cmpgt_epi8( next, lastSeat ) ) );
+        next = _mm_sub_epi8( next, _mm_and_si128( seats, _mm_cmpgt_epi8( next, lastSeat ) ) );
+        __m128i winnerless = _mm_cmpeq_epi8( _mm_loadu_si128( reinterpret_cast< const __m128i* >( winners + game ) ), noWinner );
+        __m128i advancing = _mm_and_si128( ending, winnerless );
+
+        phase = _mm_or_si128( _mm_andnot_si128( ending, phase ), _mm_and_si128( ending, playPhase ) );
+        player = _mm_or_si128( _mm_andnot_si128( advancing, player ), _mm_and_si128( advancing, next ) );
+        skip = _mm_andnot_si128( advancing, skip );
+        _mm_storeu_si128( reinterpret_cast< __m128i* >( phases + game ), phase );
+        _mm_storeu_si128( reinterpret_cast< __m128i* >( players + game ), player );
+        _mm_storeu_si128( reinterpret_cast< __m128i* >( skipped + game ), skip );
+
+        // Widen the ends to 32 bits to add them to the turn numbers, four games at a time
+        __m128i endWords[ 2 ] = { _mm_unpacklo_epi8( end, zero ), _mm_unpackhi_epi8( end, zero ) };
+        for ( int quarter = 0; quarter < 4; quarter++ )
+        {
+            __m128i words = endWords[ quarter / 2 ];
+            __m128i endInts = quarter % 2 == 0 ? _mm_unpacklo_epi16( words, zero ) : _mm_unpackhi_epi16( words, zero );
+            __m128i* turns = reinterpret_cast< __m128i* >( turnNumbers + game + 4 * quarter );
+            _mm_storeu_si128( turns, _mm_add_epi32( _mm_loadu_si128( turns ), endInts ) );
+        }
+    }
+    return game;
+}
+#endif
+
+// Initializes a batch of the given number of games between the given number of players.
+// Every game is seeded with seed 0; rounds must be initialized before play.
+// 
+// PRE: nGames >= 1; 2 <= nPlayers <= MAX_PLAYERS
+// POST: every score is 0
+BatchEngine::BatchEngine( int nGames, int nPlayers )
+    : pool( size_t( nGames ) * TOTAL_CARDS ), discardBases( nGames ), discardSizes( nGames ), drawSizes( nGames ),
+      randoms( nGames ), handCounts( size_t( nPlayers ) * N_CARD_IDS * nGames ), handMasks( nPlayers * nGames ),
+      handSizes( nPlayers * nGames ), scores( nPlayers * nGames ), stocks( nGames ), currentPlayers( nGames ),
+      wildColors( nGames ), phases( nGames ), reverses( nGames ), skips( nGames ), drawnCards( nGames ),
+      winners( nGames ), endsTurn( nGames ), turnNumbers( nGames )
+{
+    // Assert the preconditions
+    assert( nGames >= 1 );
+    assert( nPlayers >= 2 );
+    assert( nPlayers <= MAX_PLAYERS );
+
+    this->nGames = nGames;
+    this->nPlayers = nPlayers;
+    seed( 0 );
+}
+
+// Seeds every game's generator with the given seed, game g on stream g, as the simulator seeds its games.
+// 
+// PRE: none
+// POST: takes effect from the next round initialized
+void
+BatchEngine::seed( uint64_t seedValue )
+{
+    for ( int game = 0; game < nGames; game++ )
+    {
+        randoms[ game ].seed( seedValue, game );
+    }
+}
+
+// Seeds the given game's generator with the given seed on the given stream.
+// 
+// PRE: 0 <= game < nGames
+// POST: takes effect from the next round initialized in the game
+void
+BatchEngine::seed( int game, uint64_t seedValue, uint64_t stream )
+{
+    // Assert the preconditions
+    assert( game >= 0 );
+    assert( game < nGames );
+
+    randoms[ game ].seed( seedValue, stream );
+}
+
+// Deals a new round in every game.
+// 
+// PRE: none
+// POST: see initializeRound()
+void
+BatchEngine::initializeRounds()
+{
+    for ( int game = 0; game < nGames; game++ )
+    {
+        initializeRound( game );
+    }
+}
+
+// Deals a new round in the given game, as GameState::initializeRound() does: the pool is refilled with a full deck,
+// every seat is dealt a hand, and the first stock takes effect.
+// 
+// PRE: 0 <= game < nGames
+// POST: the round is not over; scores are unchanged
+void
+BatchEngine::initializeRound( int game )
+{
+    // Assert the preconditions
+    assert( game >= 0 );
+    assert( game < nGames );
+
+    // The cards of a full deck in order, built once and then copied into the pool each round
+    static const Deck fullDeck = []()
+    {
+        Deck deck;
+        deck.initialize();
+        return deck;
+    }();
+
+    // Fill the pool with a full deck, all of it in the draw pile, and turn over cards until one is not a Draw4 Wild
+    unsigned char* gamePool = &pool[ size_t( game ) * TOTAL_CARDS ];
+    for ( int i = 0; i < TOTAL_CARDS; i++ )
+    {
+        gamePool[ i ] = fullDeck.getCardAt( i ).getId();
+    }
+    discardBases[ game ] = 0;
+    discardSizes[ game ] = 0;
+    drawSizes[ game ] = TOTAL_CARDS;
+    do
+    {
+        int id = drawCard( game );
+        gamePool[ wrapIndex( discardBases[ game ] + discardSizes[ game ] ) ] = id;
+        discardSizes[ game ]++;
+        stocks[ game ] = id;
+    } while ( stocks[ game ] == DRAW4_WILD_ID );
+
+    // Reset the turn and empty every hand
+    currentPlayers[ game ] = 0;
+    wildColors[ game ] = NO_COLOR_INDEX;
+    phases[ game ] = PLAY_PHASE;
+    reverses[ game ] = false;
+    skips[ game ] = false;
+    winners[ game ] = NO_WINNER;
+    turnNumbers[ game ] = 0;
+    for ( int playerIndex = 0; playerIndex < nPlayers; playerIndex++ )
+    {
+        for ( int id = 0; id < N_CARD_IDS; id++ )
+        {
+            handCounts[ ( size_t( playerIndex ) * N_CARD_IDS + id ) * nGames + game ] = 0;
+        }
+        handMasks[ playerIndex * nGames + game ] = 0;
+        handSizes[ playerIndex * nGames + game ] = 0;
+    }
+
+    // Deal one card at a time to each player in turn
+    for ( int card = 0; card < STARTING_HAND_SIZE; card++ )
+    {
+        for ( int playerIndex = 0; playerIndex < nPlayers; playerIndex++ )
+        {
+            addCard( game, playerIndex, drawCard( game ) );
+        }
+    }
+
+    // Apply the effects of the stock to the first player
+    switch ( Card::fromId( stocks[ game ] ).getValue() )
+    {
+        case DRAW2_INDEX:
+            drawUpTo( game, 0, 2 );
+            break;
+        case REVERSE_INDEX:
+            reverses[ game ] = true;
+            break;
+        case SKIP_INDEX:
+            skips[ game ] = true;
+            break;
+        case WILD_INDEX:
+            phases[ game ] = FIRST_COLOR_PHASE;
+            break;
+    }
+}
+
+// Fills masks[ game ] with the cards the current player of each game may play: in PLAY_PHASE, the cards
+// GameState::legalMoves() lists; in DRAWN_CARD_PHASE, the drawn card; and none while the first color is being named.
+// Drawing (or keeping the drawn card) is always legal besides these. Games whose round is over get no cards.
+// 
+// PRE: masks has room for nGames masks
+// POST: none
+void
+BatchEngine::legalPlayMasks( CardMask masks[] ) const
+{
+    // Every game does the same lookups, so this is one branch-free pass of table lookups and masks:
+    // four games at a time with AVX2 gathers where the CPU has them, and the games left over one at a time
+    int game = 0;
+#if defined( __x86_64__ ) || defined( __i386__ )
+    if ( __builtin_cpu_supports( "avx2" ) )
+    {
+        game = legalPlayMasksAvx2( nGames, currentPlayers.data(), stocks.data(), wildColors.data(), drawnCards.data(),
+                                   phases.data(), winners.data(), handMasks.data(), masks );
+    }
+#endif
+    for ( ; game < nGames; game++ )
+    {
+        CardMask hand = handMasks[ currentPlayers[ game ] * nGames + game ];
+        int stock = stocks[ game ];
+        int wildColor = wildColors[ game ];
+        CardMask playable = hand & Card::TABLES.playable[ stock ][ wildColor ];
+        CardMask draw4Blocked = ( hand & Card::TABLES.currentColors[ stock ][ wildColor ] ) != 0;
+        playable &= ~( draw4Blocked << DRAW4_WILD_ID );
+
+        CardMask drawn = CardMask( 1 ) << drawnCards[ game ];
+        CardMask inRound = -CardMask( winners[ game ] == NO_WINNER );
+        CardMask inPlay = -CardMask( phases[ game ] == PLAY_PHASE ) & inRound;
+        CardMask inDrawn = -CardMask( phases[ game ] == DRAWN_CARD_PHASE ) & inRound;
+        masks[ game ] = ( playable & inPlay ) | ( drawn & inDrawn );
+    }
+}
+
+// Makes one move in every game whose round is not over, moves[ game ] being that game's move.
+// Each game changes exactly as GameState::apply() would change it under the standard rules.
+// 
+// PRE: rounds are initialized; for every game whose round is not over, moves[ game ] is one of the moves
+//      GameState::legalMoves() would list for it
+// POST: every game that was over is unchanged
+void
+BatchEngine::step( const Move moves[] )
+{
+    // Move the cards of each game's move, marking the games whose turn it ends
+    for ( int game = 0; game < nGames; game++ )
+    {
+        endsTurn[ game ] = false;
+        if ( winners[ game ] != NO_WINNER )
+        {
+            continue;
+        }
+
+        Move move = moves[ game ];
+        int playerIndex = currentPlayers[ game ];
+        switch ( move.getType() )
+        {
+            case PLAY_CARD:
+                assert( phases[ game ] == PLAY_PHASE );
+                assert( ( legalPlayMask( game ) >> move.getCard().getId() ) & 1 );
+                playCard( game, move.getCard(), move.getColor() );
+                endsTurn[ game ] = true;
+                break;
+            case DRAW_CARD:
+            {
+                assert( phases[ game ] == PLAY_PHASE );
+
+                // If the table is empty, the player won't be able to draw a card, so their turn is over
+                if ( drawSizes[ game ] + discardSizes[ game ] <= 1 )
+                {
+                    endsTurn[ game ] = true;
+                    break;
+                }
+
+                // If the player can play the card they draw, they get to decide whether to
+                int id = drawCard( game );
+                addCard( game, playerIndex, id );
+                drawnCards[ game ] = id;
+                if ( ( legalPlayMask( game ) >> id ) & 1 )
+                {
+                    phases[ game ] = DRAWN_CARD_PHASE;
+                }
+                else
+                {
+                    endsTurn[ game ] = true;
+                }
+                break;
+            }
+            case PLAY_DRAWN:
+                assert( phases[ game ] == DRAWN_CARD_PHASE );
+                assert( move.getCard().getId() == drawnCards[ game ] );
+                playCard( game, move.getCard(), move.getColor() );
+                endsTurn[ game ] = true;
+                break;
+            case KEEP_DRAWN:
+                assert( phases[ game ] == DRAWN_CARD_PHASE );
+                endsTurn[ game ] = true;
+                break;
+            case CHOOSE_COLOR:
+                assert( phases[ game ] == FIRST_COLOR_PHASE );
+                assert( move.getColor() < N_COLORS );
+
+                // Naming the color does not use up the first player's turn
+                wildColors[ game ] = move.getColor();
+                phases[ game ] = PLAY_PHASE;
+                break;
+            default:
+                // The other moves belong to house rules, which the batch does not play
+                assert( false );
+        }
+    }
+
+    endTurns();
+}
+
+// Adds the score of every other hand to the winner's score in each game whose round is over.
+// 
+// PRE: none
+// POST: games whose round is not over are unchanged
+void
+BatchEngine::scoreRounds()
+{
+    // Sum every hand of every game at once, one card id at a time, so each inner loop runs down contiguous counts
+    // The winner's hand is empty, so it adds nothing
+    vector< int > roundScores( nGames, 0 );
+    for ( int playerIndex = 0; playerIndex < nPlayers; playerIndex++ )
+    {
+        for ( int id = 0; id < N_CARD_IDS; id++ )
+        {
+            const unsigned char* counts = &handCounts[ ( size_t( playerIndex ) * N_CARD_IDS + id ) * nGames ];
+            int cardScore = Card::TABLES.scores[ id ];
+            for ( int game = 0; game < nGames; game++ )
+            {
+                roundScores[ game ] += counts[ game ] * cardScore;
+            }
+        }
+    }
+
+    for ( int game = 0; game < nGames; game++ )
+    {
+        if ( winners[ game ] != NO_WINNER )
+        {
+            scores[ winners[ game ] * nGames + game ] += roundScores[ game ];
+        }
+    }
+}
+
+// Returns the number of games in the batch.
+// 
+// PRE: none
+// POST: return value >= 1
+int
+BatchEngine::getGameCount() const
+{
+    return nGames;
+}
+
+// Returns the number of players in every game.
+// 
+// PRE: none
+// POST: 2 <= return value <= MAX_PLAYERS
+int
+BatchEngine::getPlayerCount() const
+{
+    return nPlayers;
+}
+
+// Returns true if the given game's round is over, i.e. one player has no cards in their hand.
+// 
+// PRE: 0 <= game < nGames
+// POST: none
+bool
+BatchEngine::roundIsOver( int game ) const
+{
+    return winners[ game ] != NO_WINNER;
+}
+
+// Returns the index of the winner of the given game's round.
+// 
+// PRE: 0 <= game < nGames; the game's round must be over
+// POST: 0 <= return value < nPlayers
+int
+BatchEngine::getRoundWinnerIndex( int game ) const
+{
+    // Assert the preconditions
+    assert( roundIsOver( game ) );
+
+    return winners[ game ];
+}
+
+// Returns the index of the player whose turn it is in the given game.
+// 
+// PRE: 0 <= game < nGames
+// POST: 0 <= return value < nPlayers
+int
+BatchEngine::getCurrentPlayerIndex( int game ) const
+{
+    return currentPlayers[ game ];
+}
+
+// Returns the kind of decision the current player of the given game must make next.
+// 
+// PRE: 0 <= game < nGames
+// POST: return value is PLAY_PHASE, DRAWN_CARD_PHASE, or FIRST_COLOR_PHASE
+int
+BatchEngine::getPhase( int game ) const
+{
+    return phases[ game ];
+}
+
+// Returns the number of turns completed in the given game's round.
+// 
+// PRE: 0 <= game < nGames
+// POST: return value >= 0
+int
+BatchEngine::getTurnNumber( int game ) const
+{
+    return turnNumbers[ game ];
+}
+
+// Returns the top card of the given game's discard pile.
+// 
+// PRE: 0 <= game < nGames
+// POST: none
+Card
+BatchEngine::getStock( int game ) const
+{
+    return Card::fromId( stocks[ game ] );
+}
+
+// Returns the color chosen for the most recent wild card in the given game, or NO_COLOR_INDEX if none has been chosen.
+// 
+// PRE: 0 <= game < nGames
+// POST: 0 <= return value < N_COLORS, or return value == NO_COLOR_INDEX
+int
+BatchEngine::getWildColor( int game ) const
+{
+    return wildColors[ game ];
+}
+
+// Returns true if the direction of play is reversed in the given game.
+// 
+// PRE: 0 <= game < nGames
+// POST: none
+bool
+BatchEngine::isReversed( int game ) const
+{
+    return reverses[ game ];
+}
+
+// Returns the card the current player of the given game just drew.
+// 
+// PRE: 0 <= game < nGames; getPhase( game ) == DRAWN_CARD_PHASE
+// POST: none
+Card
+BatchEngine::getDrawnCard( int game ) const
+{
+    // Assert the preconditions
+    assert( phases[ game ] == DRAWN_CARD_PHASE );
+
+    return Card::fromId( drawnCards[ game ] );
+}
+
+// Returns the number of cards in the given game's draw pile.
+// 
+// PRE: 0 <= game < nGames
+// POST: none
+int
+BatchEngine::getDrawSize( int game ) const
+{
+    return drawSizes[ game ];
+}
+
+// Returns the number of cards in the given game's discard pile, including the stock.
+// 
+// PRE: 0 <= game < nGames
+// POST: none
+int
+BatchEngine::getDiscardSize( int game ) const
+{
+    return discardSizes[ game ];
+}
+
+// Returns the card at the given depth of the given game's discard pile, where depth 0 is the stock.
+// 
+// PRE: 0 <= game < nGames; 0 <= depth < getDiscardSize( game )
+// POST: none
+Card
+BatchEngine::getDiscardCardAt( int game, int depth ) const
+{
+    // Assert the preconditions
+    assert( depth >= 0 );
+    assert( depth < discardSizes[ game ] );
+
+    return Card::fromId( pool[ size_t( game ) * TOTAL_CARDS + wrapIndex( discardBases[ game ] + discardSizes[ game ] - 1 - depth ) ] );
+}
+
+// Returns the number of cards in the given player's hand in the given game.
+// 
+// PRE: 0 <= game < nGames; 0 <= playerIndex < nPlayers
+// POST: none
+int
+BatchEngine::getHandSize( int game, int playerIndex ) const
+{
+    return handSizes[ playerIndex * nGames + game ];
+}
+
+// Returns the set of card ids the given player holds in the given game.
+// 
+// PRE: 0 <= game < nGames; 0 <= playerIndex < nPlayers
+// POST: none
+CardMask
+BatchEngine::getHandMask( int game, int playerIndex ) const
+{
+    return handMasks[ playerIndex * nGames + game ];
+}
+
+// Returns the number of copies of the given card the given player holds in the given game.
+// 
+// PRE: 0 <= game < nGames; 0 <= playerIndex < nPlayers
+// POST: none
+int
+BatchEngine::getHandCount( int game, int playerIndex, Card card ) const
+{
+    return handCounts[ ( size_t( playerIndex ) * N_CARD_IDS + card.getId() ) * nGames + game ];
+}
+
+// Returns the sum of the scores of the cards in the given player's hand in the given game.
+// 
+// PRE: 0 <= game < nGames; 0 <= playerIndex < nPlayers
+// POST: return value >= 0
+int
+BatchEngine::getHandScore( int game, int playerIndex ) const
+{
+    int score = 0;
+    for ( CardMask remaining = handMasks[ playerIndex * nGames + game ]; remaining != 0; remaining &= remaining - 1 )
+    {
+        int id = lowestCardId( remaining );
+        score += handCounts[ ( size_t( playerIndex ) * N_CARD_IDS + id ) * nGames + game ] * Card::TABLES.scores[ id ];
+    }
+    return score;
+}
+
+// Returns the given player's score in the given game.
+// 
+// PRE: 0 <= game < nGames; 0 <= playerIndex < nPlayers
+// POST: none
+int
+BatchEngine::getScore( int game, int playerIndex ) const
+{
+    return scores[ playerIndex * nGames + game ];
+}
+
+// Returns the cards the current player of the given game may play in PLAY_PHASE, as GameState::legalPlayMask() does.
+// 
+// PRE: 0 <= game < nGames
+// POST: none
+CardMask
+BatchEngine::legalPlayMask( int game ) const
+{
+    CardMask hand = handMasks[ currentPlayers[ game ] * nGames + game ];
+    int stock = stocks[ game ];
+    int wildColor = wildColors[ game ];
+    CardMask playable = hand & Card::TABLES.playable[ stock ][ wildColor ];
+
+    int currentColor = stock >= FIRST_WILD_ID ? wildColor : Card::TABLES.colors[ stock ];
+    if ( ( hand & Card::TABLES.colorMasks[ currentColor ] ) != 0 )
+    {
+        playable &= ~( CardMask( 1 ) << DRAW4_WILD_ID );
+    }
+
+    return playable;
+}
+
+// Returns the player who will take their turn next in the given game.
+// 
+// PRE: 0 <= game < nGames
+// POST: 0 <= return value < nPlayers
+int
+BatchEngine::getNextPlayerIndex( int game ) const
+{
+    // Stepping backward is the same as stepping forward nPlayers - 1 seats, which keeps the sum positive
+    int increment = reverses[ game ] ? nPlayers - 1 : 1;
+    return ( currentPlayers[ game ] + increment * ( 1 + skips[ game ] ) ) % nPlayers;
+}
+
+// Draws a card from the given game's draw pile, as Table::drawCard() does when shuffling lazily, and returns its id.
+// 
+// PRE: 0 <= game < nGames; the game's table has more than one card
+// POST: if the draw pile was empty, the discard pile will become the new draw pile, excluding its top card
+int
+BatchEngine::drawCard( int game )
+{
+    // Assert the preconditions
+    assert( drawSizes[ game ] + discardSizes[ game ] > 1 );
+
+    // If the draw pile is empty, every discard below the stock becomes the draw pile in place
+    if ( drawSizes[ game ] == 0 )
+    {
+        drawSizes[ game ] = discardSizes[ game ] - 1;
+        discardBases[ game ] = wrapIndex( discardBases[ game ] + discardSizes[ game ] - 1 );
+        discardSizes[ game ] = 1;
+    }
+
+    // Swap a random card of the draw pile to the top, and pop it
+    unsigned char* gamePool = &pool[ size_t( game ) * TOTAL_CARDS ];
+    int drawTop = wrapIndex( discardBases[ game ] - drawSizes[ game ] + TOTAL_CARDS );
+    swap( gamePool[ drawTop ], gamePool[ wrapIndex( drawTop + randoms[ game ].nextBelow( drawSizes[ game ] ) ) ] );
+    drawSizes[ game ]--;
+    return gamePool[ drawTop ];
+}
+
+// Adds the card with the given id to the given player's hand in the given game.
+// 
+// PRE: 0 <= game < nGames; 0 <= playerIndex < nPlayers; 0 <= id < N_CARD_IDS
+// POST: none
+void
+BatchEngine::addCard( int game, int playerIndex, int id )
+{
+    handCounts[ ( size_t( playerIndex ) * N_CARD_IDS + id ) * nGames + game ]++;
+    handMasks[ playerIndex * nGames + game ] |= CardMask( 1 ) << id;
+    handSizes[ playerIndex * nGames + game ]++;
+}
+
+// Removes the card with the given id from the given player's hand in the given game.
+// 
+// PRE: 0 <= game < nGames; 0 <= playerIndex < nPlayers; the player holds the card
+// POST: none
+void
+BatchEngine::removeCard( int game, int playerIndex, int id )
+{
+    unsigned char& count = handCounts[ ( size_t( playerIndex ) * N_CARD_IDS + id ) * nGames + game ];
+
+    // Assert the preconditions
+    assert( count > 0 );
+
+    count--;
+    if ( count == 0 )
+    {
+        handMasks[ playerIndex * nGames + game ] &= ~( CardMask( 1 ) << id );
+    }
+    handSizes[ playerIndex * nGames + game ]--;
+}
+
+// Makes the given player of the given game draw up to the given number of cards, as many as the table can give.
+// 
+// PRE: 0 <= game < nGames; 0 <= playerIndex < nPlayers; nCards >= 0
+// POST: none
+void
+BatchEngine::drawUpTo( int game, int playerIndex, int nCards )
+{
+    int maxCards = min( drawSizes[ game ] + discardSizes[ game ] - 1, nCards );
+    for ( int draw = 0; draw < maxCards; draw++ )
+    {
+        addCard( game, playerIndex, drawCard( game ) );
+    }
+}
+
+// Plays the given card from the current player's hand in the given game, naming the given color if it is wild,
+// and processes its effect under the standard rules.
+// 
+// PRE: 0 <= game < nGames; the card is a legal play for the current player
+//      if the card is wild, 0 <= color < N_COLORS
+// POST: if the player's hand is now empty, the game's round is over
+void
+BatchEngine::playCard( int game, Card card, int color )
+{
+    // Move the card from the hand to the top of the discard pile
+    int playerIndex = currentPlayers[ game ];
+    int id = card.getId();
+    removeCard( game, playerIndex, id );
+    pool[ size_t( game ) * TOTAL_CARDS + wrapIndex( discardBases[ game ] + discardSizes[ game ] ) ] = id;
+    discardSizes[ game ]++;
+    stocks[ game ] = id;
+    if ( card.isWild() )
+    {
+        assert( color >= 0 );
+        assert( color < N_COLORS );
+
+        wildColors[ game ] = color;
+    }
+    if ( handSizes[ playerIndex * nGames + game ] == 0 )
+    {
+        winners[ game ] = playerIndex;
+    }
+
+    // Process the card's effect; under the standard rules, a Draw2 or Draw4 Wild does not skip the player who draws
+    switch ( card.getValue() )
+    {
+        case DRAW2_INDEX:
+            drawUpTo( game, getNextPlayerIndex( game ), 2 );
+            break;
+        case REVERSE_INDEX:
+            reverses[ game ] = !reverses[ game ];
+            break;
+        case SKIP_INDEX:
+            skips[ game ] = true;
+            break;
+        case DRAW4_WILD_INDEX:
+            drawUpTo( game, getNextPlayerIndex( game ), 4 );
+            break;
+    }
+}
+
+// Ends the turn in every game step() marked, passing it to the next player unless the round is over.
+// 
+// PRE: none
+// POST: skip is cleared in every game whose turn ended
+void
+BatchEngine::endTurns()
+{
+    // Every game does the same arithmetic, so this is one branch-free pass, with each select written as a mask:
+    // sixteen games at a time with SSE2, and the games left over one at a time.
+    // Wrapping subtracts at most twice, since the current player moves on by at most two steps of at most nPlayers - 1
+    int game = 0;
+#ifdef __SSE2__
+    game = endTurnsSse2( nGames, nPlayers, endsTurn.data(), reverses.data(), winners.data(), currentPlayers.data(),
+                         phases.data(), skips.data(), turnNumbers.data() );
+#endif
+    for ( ; game < nGames; game++ )
+    {
+        int ends = endsTurn[ game ];
+        int increment = 1 + ( ( nPlayers - 2 ) & -reverses[ game ] );
+        int next = currentPlayers[ game ] + increment + ( increment & -skips[ game ] );
+        next -= nPlayers & -( next >= nPlayers );
+        next -= nPlayers & -( next >= nPlayers );
+        int advances = ends & ( winners[ game ] == NO_WINNER );
+
+        // ends and advances are 0 or 1, so ends - 1 and advances - 1 keep the old value exactly when nothing changes
+        turnNumbers[ game ] += ends;
+        phases[ game ] = ( phases[ game ] & ( ends - 1 ) ) | ( PLAY_PHASE & -ends );
+        currentPlayers[ game ] = ( currentPlayers[ game ] & ( advances - 1 ) ) | ( next & -advances );
+        skips[ game ] &= advances - 1;
+    }
+}
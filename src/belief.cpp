@@ -0,0 +1,469 @@
+#include <assert.h>
+#include "belief.hpp"
+#include "game.hpp"
+using namespace std;
+
+// Initializes a tracker for the given player. It knows nothing until the first stock of a round is reported.
+// 
+// PRE: 0 <= observerIndex < MAX_PLAYERS
+// POST: none
+BeliefTracker::BeliefTracker( int observerIndex )
+{
+    // Assert the preconditions
+    assert( observerIndex >= 0 );
+    assert( observerIndex < MAX_PLAYERS );
+
+    this->observerIndex = observerIndex;
+    nPlayers = 0;
+    currentColor = NO_COLOR_INDEX;
+    for ( int id = 0; id < N_CARD_IDS; id++ )
+    {
+        discardCounts[ id ] = 0;
+    }
+    for ( int playerIndex = 0; playerIndex < MAX_PLAYERS; playerIndex++ )
+    {
+        beliefs[ playerIndex ].nGroups = 0;
+    }
+}
+
+// Returns the index of the player whose knowledge is tracked.
+// 
+// PRE: none
+// POST: none
+int
+BeliefTracker::getObserverIndex() const
+{
+    return observerIndex;
+}
+
+// Returns the set of cards the given opponent might be holding.
+// 
+// PRE: 0 <= playerIndex < the number of players; playerIndex != the observer's index
+// POST: none
+CardMask
+BeliefTracker::getPossibleCards( int playerIndex ) const
+{
+    // Assert the preconditions
+    assert( playerIndex >= 0 );
+    assert( playerIndex < nPlayers );
+    assert( playerIndex != observerIndex );
+
+    // The newest group's mask contains every other group's
+    const HandBelief& belief = beliefs[ playerIndex ];
+    return belief.nGroups == 0 ? 0 : belief.masks[ belief.nGroups - 1 ];
+}
+
+// Deals the cards the observer cannot see into the other players' hands and the draw pile of the given state,
+// uniformly among the deals consistent with everything the observer knows, and reseeds the state's table.
+// Returns false, leaving the state unchanged, if no consistent deal was found, which happens when an opponent drew
+// while they could play, so that what the observer inferred from it is wrong.
+// 
+// A deal gives each group of each opponent's hand its own slots. This is rejection sampling with a proposal that fills
+// the slots in turn, tightest group first, each with an untaken card chosen uniformly among those its mask allows.
+// That proposal favors deals where few cards were allowed, so each slot is kept only with probability
+// allowed / bound, where bound is a fixed upper limit on how many cards the slot can ever be allowed: the cards its mask
+// allows, less the earlier slots whose masks lie within its own. The kept deals are then exactly uniform.
+// The cards are taken from per-id counts, so an attempt takes at most N_CARD_IDS steps per dealt card, and only the kept
+// one lays out the unseen cards left for the draw pile. See belief.hpp for how often attempts are kept.
+// 
+// PRE: state is the state of the game this tracker is following, at the point of the last event
+// POST: the observer's hand, the discard pile, and every hand size are unchanged
+bool
+BeliefTracker::sample( GameState& state, Random& random ) const
+{
+    // Count the copies of each card the observer cannot see: the full deck less the discard pile and the observer's hand
+    const Hand& ownHand = state.getPlayer( observerIndex ).getHand();
+    int unseenCounts[ N_CARD_IDS ];
+    int nUnseen = 0;
+    for ( int id = 0; id < N_CARD_IDS; id++ )
+    {
+        unseenCounts[ id ] = Card::TABLES.copies[ id ] - discardCounts[ id ] - ownHand.count( Card::fromId( id ) );
+        nUnseen += unseenCounts[ id ];
+    }
+    assert( nUnseen == state.getTable().getDrawSize() + TOTAL_CARDS - state.getTable().getTotalCards() - ownHand.getSize() );
+
+    // List every group of every opponent's hand, with how many unseen cards its mask allows,
+    // and find where each opponent's hand starts in the dealt cards
+    int groupPlayers[ MAX_PLAYERS * MAX_BELIEF_GROUPS ];
+    CardMask groupMasks[ MAX_PLAYERS * MAX_BELIEF_GROUPS ];
+    int groupRooms[ MAX_PLAYERS * MAX_BELIEF_GROUPS ];
+    int groupCounts[ MAX_PLAYERS * MAX_BELIEF_GROUPS ];
+    int nGroups = 0;
+    int handStarts[ MAX_PLAYERS ];
+    int nHandCards = 0;
+    for ( int playerIndex = 0; playerIndex < nPlayers; playerIndex++ )
+    {
+        if ( playerIndex == observerIndex )
+        {
+            continue;
+        }
+        handStarts[ playerIndex ] = nHandCards;
+        nHandCards += state.getPlayer( playerIndex ).getHand().getSize();
+
+        const HandBelief& belief = beliefs[ playerIndex ];
+        for ( int group = 0; group < belief.nGroups; group++ )
+        {
+            int room = 0;
+            for ( CardMask remaining = belief.masks[ group ]; remaining != 0; remaining &= remaining - 1 )
+            {
+                room += unseenCounts[ lowestCardId( remaining ) ];
+            }
+            groupPlayers[ nGroups ] = playerIndex;
+            groupMasks[ nGroups ] = belief.masks[ group ];
+            groupRooms[ nGroups ] = room;
+            groupCounts[ nGroups ] = belief.counts[ group ];
+            nGroups++;
+        }
+    }
+
+    // Sort the groups so the tightest are filled first (an insertion sort, since there are only a few)
+    int order[ MAX_PLAYERS * MAX_BELIEF_GROUPS ];
+    for ( int i = 0; i < nGroups; i++ )
+    {
+        int j = i;
+        while ( j > 0 && groupRooms[ order[ j - 1 ] ] > groupRooms[ i ] )
+        {
+            order[ j ] = order[ j - 1 ];
+            j--;
+        }
+        order[ j ] = i;
+    }
+
+    // Lay out the slots in that order, with the bound on how many cards each can be allowed.
+    // Every earlier slot whose mask lies within this one's holds a card this one's mask allows, so the bound is never
+    // exceeded; a bound below 1 means the groups need more cards than there are, and no deal is consistent.
+    // A group's slots share its mask, so the earlier slots within it are counted a group at a time
+    CardMask slotMasks[ TOTAL_CARDS ];
+    int slotBounds[ TOTAL_CARDS ];
+    int slotPositions[ TOTAL_CARDS ]; // Where the slot's card goes in the dealt cards
+    int handFills[ MAX_PLAYERS ] = { 0 };
+    int nSlots = 0;
+    for ( int i = 0; i < nGroups; i++ )
+    {
+        int group = order[ i ];
+        int within = 0;
+        for ( int j = 0; j < i; j++ )
+        {
+            within += ( groupMasks[ order[ j ] ] & ~groupMasks[ group ] ) == 0 ? groupCounts[ order[ j ] ] : 0;
+        }
+        for ( int card = 0; card < groupCounts[ group ]; card++ )
+        {
+            slotMasks[ nSlots ] = groupMasks[ group ];
+            slotBounds[ nSlots ] = groupRooms[ group ] - within - card;
+            slotPositions[ nSlots ] = handStarts[ groupPlayers[ group ] ] + handFills[ groupPlayers[ group ] ]++;
+            if ( slotBounds[ nSlots ] < 1 )
+            {
+                return false;
+            }
+            nSlots++;
+        }
+    }
+    assert( nSlots == nHandCards );
+
+    // Propose deals until one is kept, taking cards from the counts of the untaken copies of each id
+    Card dealt[ TOTAL_CARDS ];
+    for ( int attempt = 0; attempt < MAX_SAMPLE_ATTEMPTS; attempt++ )
+    {
+        int untaken[ N_CARD_IDS ];
+        for ( int id = 0; id < N_CARD_IDS; id++ )
+        {
+            untaken[ id ] = unseenCounts[ id ];
+        }
+        bool kept = true;
+        for ( int slot = 0; slot < nSlots && kept; slot++ )
+        {
+            // Count the untaken cards the slot allows, and keep the slot with probability allowed / bound
+            int allowed = 0;
+            for ( CardMask remaining = slotMasks[ slot ]; remaining != 0; remaining &= remaining - 1 )
+            {
+                allowed += untaken[ lowestCardId( remaining ) ];
+            }
+            assert( allowed <= slotBounds[ slot ] );
+            if ( allowed == 0 || int( random.nextBelow( slotBounds[ slot ] ) ) >= allowed )
+            {
+                kept = false;
+                break;
+            }
+
+            // Take the chosen one of them, counting through the copies in order of id
+            int choice = random.nextBelow( allowed );
+            for ( CardMask remaining = slotMasks[ slot ]; ; remaining &= remaining - 1 )
+            {
+                int id = lowestCardId( remaining );
+                if ( choice < untaken[ id ] )
+                {
+                    untaken[ id ]--;
+                    dealt[ slotPositions[ slot ] ] = Card::fromId( id );
+                    break;
+                }
+                choice -= untaken[ id ];
+            }
+        }
+        if ( !kept )
+        {
+            continue;
+        }
+
+        // The rest of the unseen cards become the draw pile, in random order (a Fisher-Yates shuffle)
+        int nDealt = nHandCards;
+        for ( int id = 0; id < N_CARD_IDS; id++ )
+        {
+            for ( int copy = 0; copy < untaken[ id ]; copy++ )
+            {
+                dealt[ nDealt++ ] = Card::fromId( id );
+            }
+        }
+        assert( nDealt == nUnseen );
+        for ( int i = nUnseen - 1; i > nHandCards; i-- )
+        {
+            swap( dealt[ i ], dealt[ nHandCards + random.nextBelow( i - nHandCards + 1 ) ] );
+        }
+
+        state.dealUnseen( observerIndex, dealt, random );
+        return true;
+    }
+    return false;
+}
+
+// Returns what the observer knows about the given opponent's hand.
+// 
+// PRE: 0 <= playerIndex < the number of players; playerIndex != the observer's index
+// POST: none
+const HandBelief&
+BeliefTracker::getBelief( int playerIndex ) const
+{
+    // Assert the preconditions
+    assert( playerIndex >= 0 );
+    assert( playerIndex < nPlayers );
+    assert( playerIndex != observerIndex );
+
+    return beliefs[ playerIndex ];
+}
+
+// Starts tracking a new round: the discard pile is read off the table, and nothing is known about the other hands.
+// 
+// PRE: none
+// POST: none
+void
+BeliefTracker::onFirstStock( const Game& game, int, Card firstStock )
+{
+    const Table& table = game.getState().getTable();
+    nPlayers = game.getPlayerCount();
+    stock = firstStock;
+    currentColor = firstStock.getColor();
+
+    // The discard pile may hold Draw4 Wilds turned over before the first stock
+    for ( int id = 0; id < N_CARD_IDS; id++ )
+    {
+        discardCounts[ id ] = 0;
+    }
+    for ( int depth = 0; depth < table.getDiscardSize(); depth++ )
+    {
+        discardCounts[ table.getDiscardCardAt( depth ).getId() ]++;
+    }
+
+    // Every opponent's hand is a single group that could hold anything
+    for ( int playerIndex = 0; playerIndex < nPlayers; playerIndex++ )
+    {
+        beliefs[ playerIndex ].nGroups = 0;
+        if ( playerIndex != observerIndex )
+        {
+            addCards( playerIndex, game.getPlayer( playerIndex ).getHand().getSize() );
+        }
+    }
+}
+
+// An opponent who draws had no legal play, so they hold none of the cards playable on the stock;
+// the card they drew could be anything.
+// 
+// PRE: none
+// POST: none
+void
+BeliefTracker::onDraw( const Game&, int playerIndex, Card )
+{
+    if ( playerIndex != observerIndex )
+    {
+        excludeCards( playerIndex, Card::TABLES.playable[ stock.getId() ][ currentColor ] );
+        addCards( playerIndex, 1 );
+    }
+}
+
+// An opponent who tried to draw had no legal play, so they hold none of the cards playable on the stock.
+// 
+// PRE: none
+// POST: none
+void
+BeliefTracker::onTableEmpty( const Game&, int playerIndex )
+{
+    if ( playerIndex != observerIndex )
+    {
+        excludeCards( playerIndex, Card::TABLES.playable[ stock.getId() ][ currentColor ] );
+    }
+}
+
+// Moves the played card to the discard pile. A Draw4 Wild may only be played without a card of the current color,
+// so an opponent who plays one holds none.
+// 
+// PRE: none
+// POST: none
+void
+BeliefTracker::onPlay( const Game&, int playerIndex, Card card )
+{
+    if ( playerIndex != observerIndex )
+    {
+        if ( card.getValue() == DRAW4_WILD_INDEX )
+        {
+            excludeCards( playerIndex, Card::TABLES.colorMasks[ currentColor ] );
+        }
+        removeCard( playerIndex, card );
+    }
+
+    // The color of a wild card is reported next
+    discardCounts[ card.getId() ]++;
+    stock = card;
+    currentColor = card.getColor();
+}
+
+// Adds the cards an opponent was made to draw, which could be anything.
+// 
+// PRE: none
+// POST: none
+void
+BeliefTracker::onDrawPenalty( const Game&, int playerIndex, int, int nDrawn )
+{
+    if ( playerIndex != observerIndex )
+    {
+        addCards( playerIndex, nDrawn );
+    }
+}
+
+// Records the color named for the wild stock.
+// 
+// PRE: 0 <= color < N_COLORS
+// POST: none
+void
+BeliefTracker::onColorChosen( const Game&, int, int color )
+{
+    currentColor = color;
+}
+
+// Every discard but the stock becomes part of the draw pile, so they are unseen again.
+// 
+// PRE: none
+// POST: none
+void
+BeliefTracker::onReshuffle( const Game& )
+{
+    for ( int id = 0; id < N_CARD_IDS; id++ )
+    {
+        discardCounts[ id ] = 0;
+    }
+    discardCounts[ stock.getId() ] = 1;
+}
+
+// Adds the given number of unknown cards to the given opponent's hand as its newest group.
+// If there are too many groups, the two oldest are merged, forgetting the older one's extra constraints.
+// 
+// PRE: 0 <= playerIndex < nPlayers; nCards >= 0
+// POST: none
+void
+BeliefTracker::addCards( int playerIndex, int nCards )
+{
+    // Assert the preconditions
+    assert( nCards >= 0 );
+
+    HandBelief& belief = beliefs[ playerIndex ];
+    if ( nCards == 0 )
+    {
+        return;
+    }
+
+    // Unconstrained cards join the newest group if it is unconstrained too
+    if ( belief.nGroups > 0 && belief.masks[ belief.nGroups - 1 ] == ALL_CARDS )
+    {
+        belief.counts[ belief.nGroups - 1 ] += nCards;
+        return;
+    }
+
+    if ( belief.nGroups == MAX_BELIEF_GROUPS )
+    {
+        belief.counts[ 1 ] += belief.counts[ 0 ];
+        for ( int group = 1; group < belief.nGroups; group++ )
+        {
+            belief.counts[ group - 1 ] = belief.counts[ group ];
+            belief.masks[ group - 1 ] = belief.masks[ group ];
+        }
+        belief.nGroups--;
+    }
+    belief.counts[ belief.nGroups ] = nCards;
+    belief.masks[ belief.nGroups ] = ALL_CARDS;
+    belief.nGroups++;
+}
+
+// Records that the given opponent holds none of the given cards, merging any groups this makes identical.
+// 
+// PRE: 0 <= playerIndex < nPlayers
+// POST: none
+void
+BeliefTracker::excludeCards( int playerIndex, CardMask excluded )
+{
+    HandBelief& belief = beliefs[ playerIndex ];
+    int nGroups = 0;
+    for ( int group = 0; group < belief.nGroups; group++ )
+    {
+        CardMask mask = belief.masks[ group ] & ~excluded;
+        if ( nGroups > 0 && belief.masks[ nGroups - 1 ] == mask )
+        {
+            belief.counts[ nGroups - 1 ] += belief.counts[ group ];
+        }
+        else
+        {
+            belief.counts[ nGroups ] = belief.counts[ group ];
+            belief.masks[ nGroups ] = mask;
+            nGroups++;
+        }
+    }
+    belief.nGroups = nGroups;
+}
+
+// Removes a card the given opponent played from the oldest group that could hold it.
+// Taking it from the most constrained such group never rules out a hand that is still possible.
+// If no group could hold it, the opponent must have drawn while they could play, so their constraints are forgotten.
+// 
+// PRE: 0 <= playerIndex < nPlayers; the opponent's hand is not empty
+// POST: none
+void
+BeliefTracker::removeCard( int playerIndex, Card card )
+{
+    HandBelief& belief = beliefs[ playerIndex ];
+    int group = 0;
+    while ( group < belief.nGroups && !( ( belief.masks[ group ] >> card.getId() ) & 1 ) )
+    {
+        group++;
+    }
+    if ( group == belief.nGroups )
+    {
+        int handSize = 0;
+        for ( int i = 0; i < belief.nGroups; i++ )
+        {
+            handSize += belief.counts[ i ];
+        }
+        belief.counts[ 0 ] = handSize;
+        belief.masks[ 0 ] = ALL_CARDS;
+        belief.nGroups = 1;
+        group = 0;
+    }
+    assert( belief.counts[ group ] > 0 );
+
+    // Remove the group once its last card is gone
+    belief.counts[ group ]--;
+    if ( belief.counts[ group ] == 0 )
+    {
+        for ( int i = group + 1; i < belief.nGroups; i++ )
+        {
+            belief.counts[ i - 1 ] = belief.counts[ i ];
+            belief.masks[ i - 1 ] = belief.masks[ i ];
+        }
+        belief.nGroups--;
+    }
+}
@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <assert.h>
+#include <string.h>
+#include "bits.hpp"
+using namespace std;
+
+// Initializes a bit writer that writes whole bytes to the given writer.
+// 
+// PRE: out must outlive the bit writer
+// POST: none
+BitWriter::BitWriter( BufferedWriter& writer )
+    : out( writer )
+{
+    pending = 0;
+    nPending = 0;
+}
+
+// Appends the low nBits bits of the given value.
+// 
+// PRE: 1 <= nBits <= 64; value < 2 ^ nBits
+// POST: none
+void
+BitWriter::write( uint64_t value, int nBits )
+{
+    // Assert the preconditions
+    assert( nBits >= 1 );
+    assert( nBits <= 64 );
+    assert( nBits == 64 || value >> nBits == 0 );
+
+    // Fill the pending word; once it is full, write it and keep the bits that did not fit
+    pending |= value << nPending;
+    nPending += nBits;
+    if ( nPending >= 64 )
+    {
+        unsigned char bytes[ 8 ];
+        for ( int i = 0; i < 8; i++ )
+        {
+            bytes[ i ] = pending >> ( 8 * i );
+        }
+        out.write( bytes, 8 );
+        nPending -= 64;
+        pending = nPending == 0 ? 0 : value >> ( nBits - nPending );
+    }
+}
+
+// Appends the given bytes as they are, for blocks too large to write a field at a time.
+// 
+// PRE: the stream is at a byte boundary (see alignToByte())
+// POST: none
+void
+BitWriter::writeBytes( const void* data, size_t nBytes )
+{
+    // Assert the preconditions
+    assert( nPending == 0 );
+
+    out.write( data, nBytes );
+}
+
+// Pads the stream with zeros to the next byte boundary and writes every pending byte.
+// 
+// PRE: none
+// POST: every bit written so far has reached the writer
+void
+BitWriter::alignToByte()
+{
+    while ( nPending > 0 )
+    {
+        unsigned char byte = pending;
+        out.write( &byte, 1 );
+        pending >>= 8;
+        nPending = nPending > 8 ? nPending - 8 : 0;
+    }
+    pending = 0;
+}
+
+// Initializes a bit reader over the given bytes.
+// 
+// PRE: data holds nBytes bytes, and must outlive the reader
+// POST: getBitPosition() == 0
+BitReader::BitReader( const unsigned char* data, size_t nBytes )
+{
+    this->data = data;
+    nBits = nBytes * 8;
+    position = 0;
+}
+
+// Reads the next nBits bits as a value.
+// 
+// PRE: 1 <= nBits <= 64; canRead( nBits )
+// POST: none
+uint64_t
+BitReader::read( int nBits )
+{
+    // Assert the preconditions
+    assert( nBits >= 1 );
+    assert( nBits <= 64 );
+    assert( canRead( nBits ) );
+
+    // Gather the field a byte at a time
+    uint64_t value = 0;
+    int nRead = 0;
+    while ( nRead < nBits )
+    {
+        int offset = position % 8;
+        int nTaken = min( 8 - offset, nBits - nRead );
+        uint64_t bits = ( data[ position / 8 ] >> offset ) & ( ( 1u << nTaken ) - 1 );
+        value |= bits << nRead;
+        nRead += nTaken;
+        position += nTaken;
+    }
+
+    return value;
+}
+
+// Copies the next nBytes bytes, as written by BitWriter::writeBytes(), into the given block.
+// 
+// PRE: getBitPosition() is a multiple of 8; canRead( nBytes * 8 )
+// POST: none
+void
+BitReader::readBytes( void* block, size_t nBytes )
+{
+    // Assert the preconditions
+    assert( position % 8 == 0 );
+    assert( canRead( nBytes * 8 ) );
+
+    memcpy( block, data + position / 8, nBytes );
+    position += nBytes * 8;
+}
+
+// Skips to the next byte boundary, past the padding BitWriter::alignToByte() wrote.
+// 
+// PRE: none
+// POST: getBitPosition() is a multiple of 8
+void
+BitReader::alignToByte()
+{
+    position = ( position + 7 ) / 8 * 8;
+}
+
+// Moves to the given bit of the block, so the next read starts there.
+// 
+// PRE: bitPosition <= the number of bits in the block
+// POST: getBitPosition() == bitPosition
+void
+BitReader::seek( size_t bitPosition )
+{
+    // Assert the preconditions
+    assert( bitPosition <= nBits );
+
+    position = bitPosition;
+}
+
+// Returns true if at least nBits bits are left to read.
+// 
+// PRE: none
+// POST: none
+bool
+BitReader::canRead( size_t nBits ) const
+{
+    return position + nBits <= this->nBits;
+}
+
+// Returns the number of bits read so far.
+// 
+// PRE: none
+// POST: none
+size_t
+BitReader::getBitPosition() const
+{
+    return position;
+}
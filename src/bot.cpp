@@ -0,0 +1,139 @@
+#include <assert.h>
+#include "bot.hpp"
+#include "game.hpp"
+#include "player.hpp"
+#include "state.hpp"
+using namespace std;
+
+// Never draws while a card can be played.
+// 
+// PRE: none
+// POST: return value == false
+bool
+GreedyAgent::chooseDraw( const Game&, const Player& )
+{
+    return false;
+}
+
+// Returns the first playable card that is not wild, or a wild card if nothing else can be played.
+// 
+// PRE: the player has at least one card that can be played on the stock
+// POST: return value will be a card in the player's hand that can be played on the stock
+Card
+GreedyAgent::chooseCard( const Game& game, const Player& player )
+{
+    // Wild cards have the highest ids, so the lowest playable id is a wild card only if nothing else can be played
+    CardMask playable = player.getHand().playableMask( game.getStock(), game.getWildColor() );
+    assert( playable != 0 );
+
+    return Card::fromId( lowestCardId( playable ) );
+}
+
+// Always plays a playable drawn card.
+// 
+// PRE: the drawn card can be played on the stock
+// POST: return value == true
+bool
+GreedyAgent::choosePlayDrawn( const Game&, const Player&, Card )
+{
+    return true;
+}
+
+// Returns the color the player holds the most cards of (red if they hold no colored cards).
+// 
+// PRE: none
+// POST: 0 <= return value < N_COLORS
+int
+GreedyAgent::chooseColor( const Game&, const Player& player )
+{
+    return getMostHeldColor( player.getHand() );
+}
+
+// Returns the color the given hand holds the most cards of (red if it holds no colored cards).
+// 
+// PRE: none
+// POST: 0 <= return value < N_COLORS
+int getMostHeldColor( const Hand& hand )
+{
+    // Count the cards of each color
+    int colorCounts[ N_COLORS ] = { 0 };
+    for ( CardMask remaining = hand.getMask(); remaining != 0; remaining &= remaining - 1 )
+    {
+        Card card = Card::fromId( lowestCardId( remaining ) );
+        if ( !card.isWild() )
+        {
+            colorCounts[ card.getColor() ] += hand.count( card );
+        }
+    }
+
+    // Find the most common color, preferring the lowest color index on ties
+    int bestColor = 0;
+    for ( int color = 1; color < N_COLORS; color++ )
+    {
+        if ( colorCounts[ color ] > colorCounts[ bestColor ] )
+        {
+            bestColor = color;
+        }
+    }
+
+    return bestColor;
+}
+
+// Picks the greedy player's move for the current player of the given state. Legal moves list cards in order of id, and
+// wild cards have the highest ids, so the first move plays a card that is not wild whenever there is one; drawing or
+// keeping the drawn card comes last, so it is only chosen when nothing can be played.
+// 
+// PRE: moves is the non-empty list of legal moves for the current player of state
+// POST: return value is one of the moves in the list
+template < class State >
+Move chooseGreedyMove( const State& state, const MoveList& moves )
+{
+    // Assert the preconditions
+    assert( !moves.isEmpty() );
+
+    // Define convenience variables
+    int currentPlayerIndex = state.getCurrentPlayerIndex();
+    const Hand& hand = state.getPlayer( currentPlayerIndex ).getHand();
+
+    // Name the most held color for the first stock
+    if ( state.getPhase() == FIRST_COLOR_PHASE )
+    {
+        return Move::chooseColor( getMostHeldColor( hand ) );
+    }
+
+    // Swap hands with the seat holding the fewest cards, preferring the first listed on ties
+    if ( state.getPhase() == SWAP_PHASE )
+    {
+        Move best = moves.get( 0 );
+        int bestSize = state.getPlayer( best.getTarget() ).getHand().getSize();
+        for ( int i = 1; i < moves.getSize(); i++ )
+        {
+            Move move = moves.get( i );
+            int size = state.getPlayer( move.getTarget() ).getHand().getSize();
+            if ( size < bestSize )
+            {
+                best = move;
+                bestSize = size;
+            }
+        }
+        return best;
+    }
+
+    // Otherwise play the first card listed, naming the most held color if it is wild
+    Move move = moves.get( 0 );
+    if ( move.getType() == PLAY_CARD && move.getCard().isWild() )
+    {
+        return Move::playCard( move.getCard(), getMostHeldColor( hand ) );
+    }
+    if ( move.getType() == PLAY_DRAWN && move.getCard().isWild() )
+    {
+        return Move::playDrawn( move.getCard(), getMostHeldColor( hand ) );
+    }
+    return move;
+}
+
+// The rule sets and limits chooseGreedyMove() is compiled for; as in state.cpp, a new combination must be added here
+template Move chooseGreedyMove( const GameState&, const MoveList& );
+template Move chooseGreedyMove( const OfficialGameState&, const MoveList& );
+template Move chooseGreedyMove( const HouseGameState&, const MoveList& );
+template Move chooseGreedyMove( const TournamentGameState&, const MoveList& );
@@ -3,21 +3,23 @@
 #include "card.hpp"
 using namespace std;
 
+// The card tables are defined in the class so that they can be used in constant expressions; this provides their storage
+constexpr CardTables Card::TABLES;
+
 // Initializes a Card as a Red 0.
 // 
 // PRE: none
 // POST: color == 0; value == 0
 Card::Card()
 {
-    color = 0;
-    value = 0;
+    id = cardId( 0, 0 );
 }
 
 // Initializes a Card of the given color and value.
 // 
 // PRE: 0 <= c <= 4; 0-3 are actual colors, 4 represents cards with no color (i.e. unplayed wild cards)
 //      0 <= v <= 14; 0-9 are number cards, 10-14 are action/wild cards
-//      if c == 4 (no color), v == 13 or 14 (wild or draw4 wild)
+//      c == 4 (no color) if and only if v == 13 or 14 (wild or draw4 wild)
 // POST: color == c; value == v
 Card::Card( int c, int v )
 {
@@ -26,33 +28,25 @@ Card::Card( int c, int v )
     assert( c <= 4 );
     assert( v >= 0 );
     assert( v <= 14 );
-    if ( c == 4 )
-    {
-        assert( v == 13 || v == 14 );
-    }
+    assert( ( c == 4 ) == ( v == 13 || v == 14 ) );
 
-    color = c;
-    value = v;
+    id = cardId( c, v );
 }
 
-// Returns the integer color of the card.
+// Returns the card with the given id.
 // 
-// PRE: none
-// POST: 0 <= return value < N_COLORS, or return value == NO_COLOR_INDEX
-int
-Card::getColor() const
+// PRE: 0 <= cardId < N_CARD_IDS
+// POST: return value.getId() == cardId
+Card
+Card::fromId( int cardId )
 {
-    return color;
-}
+    // Assert the preconditions
+    assert( cardId >= 0 );
+    assert( cardId < N_CARD_IDS );
 
-// Returns the integer value of the card.
-// 
-// PRE: none
-// POST: 0 <= return value < N_VALUES
-int
-Card::getValue() const
-{
-    return value;
+    Card card;
+    card.id = cardId;
+    return card;
 }
 
 // Returns the full name of the card's color (e.g. Red). If the card is a wild card, returns "None".
@@ -62,7 +56,7 @@ Card::getValue() const
 string
 Card::getColorAsString() const
 {
-    return COLOR_STRINGS[ color ];
+    return COLOR_STRINGS[ getColor() ];
 }
 
 // Returns the full name of the card's value (e.g. Draw2).
@@ -73,7 +67,7 @@ Card::getColorAsString() const
 string
 Card::getValueAsString() const
 {
-    return VALUE_STRINGS[ value ];
+    return VALUE_STRINGS[ getValue() ];
 }
 
 // Returns the abbreviated version of the card (e.g. rD).
@@ -83,25 +77,28 @@ Card::getValueAsString() const
 string
 Card::toStringShort() const
 {
-    const char shortName[] = { COLOR_CHARS[ color ], VALUE_CHARS[ value ] }; 
-    string nameString( shortName, 2 );
-    return nameString;
+    return string( TABLES.shortNames[ id ], 2 );
 }
 
 // Returns the full name of the card (e.g. Red Draw2).
+// If the card is a wild card, this is just its value (e.g. Draw4 Wild).
 // 
 // PRE: none
 // POST: none
 string
 Card::toStringLong() const
 {
-    // If the card is a wild card, just return its value string
-    if ( isWild() )
-    {
-        return getValueAsString();
-    }
+    return string( TABLES.longNames[ id ] );
+}
 
-    return getColorAsString() + " " + getValueAsString();
+// Returns the abbreviated version of the card (e.g. rD) without constructing a string.
+// 
+// PRE: none
+// POST: return value is a null-terminated string of length 2
+const char*
+Card::getShortName() const
+{
+    return TABLES.shortNames[ id ];
 }
 
 // Prints the abbreviated version of the card (e.g. rD).
@@ -124,126 +121,24 @@ Card::printLong() const
     cout << toStringLong();
 }
 
-// Returns the point value of the card.
-// 
-// PRE: none
-// POST: none
-int
-Card::getScore() const
-{
-    // All wild cards have the same value
-    if ( isWild() )
-    {
-        return WILD_SCORE;
-    }
-
-    // All action cards have the same value
-    if ( isAction() )
-    {
-        return ACTION_SCORE;
-    }
-
-    // Number cards are worth their face value
-    return value;
-}
-
-// Returns true if this card is an action card.
-// In this implementation, wild cards are not considered action cards.
-// 
-// PRE: none
-// POST: none
-bool
-Card::isAction() const
-{
-    return value >= 10 && value <= 12;
-}
-
-// Returns true if this card is a wild card.
-// 
-// PRE: none
-// POST: none
-bool
-Card::isWild() const
-{
-    return value >= 13;
-}
-
-// Returns true if this card can be played on the given card.
-// 
-// PRE: if the card is a wild card, wildColor must be valid (0 <= wildColor < N_COLORS)
-// POST: none
-bool
-Card::canPlayOn( Card other, int wildColor ) const
-{
-    // If this card is wild, it can be played on anything
-    if ( isWild() )
-    {
-        return true;
-    }
-
-    // If the other card is wild and the colors match, this card can be played on it
-    if ( other.isWild() )
-    {
-        // Assert that wildColor is valid
-        // It should not be checked before this because a wild card might not have been played yet
-        assert( wildColor >= 0 );
-        assert( wildColor < N_COLORS );
-
-        return color == wildColor;
-    }
-
-    // If at least one attribute is shared between the cards, this card can be played on the other
-    return color == other.color || value == other.value;
-}
-
-// Returns true if this card equals the given card.
-// 
-// PRE: none
-// POST: none
-bool
-Card::isEqual( Card other ) const
-{
-    return color == other.color && value == other.value;
-}
-
 // Returns true if this card is less than the given card.
-// Cards are first sorted by color alphabetically and then value.
+// Cards are first sorted by color and then value, which is also the order of their ids.
 // 
 // PRE: none
 // POST: none
 bool
 Card::isLessThan( Card other ) const
 {
-    if ( color < other.color )
-    {
-        return true;
-    }
-    
-    if ( color == other.color )
-    {
-        return value < other.value;
-    }
-    
-    return false;
+    return id < other.id;
 }
 
 // Returns true if this card is greater than the given card.
-// Cards are first sorted by color alphabetically and then value.
+// Cards are first sorted by color and then value, which is also the order of their ids.
 // 
 // PRE: none
 // POST: none
 bool
 Card::isGreaterThan( Card other ) const
 {
-    if ( color > other.color )
-    {
-        return true;
-    }
-    
-    if ( color == other.color )
-    {
-        return value > other.value;
-    }
-    
-    return false;
+    return id > other.id;
 }
@@ -0,0 +1,302 @@
+#include <iostream>
+#include <string>
+#include "console.hpp"
+#include "game.hpp"
+#include "player.hpp"
+using namespace std;
+
+// Waits for the player to acknowledge that they must draw.
+// 
+// PRE: the player has no card that can be played on the stock
+// POST: none
+void
+ConsoleAgent::confirmForcedDraw( const Game&, const Player& )
+{
+    string junk;
+    cout << "You have no plays available. Press enter to draw a card.";
+    getline( cin, junk );
+}
+
+// Prompts to see if the player wants to draw rather than play a card from their hand (default is no).
+// 
+// PRE: the player has at least one card that can be played on the stock
+// POST: none
+bool
+ConsoleAgent::chooseDraw( const Game&, const Player& )
+{
+    cout << "Draw a card? (y/N) ";
+    string input;
+    getline( cin, input );
+    return input == "y" || input == "Y";
+}
+
+// Prompts for a valid card for the player to play.
+// 
+// PRE: the player has at least one card that can be played on the stock
+// POST: return value will be a card in the player's hand that can legally be played
+Card
+ConsoleAgent::chooseCard( const Game& game, const Player& player )
+{
+    // Define convenience variables
+    const Hand& hand = player.getHand();
+    Card stock = game.getStock();
+
+    // Will continue until valid input is received, upon which the method will return
+    while ( true )
+    {
+        // Prompt the player for the card to play
+        string cardString;
+        cout << "Choose a card to play: ";
+        getline( cin, cardString );
+        int cardIndex = hand.findString( cardString );
+
+        // The card was not found in the player's hand, so print an error
+        if ( cardIndex == -1 )
+        {
+            cout << "You do not have the card \"" << cardString << "\" in your hand." << endl;
+            cout << "Enter one of the cards in your hand, as listed above." << endl;
+            cout << endl;
+        }
+        // The player entered a valid card, so check if it can be played
+        else
+        {
+            Card card = hand.getCardAt( cardIndex );
+
+            // If this card cannot be played on the stock, it is not valid
+            if ( !card.canPlayOn( stock, game.getWildColor() ) )
+            {
+                cout << "You cannot play a " << card.toStringLong() << " on a " << stock.toStringLong() << "." << endl;
+                cout << "Either the color or the value must match." << endl;
+                cout << endl;
+            }
+            // A Draw4 Wild matches anything, but may only be played when no other card of the current color can be
+            else if ( !game.isLegalPlay( card ) )
+            {
+                cout << "You cannot play a " << card.toStringLong() << " while you have a card of the current color." << endl;
+                cout << endl;
+            }
+            // This card is valid, so return it
+            else
+            {
+                return card;
+            }
+        }
+    }
+}
+
+// Prompts to see if the player wants to play the card they just drew (default is yes).
+// 
+// PRE: the drawn card can be played on the stock
+// POST: none
+bool
+ConsoleAgent::choosePlayDrawn( const Game&, const Player&, Card )
+{
+    cout << "Play it? (Y/n) ";
+    string input;
+    getline( cin, input );
+    return input != "n" && input != "N";
+}
+
+// Prompts for a valid color (red, yellow, green, or blue) for a wild card.
+// 
+// PRE: none
+// POST: 0 <= return value <= 3
+int
+ConsoleAgent::chooseColor( const Game&, const Player& )
+{
+    // Prompt until a valid color is entered, at which point the function will return
+    while (true)
+    {
+        // Prompt for the color of the wild card
+        cout << "Choose a color for your wild card (r, y, g, b): ";
+        string color;
+        getline( cin, color);
+        if ( color.size() == 1 )
+        {
+            // If just one character was entered, get the int corresponding to the character
+            // It may better to iterate over the colors array, but this would probably be slower
+            switch ( color.at( 0 ) )
+            {
+                case 'r':
+                    return 0;
+                case 'y':
+                    return 1;
+                case 'g':
+                    return 2;
+                case 'b':
+                    return 3;
+                default:
+                    // A character other than r, y, g, or b was entered, so print an error and re-prompt
+                    cout << "Please enter r, y, g, or b." << endl;
+                    break;
+            }
+        }
+        else
+        {
+            // More than one character was entered, so print an error and re-prompt
+            cout << "Please enter just one character (r, y, g, or b)." << endl;
+        }
+    }
+}
+
+// Initializes a sink that shows every player what they draw.
+// 
+// PRE: none
+// POST: none
+ConsoleEvents::ConsoleEvents()
+{
+    for ( int playerIndex = 0; playerIndex < MAX_PLAYERS; playerIndex++ )
+    {
+        hidden[ playerIndex ] = false;
+    }
+}
+
+// Keeps the given player's cards off the terminal, for a computer player sharing it with people:
+// their draws are announced without the card, and the colors they name are announced.
+// 
+// PRE: 0 <= playerIndex < MAX_PLAYERS
+// POST: none
+void
+ConsoleEvents::hideHand( int playerIndex )
+{
+    hidden[ playerIndex ] = true;
+}
+
+// Announces the effect of the first stock of the round.
+// 
+// PRE: none
+// POST: none
+void
+ConsoleEvents::onFirstStock( const Game& game, int firstPlayerIndex, Card stock )
+{
+    switch ( stock.getValue() )
+    {
+        case DRAW2_INDEX:
+            cout << endl;
+            cout << "The first stock is a Draw2, so " << game.getPlayerName( firstPlayerIndex ) << " draws 2 cards." << endl;
+            break;
+        case REVERSE_INDEX:
+            cout << endl;
+            cout << "The first stock is a Reverse, so the direction of play starts reversed." << endl;
+            break;
+        case SKIP_INDEX:
+            cout << endl;
+            cout << "The first stock is a Skip, so " << game.getPlayerName( firstPlayerIndex ) << " is skipped." << endl;
+            break;
+        // The first player is about to be prompted for a color, so show them their hand
+        case WILD_INDEX:
+            cout << endl;
+            cout << "The first stock is a Wild card, so " << game.getPlayerName( firstPlayerIndex ) << " will pick its color." << endl;
+            if ( !hidden[ firstPlayerIndex ] )
+            {
+                cout << "Your Hand: ";
+                game.getPlayer( firstPlayerIndex ).getHand().printContents();
+                cout << endl;
+            }
+            break;
+    }
+}
+
+// Tells the player which card they drew, or everyone that they drew one if their hand is hidden.
+// 
+// PRE: none
+// POST: none
+void
+ConsoleEvents::onDraw( const Game& game, int playerIndex, Card card )
+{
+    if ( hidden[ playerIndex ] )
+    {
+        cout << game.getPlayerName( playerIndex ) << " draws a card." << endl;
+    }
+    else
+    {
+        cout << "You drew a " << card.toStringLong() << "." << endl;
+    }
+}
+
+// Tells the player that their turn is skipped because there is nothing to draw.
+// 
+// PRE: none
+// POST: none
+void
+ConsoleEvents::onTableEmpty( const Game&, int )
+{
+    cout << endl;
+    cout << "The draw and discard piles are empty, so your turn is skipped." << endl;
+}
+
+// Prints a message for other players to reference.
+// 
+// PRE: none
+// POST: none
+void
+ConsoleEvents::onPlay( const Game& game, int playerIndex, Card card )
+{
+    cout << endl;
+    cout << game.getPlayerName( playerIndex ) << " plays a " << card.toStringLong() << "." << endl;
+}
+
+// Prints a message corresponding to the number of cards drawn.
+// 
+// PRE: 0 <= nDrawn <= nCards
+// POST: none
+void
+ConsoleEvents::onDrawPenalty( const Game& game, int playerIndex, int nCards, int nDrawn )
+{
+    if ( nDrawn == 0 )
+    {
+        cout << "The table is empty, so " << game.getPlayerName( playerIndex ) << " draws no cards." << endl;
+    }
+    else if ( nDrawn == 1 )
+    {
+        if ( nCards == 1 )
+        {
+            cout << game.getPlayerName( playerIndex ) << " draws 1 card." << endl;
+        }
+        else
+        {
+            cout << game.getPlayerName( playerIndex ) << " draws 1 card, but there are not enough cards on the table to draw up to " << nCards << "." << endl;
+        }
+    }
+    else if ( nDrawn < nCards )
+    {
+        cout << game.getPlayerName( playerIndex ) << " draws " << nDrawn << " cards, but there are not enough cards on the table to draw up to " << nCards << "." << endl;
+    }
+    else
+    {
+        cout << game.getPlayerName( playerIndex ) << " draws " << nCards << " cards." << endl;
+    }
+}
+
+// Announces that the direction of play has changed.
+// 
+// PRE: none
+// POST: none
+void
+ConsoleEvents::onReverse( const Game&, int )
+{
+    cout << "The direction of play has been reversed." << endl;
+}
+
+// Announces that the given player is skipped.
+// 
+// PRE: none
+// POST: none
+void
+ConsoleEvents::onSkip( const Game& game, int playerIndex )
+{
+    cout << game.getPlayerName( playerIndex ) << " is skipped." << endl;
+}
+
+// Announces the color a player whose hand is hidden named; the others named it at the prompt.
+// 
+// PRE: 0 <= color < N_COLORS
+// POST: none
+void
+ConsoleEvents::onColorChosen( const Game& game, int playerIndex, int color )
+{
+    if ( hidden[ playerIndex ] )
+    {
+        cout << game.getPlayerName( playerIndex ) << " names " << COLOR_STRINGS[ color ] << "." << endl;
+    }
+}
@@ -0,0 +1,543 @@
+#include <assert.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "corpus.hpp"
+#include "game.hpp"
+using namespace std;
+
+// The name of each column's file in a corpus directory, and the width of its values in bytes
+static const char* const COLUMN_NAMES[ N_CORPUS_COLUMNS ] =
+{
+    "seed", "stream", "player_count", "goal_score", "winner", "round_count", "turn_count",
+    "round_offset", "round_first_card", "round_winner", "round_points",
+    "move_offset", "move_round", "move_turn", "move_player", "move_type", "move_card", "move_color", "move_hand_size"
+};
+static const int COLUMN_WIDTHS[ N_CORPUS_COLUMNS ] = { 8, 8, 1, 4, 1, 2, 4, 8, 1, 1, 2, 8, 2, 2, 1, 1, 1, 1, 1 };
+
+// The name of the meta file in a corpus directory
+static const char* const META_NAME = "meta";
+
+// The contents of the meta file: what is needed to check the column files and to know how many rows they hold
+struct CorpusMeta
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t nColumns;
+    uint32_t reserved;
+    uint64_t nGames;
+    uint64_t nRounds;
+    uint64_t nMoves;
+};
+
+// The hand size column counts a hand in a byte
+static_assert( TOTAL_CARDS <= 0xff, "A hand size must fit in a byte" );
+
+// Returns the rows the given column of the given columns holds.
+// 
+// PRE: 0 <= column < N_CORPUS_COLUMNS
+// POST: none
+static uint64_t
+getRowCount( const CorpusColumns& rows, int column )
+{
+    if ( column == CORPUS_ROUND_OFFSET || column == CORPUS_MOVE_OFFSET )
+    {
+        return rows.nGames + 1;
+    }
+    if ( column < CORPUS_ROUND_OFFSET )
+    {
+        return rows.nGames;
+    }
+    return column < CORPUS_MOVE_OFFSET ? rows.nRounds : rows.nMoves;
+}
+
+// Returns the first value of the given column of the given columns.
+// 
+// PRE: 0 <= column < N_CORPUS_COLUMNS
+// POST: none
+static const void*
+getColumnData( const CorpusColumns& rows, int column )
+{
+    switch ( column )
+    {
+        case CORPUS_SEED: return rows.seeds;
+        case CORPUS_STREAM: return rows.streams;
+        case CORPUS_PLAYER_COUNT: return rows.playerCounts;
+        case CORPUS_GOAL_SCORE: return rows.goalScores;
+        case CORPUS_WINNER: return rows.winners;
+        case CORPUS_ROUND_COUNT: return rows.roundCounts;
+        case CORPUS_TURN_COUNT: return rows.turnCounts;
+        case CORPUS_ROUND_OFFSET: return rows.roundOffsets;
+        case CORPUS_ROUND_FIRST_CARD: return rows.roundFirstCards;
+        case CORPUS_ROUND_WINNER: return rows.roundWinners;
+        case CORPUS_ROUND_POINTS: return rows.roundPoints;
+        case CORPUS_MOVE_OFFSET: return rows.moveOffsets;
+        case CORPUS_MOVE_ROUND: return rows.moveRounds;
+        case CORPUS_MOVE_TURN: return rows.moveTurns;
+        case CORPUS_MOVE_PLAYER: return rows.movePlayers;
+        case CORPUS_MOVE_TYPE: return rows.moveTypes;
+        case CORPUS_MOVE_CARD: return rows.moveCards;
+        case CORPUS_MOVE_COLOR: return rows.moveColors;
+        default: return rows.moveHandSizes;
+    }
+}
+
+// Points the given column of the given columns at the given values.
+// 
+// PRE: 0 <= column < N_CORPUS_COLUMNS; data holds values of the column's type
+// POST: none
+static void
+setColumnData( CorpusColumns& rows, int column, const void* data )
+{
+    switch ( column )
+    {
+        case CORPUS_SEED: rows.seeds = static_cast< const uint64_t* >( data ); break;
+        case CORPUS_STREAM: rows.streams = static_cast< const uint64_t* >( data ); break;
+        case CORPUS_PLAYER_COUNT: rows.playerCounts = static_cast< const uint8_t* >( data ); break;
+        case CORPUS_GOAL_SCORE: rows.goalScores = static_cast< const uint32_t* >( data ); break;
+        case CORPUS_WINNER: rows.winners = static_cast< const uint8_t* >( data ); break;
+        case CORPUS_ROUND_COUNT: rows.roundCounts = static_cast< const uint16_t* >( data ); break;
+        case CORPUS_TURN_COUNT: rows.turnCounts = static_cast< const uint32_t* >( data ); break;
+        case CORPUS_ROUND_OFFSET: rows.roundOffsets = static_cast< const uint64_t* >( data ); break;
+        case CORPUS_ROUND_FIRST_CARD: rows.roundFirstCards = static_cast< const uint8_t* >( data ); break;
+        case CORPUS_ROUND_WINNER: rows.roundWinners = static_cast< const uint8_t* >( data ); break;
+        case CORPUS_ROUND_POINTS: rows.roundPoints = static_cast< const uint16_t* >( data ); break;
+        case CORPUS_MOVE_OFFSET: rows.moveOffsets = static_cast< const uint64_t* >( data ); break;
+        case CORPUS_MOVE_ROUND: rows.moveRounds = static_cast< const uint16_t* >( data ); break;
+        case CORPUS_MOVE_TURN: rows.moveTurns = static_cast< const uint16_t* >( data ); break;
+        case CORPUS_MOVE_PLAYER: rows.movePlayers = static_cast< const uint8_t* >( data ); break;
+        case CORPUS_MOVE_TYPE: rows.moveTypes = static_cast< const uint8_t* >( data ); break;
+        case CORPUS_MOVE_CARD: rows.moveCards = static_cast< const uint8_t* >( data ); break;
+        case CORPUS_MOVE_COLOR: rows.moveColors = static_cast< const uint8_t* >( data ); break;
+        default: rows.moveHandSizes = static_cast< const uint8_t* >( data ); break;
+    }
+}
+
+// Initializes an empty game.
+// 
+// PRE: none
+// POST: none
+CorpusGame::CorpusGame()
+{
+    beginGame( ReplayHeader() );
+}
+
+// Starts gathering the rows of a new game, forgetting the last one.
+// 
+// PRE: none
+// POST: none
+void
+CorpusGame::beginGame( const ReplayHeader& header )
+{
+    seed = header.seed;
+    stream = header.stream;
+    playerCount = header.nPlayers;
+    goalScore = header.goalScore;
+    winner = 0;
+    roundCount = 0;
+    turnCount = 0;
+    turn = 0;
+    roundOffsets[ 0 ] = 0;
+    roundOffsets[ 1 ] = 0;
+    roundFirstCards.clear();
+    roundWinners.clear();
+    roundPoints.clear();
+    moveOffsets[ 0 ] = 0;
+    moveOffsets[ 1 ] = 0;
+    moveRounds.clear();
+    moveTurns.clear();
+    movePlayers.clear();
+    moveTypes.clear();
+    moveCards.clear();
+    moveColors.clear();
+    moveHandSizes.clear();
+}
+
+// Marks the start of a round. The caller must call this before dealing it, since dealing may already ask for a decision.
+// 
+// PRE: none
+// POST: none
+void
+CorpusGame::beginRound()
+{
+    roundCount++;
+    turn = 0;
+    roundFirstCards.push_back( CORPUS_NO_CARD );
+    roundWinners.push_back( CORPUS_NO_PLAYER );
+    roundPoints.push_back( 0 );
+}
+
+// Notes the card that started the discard pile of the round just dealt.
+// 
+// PRE: beginRound() has been called; state is the position just after the round was dealt
+// POST: none
+void
+CorpusGame::endDeal( const GameState& state )
+{
+    // Assert the preconditions
+    assert( !roundFirstCards.empty() );
+
+    roundFirstCards.back() = state.getStock().getId();
+}
+
+// Marks the start of a turn of the current round.
+// 
+// PRE: beginRound() has been called
+// POST: none
+void
+CorpusGame::beginTurn()
+{
+    turn++;
+    turnCount++;
+}
+
+// Adds a move row for the given move, made by the current player of the given game.
+// 
+// PRE: beginRound() has been called; move is in moves
+// POST: none
+void
+CorpusGame::recordDecision( const Game& game, const MoveList&, Move move )
+{
+    // Define convenience variables
+    int playerIndex = game.getCurrentPlayerIndex();
+    bool playsCard = move.getType() == PLAY_CARD || move.getType() == PLAY_DRAWN;
+
+    // A decision made while dealing (naming the color of a wild first stock) belongs to the round's first turn
+    moveRounds.push_back( roundCount > 0 ? roundCount - 1 : 0 );
+    moveTurns.push_back( turn > 0 ? turn - 1 : 0 );
+    movePlayers.push_back( playerIndex );
+    moveTypes.push_back( move.getType() );
+    moveCards.push_back( playsCard ? move.getCard().getId() : CORPUS_NO_CARD );
+    moveColors.push_back( move.getColor() );
+    moveHandSizes.push_back( game.getPlayer( playerIndex ).getHand().getSize() );
+}
+
+// Notes the outcome of the current round: the seat of the player who went out and the points they scored,
+// or CORPUS_NO_PLAYER if the round was abandoned.
+// 
+// PRE: beginRound() has been called
+// POST: none
+void
+CorpusGame::endRound( int winnerIndex, int points )
+{
+    // Assert the preconditions
+    assert( !roundWinners.empty() );
+
+    roundWinners.back() = winnerIndex;
+    roundPoints.back() = points;
+}
+
+// Finishes the game's row from its final position.
+// 
+// PRE: state is the final position of the game
+// POST: none
+void
+CorpusGame::endGame( const GameState& state )
+{
+    // The only player who can have reached the goal is the one with the highest score
+    winner = 0;
+    for ( int playerIndex = 1; playerIndex < state.getPlayerCount(); playerIndex++ )
+    {
+        if ( state.getPlayer( playerIndex ).getScore() > state.getPlayer( winner ).getScore() )
+        {
+            winner = playerIndex;
+        }
+    }
+    roundOffsets[ 1 ] = roundWinners.size();
+    moveOffsets[ 1 ] = moveTypes.size();
+}
+
+// Returns the game's rows, as a corpus of one game to append to a CorpusWriter.
+// 
+// PRE: endGame() has been called; the game must outlive the rows
+// POST: none
+CorpusColumns
+CorpusGame::getRows() const
+{
+    CorpusColumns rows;
+    rows.nGames = 1;
+    rows.nRounds = roundWinners.size();
+    rows.nMoves = moveTypes.size();
+    rows.seeds = &seed;
+    rows.streams = &stream;
+    rows.playerCounts = &playerCount;
+    rows.goalScores = &goalScore;
+    rows.winners = &winner;
+    rows.roundCounts = &roundCount;
+    rows.turnCounts = &turnCount;
+    rows.roundOffsets = roundOffsets;
+    rows.roundFirstCards = roundFirstCards.data();
+    rows.roundWinners = roundWinners.data();
+    rows.roundPoints = roundPoints.data();
+    rows.moveOffsets = moveOffsets;
+    rows.moveRounds = moveRounds.data();
+    rows.moveTurns = moveTurns.data();
+    rows.movePlayers = movePlayers.data();
+    rows.moveTypes = moveTypes.data();
+    rows.moveCards = moveCards.data();
+    rows.moveColors = moveColors.data();
+    rows.moveHandSizes = moveHandSizes.data();
+    return rows;
+}
+
+// Initializes a writer with no corpus open.
+// 
+// PRE: none
+// POST: none
+CorpusWriter::CorpusWriter()
+{
+    nGames = 0;
+    nRounds = 0;
+    nMoves = 0;
+    opened = false;
+}
+
+// Finishes the corpus, if one is open.
+// 
+// PRE: none
+// POST: none
+CorpusWriter::~CorpusWriter()
+{
+    close();
+}
+
+// Starts a new, empty corpus in the directory at the given path, creating the directory if necessary.
+// Any corpus already there is replaced. Returns false if the directory or its files cannot be created.
+// 
+// PRE: none
+// POST: if the return value is true, getGameCount() == 0
+bool
+CorpusWriter::open( const string& path )
+{
+    close();
+    directory = path;
+    mkdir( path.c_str(), 0777 );
+
+    // The meta file goes first, so the old corpus stops being readable before its columns are replaced
+    remove( ( directory + "/" + META_NAME ).c_str() );
+    for ( int column = 0; column < N_CORPUS_COLUMNS; column++ )
+    {
+        string columnPath = directory + "/" + COLUMN_NAMES[ column ];
+        remove( columnPath.c_str() );
+        if ( !columns[ column ].open( columnPath ) )
+        {
+            for ( int i = 0; i < column; i++ )
+            {
+                columns[ i ].close();
+            }
+            return false;
+        }
+    }
+
+    nGames = 0;
+    nRounds = 0;
+    nMoves = 0;
+    uint64_t firstOffset = 0;
+    columns[ CORPUS_ROUND_OFFSET ].write( &firstOffset, sizeof( firstOffset ) );
+    columns[ CORPUS_MOVE_OFFSET ].write( &firstOffset, sizeof( firstOffset ) );
+    opened = true;
+    return true;
+}
+
+// Appends the given games, with their rounds and moves, to the corpus. Their rows are copied as they are,
+// except for their round and move offsets, which are renumbered to follow the games already in the corpus.
+// 
+// PRE: a corpus is open; rows.roundOffsets[ rows.nGames ] - rows.roundOffsets[ 0 ] == rows.nRounds;
+//      rows.moveOffsets[ rows.nGames ] - rows.moveOffsets[ 0 ] == rows.nMoves
+// POST: getGameCount() increases by rows.nGames
+void
+CorpusWriter::append( const CorpusColumns& rows )
+{
+    // Assert the preconditions
+    assert( opened );
+    assert( rows.roundOffsets[ rows.nGames ] - rows.roundOffsets[ 0 ] == rows.nRounds );
+    assert( rows.moveOffsets[ rows.nGames ] - rows.moveOffsets[ 0 ] == rows.nMoves );
+
+    lock_guard< mutex > lock( appendMutex );
+    for ( int column = 0; column < N_CORPUS_COLUMNS; column++ )
+    {
+        if ( column == CORPUS_ROUND_OFFSET || column == CORPUS_MOVE_OFFSET )
+        {
+            // The first offset of the rows is already in the corpus, as the end of the last game
+            const uint64_t* offsets = column == CORPUS_ROUND_OFFSET ? rows.roundOffsets : rows.moveOffsets;
+            uint64_t base = column == CORPUS_ROUND_OFFSET ? nRounds : nMoves;
+            for ( uint64_t game = 1; game <= rows.nGames; game++ )
+            {
+                uint64_t offset = base + offsets[ game ] - offsets[ 0 ];
+                columns[ column ].write( &offset, sizeof( offset ) );
+            }
+        }
+        else if ( getRowCount( rows, column ) > 0 )
+        {
+            columns[ column ].write( getColumnData( rows, column ), getRowCount( rows, column ) * COLUMN_WIDTHS[ column ] );
+        }
+    }
+    nGames += rows.nGames;
+    nRounds += rows.nRounds;
+    nMoves += rows.nMoves;
+}
+
+// Finishes the corpus: closes every column, then writes the meta file, which makes the corpus readable.
+// Returns false if any of it could not be written, in which case the corpus cannot be opened.
+// 
+// PRE: none
+// POST: no corpus is open
+bool
+CorpusWriter::close()
+{
+    if ( !opened )
+    {
+        return true;
+    }
+    opened = false;
+
+    bool failed = false;
+    for ( int column = 0; column < N_CORPUS_COLUMNS; column++ )
+    {
+        columns[ column ].close();
+        failed |= columns[ column ].hasFailed();
+    }
+    if ( failed )
+    {
+        return false;
+    }
+
+    CorpusMeta meta = CorpusMeta();
+    meta.magic = CORPUS_MAGIC;
+    meta.version = CORPUS_VERSION;
+    meta.nColumns = N_CORPUS_COLUMNS;
+    meta.nGames = nGames;
+    meta.nRounds = nRounds;
+    meta.nMoves = nMoves;
+    FILE* file = fopen( ( directory + "/" + META_NAME ).c_str(), "wb" );
+    if ( file == NULL )
+    {
+        return false;
+    }
+    failed = fwrite( &meta, sizeof( meta ), 1, file ) != 1;
+    failed |= fclose( file ) != 0;
+    return !failed;
+}
+
+// Returns the number of games appended since the corpus was opened.
+// 
+// PRE: none
+// POST: none
+uint64_t
+CorpusWriter::getGameCount() const
+{
+    return nGames;
+}
+
+// Initializes a reader with no corpus open.
+// 
+// PRE: none
+// POST: getColumns().nGames == 0
+Corpus::Corpus()
+{
+    for ( int column = 0; column < N_CORPUS_COLUMNS; column++ )
+    {
+        mappings[ column ] = NULL;
+        mappingSizes[ column ] = 0;
+    }
+    view = CorpusColumns();
+}
+
+// Unmaps the corpus, if one is open.
+// 
+// PRE: none
+// POST: none
+Corpus::~Corpus()
+{
+    close();
+}
+
+// Maps every column of the corpus in the directory at the given path. Returns false if there is no finished corpus
+// there, or its files do not agree with its meta file.
+// 
+// PRE: none
+// POST: if the return value is false, getColumns().nGames == 0
+bool
+Corpus::open( const string& path )
+{
+    close();
+
+    // Read the meta file
+    CorpusMeta meta;
+    FILE* file = fopen( ( path + "/" + META_NAME ).c_str(), "rb" );
+    if ( file == NULL )
+    {
+        return false;
+    }
+    bool readMeta = fread( &meta, sizeof( meta ), 1, file ) == 1;
+    fclose( file );
+    if ( !readMeta || meta.magic != CORPUS_MAGIC || meta.version != CORPUS_VERSION || meta.nColumns != N_CORPUS_COLUMNS )
+    {
+        return false;
+    }
+    view.nGames = meta.nGames;
+    view.nRounds = meta.nRounds;
+    view.nMoves = meta.nMoves;
+
+    // Map each column, which must hold exactly the rows the meta file says
+    for ( int column = 0; column < N_CORPUS_COLUMNS; column++ )
+    {
+        int fd = ::open( ( path + "/" + COLUMN_NAMES[ column ] ).c_str(), O_RDONLY );
+        struct stat status;
+        size_t size = getRowCount( view, column ) * COLUMN_WIDTHS[ column ];
+        if ( fd < 0 || fstat( fd, &status ) != 0 || size_t( status.st_size ) != size )
+        {
+            if ( fd >= 0 )
+            {
+                ::close( fd );
+            }
+            close();
+            return false;
+        }
+
+        // An empty column has nothing to map
+        void* mapping = size > 0 ? mmap( NULL, size, PROT_READ, MAP_SHARED, fd, 0 ) : NULL;
+        ::close( fd );
+        if ( mapping == MAP_FAILED )
+        {
+            close();
+            return false;
+        }
+        mappings[ column ] = mapping;
+        mappingSizes[ column ] = size;
+        setColumnData( view, column, mapping );
+    }
+
+    return true;
+}
+
+// Unmaps every column of the corpus, if one is open. Pointers from getColumns() are no longer valid.
+// 
+// PRE: none
+// POST: getColumns().nGames == 0
+void
+Corpus::close()
+{
+    for ( int column = 0; column < N_CORPUS_COLUMNS; column++ )
+    {
+        if ( mappings[ column ] != NULL )
+        {
+            munmap( mappings[ column ], mappingSizes[ column ] );
+        }
+        mappings[ column ] = NULL;
+        mappingSizes[ column ] = 0;
+    }
+    view = CorpusColumns();
+}
+
+// Returns the columns of the corpus. They stay valid until the corpus is closed.
+// 
+// PRE: none
+// POST: none
+const CorpusColumns&
+Corpus::getColumns() const
+{
+    return view;
+}
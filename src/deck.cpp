@@ -1,6 +1,5 @@
 #include <algorithm>
 #include <assert.h>
-#include <cstdlib>
 #include <iostream>
 #include "card.hpp"
 #include "deck.hpp"
@@ -136,6 +135,20 @@ Deck::peek() const
     return cards[ size - 1 ];
 }
 
+// Returns the card at the given index, counting up from the bottom of the deck.
+// 
+// PRE: 0 <= index < size
+// POST: none
+Card
+Deck::getCardAt( int index ) const
+{
+    // Assert the preconditions
+    assert( 0 <= index );
+    assert( index < size );
+
+    return cards[ index ];
+}
+
 // Returns the current size of the deck.
 // 
 // PRE: none
@@ -176,16 +189,17 @@ Deck::clear()
     size = 0;
 }
 
-// Randomizes the order of cards in the deck.
+// Randomizes the order of cards in the deck using the given generator.
+// Every ordering is equally likely (a Fisher-Yates shuffle).
 // 
-// PRE: the random number generator should be seeded before calling shuffle()
+// PRE: none
 // POST: none
 void
-Deck::shuffle()
+Deck::shuffle( Random& random )
 {
-    // Iterate over the deck, swapping each card with another random card in the deck
-    for ( int i = 0; i < size; i++ )
+    // Working down from the top, swap each card with a random card at or below it
+    for ( int i = size - 1; i > 0; i-- )
     {
-        swap( cards[ i ], cards[ rand() % size] );
+        swap( cards[ i ], cards[ random.nextBelow( i + 1 ) ] );
     }
 }
@@ -0,0 +1,322 @@
+#include <algorithm>
+#include <new>
+#include <vector>
+#include "batch.hpp"
+#include "state.hpp"
+#include "uno_env.h"
+using namespace std;
+
+// The number of discards listed in the observation's history
+const int N_HISTORY_CARDS = UNO_OBS_SIZE - UNO_OBS_HISTORY;
+
+static_assert( UNO_MAX_TURNS_PER_ROUND == MAX_TURNS_PER_ROUND, "The C interface must abandon rounds where the programs do" );
+
+// The batch behind the C interface, and the scratch arrays each step fills
+struct UnoEnv
+{
+    BatchEngine engine;
+    vector< CardMask > playMasks;
+    vector< Move > moves;
+    vector< int > scoresBefore;
+
+    UnoEnv( int nGames, int nPlayers )
+        : engine( nGames, nPlayers ), playMasks( nGames ), moves( nGames ), scoresBefore( nGames )
+    {
+    }
+};
+
+// Returns the move the given action stands for in the given game, or sets legal to false if it is not legal there.
+// 
+// PRE: 0 <= game < the number of games; playMask is the game's mask from BatchEngine::legalPlayMasks()
+// POST: if legal is true, the move is one of the moves GameState::legalMoves() would list for the game
+static Move
+actionToMove( const BatchEngine& engine, int game, CardMask playMask, int action, bool& legal )
+{
+    int phase = engine.getPhase( game );
+    legal = true;
+
+    // Naming the first color is the only decision of its phase
+    if ( phase == FIRST_COLOR_PHASE )
+    {
+        legal = action >= UNO_ACTION_CHOOSE_COLOR && action < UNO_ACTION_CHOOSE_COLOR + N_COLORS;
+        return Move::chooseColor( action - UNO_ACTION_CHOOSE_COLOR );
+    }
+
+    // Drawing doubles as keeping the drawn card
+    if ( action == UNO_ACTION_DRAW )
+    {
+        return phase == DRAWN_CARD_PHASE ? Move::keepDrawn() : Move::drawCard();
+    }
+
+    // Every other action plays a card, which must be in the game's mask
+    Card card;
+    int color = NO_COLOR_INDEX;
+    if ( action >= UNO_ACTION_PLAY && action < UNO_ACTION_PLAY_WILD )
+    {
+        card = Card::fromId( action - UNO_ACTION_PLAY );
+    }
+    else if ( action >= UNO_ACTION_PLAY_WILD && action < UNO_ACTION_PLAY_DRAW4 )
+    {
+        card = Card( NO_COLOR_INDEX, WILD_INDEX );
+        color = action - UNO_ACTION_PLAY_WILD;
+    }
+    else if ( action >= UNO_ACTION_PLAY_DRAW4 && action < UNO_ACTION_DRAW )
+    {
+        card = Card( NO_COLOR_INDEX, DRAW4_WILD_INDEX );
+        color = action - UNO_ACTION_PLAY_DRAW4;
+    }
+    else
+    {
+        legal = false;
+        return Move::drawCard();
+    }
+
+    legal = ( playMask >> card.getId() ) & 1;
+    return phase == DRAWN_CARD_PHASE ? Move::playDrawn( card, color ) : Move::playCard( card, color );
+}
+
+// Fills values[ UNO_OBS_SIZE ] with the observation of the given game; see uno_env.h for the layout.
+// Every value is a small count or a flag, except the draw pile size and discard counts, which are clamped to maxValue.
+// 
+// PRE: 0 <= game < the number of games
+// POST: none
+template < class T >
+static void
+observeGame( const BatchEngine& engine, int game, int maxValue, T values[] )
+{
+    fill( values, values + UNO_OBS_SIZE, T( 0 ) );
+
+    // The player's own hand
+    int playerIndex = engine.getCurrentPlayerIndex( game );
+    for ( CardMask remaining = engine.getHandMask( game, playerIndex ); remaining != 0; remaining &= remaining - 1 )
+    {
+        int id = lowestCardId( remaining );
+        values[ UNO_OBS_HAND + id ] = min( engine.getHandCount( game, playerIndex, Card::fromId( id ) ), maxValue );
+    }
+
+    // The stock and the color named for it, if it is wild
+    Card stock = engine.getStock( game );
+    values[ UNO_OBS_STOCK + stock.getId() ] = 1;
+    values[ UNO_OBS_WILD_COLOR + ( stock.isWild() ? engine.getWildColor( game ) : NO_COLOR_INDEX ) ] = 1;
+
+    // The other hands' sizes, starting from the next seat
+    int nPlayers = engine.getPlayerCount();
+    for ( int offset = 1; offset < nPlayers; offset++ )
+    {
+        values[ UNO_OBS_OPPONENTS + offset - 1 ] = min( engine.getHandSize( game, ( playerIndex + offset ) % nPlayers ), maxValue );
+    }
+
+    // The turn state
+    values[ UNO_OBS_REVERSED ] = engine.isReversed( game );
+    values[ UNO_OBS_PHASE + engine.getPhase( game ) ] = 1;
+    values[ UNO_OBS_DRAW_SIZE ] = min( engine.getDrawSize( game ), maxValue );
+
+    // The discard pile, as counts and as the ids of its top cards
+    int discardSize = engine.getDiscardSize( game );
+    for ( int depth = 0; depth < discardSize; depth++ )
+    {
+        int id = engine.getDiscardCardAt( game, depth ).getId();
+        values[ UNO_OBS_DISCARDS + id ] = min( int( values[ UNO_OBS_DISCARDS + id ] ) + 1, maxValue );
+        if ( depth < N_HISTORY_CARDS )
+        {
+            values[ UNO_OBS_HISTORY + depth ] = 1 + id;
+        }
+    }
+}
+
+// Returns a new batch, or NULL if the arguments are out of range.
+// 
+// PRE: none
+// POST: the caller must free the return value with uno_env_destroy()
+UnoEnv*
+uno_env_create( int n_games, int n_players )
+{
+    if ( n_games < 1 || n_players < 2 || n_players > MAX_PLAYERS )
+    {
+        return NULL;
+    }
+
+    return new ( nothrow ) UnoEnv( n_games, n_players );
+}
+
+// Frees the given batch.
+// 
+// PRE: env was returned by uno_env_create() and has not been freed, or is NULL
+// POST: none
+void
+uno_env_destroy( UnoEnv* env )
+{
+    delete env;
+}
+
+// Returns the number of games in the batch.
+// 
+// PRE: env is a live batch
+// POST: return value >= 1
+int
+uno_env_game_count( const UnoEnv* env )
+{
+    return env->engine.getGameCount();
+}
+
+// Returns the number of seats in every game.
+// 
+// PRE: env is a live batch
+// POST: 2 <= return value <= MAX_PLAYERS
+int
+uno_env_player_count( const UnoEnv* env )
+{
+    return env->engine.getPlayerCount();
+}
+
+// Seeds every game from its own seed and deals it a new round.
+// 
+// PRE: env is a live batch; seeds has one seed per game
+// POST: every game's round has just begun
+void
+uno_env_reset( UnoEnv* env, const uint64_t* seeds )
+{
+    BatchEngine& engine = env->engine;
+    for ( int game = 0; game < engine.getGameCount(); game++ )
+    {
+        engine.seed( game, seeds[ game ], game );
+    }
+    engine.initializeRounds();
+}
+
+// Makes one action in every game, reports the rewards of the rounds that ended, and deals those games new rounds.
+// A round that reaches UNO_MAX_TURNS_PER_ROUND turns without a winner is abandoned unscored and dealt again, so a batch
+// can never be left stepping a stuck round forever.
+// 
+// PRE: env is a live batch that has been reset; actions has one action per game, rewards has room for one reward
+//      per seat of every game, and dones has room for one flag per game
+// POST: if the return value is -1, no game has changed and rewards and dones are unchanged
+int
+uno_env_step( UnoEnv* env, const int32_t* actions, float* rewards, uint8_t* dones )
+{
+    BatchEngine& engine = env->engine;
+    int nGames = engine.getGameCount();
+    int nPlayers = engine.getPlayerCount();
+
+    // Translate every action before stepping, so an illegal one leaves every game as it was
+    engine.legalPlayMasks( env->playMasks.data() );
+    for ( int game = 0; game < nGames; game++ )
+    {
+        bool legal;
+        env->moves[ game ] = actionToMove( engine, game, env->playMasks[ game ], actions[ game ], legal );
+        if ( !legal )
+        {
+            return -1;
+        }
+    }
+
+    engine.step( env->moves.data() );
+
+    // Score the rounds that ended, recording each winner's score first, since the rewards are the points each round moved
+    for ( int game = 0; game < nGames; game++ )
+    {
+        env->scoresBefore[ game ] = engine.roundIsOver( game ) ? engine.getScore( game, engine.getRoundWinnerIndex( game ) ) : 0;
+    }
+    engine.scoreRounds();
+    for ( int game = 0; game < nGames; game++ )
+    {
+        float* gameRewards = rewards + size_t( game ) * nPlayers;
+        if ( !engine.roundIsOver( game ) )
+        {
+            fill( gameRewards, gameRewards + nPlayers, 0.0f );
+            dones[ game ] = UNO_DONE_NONE;
+            if ( engine.getTurnNumber( game ) >= UNO_MAX_TURNS_PER_ROUND )
+            {
+                dones[ game ] = UNO_DONE_TRUNCATED;
+                engine.initializeRound( game );
+            }
+            continue;
+        }
+
+        int winnerIndex = engine.getRoundWinnerIndex( game );
+        for ( int playerIndex = 0; playerIndex < nPlayers; playerIndex++ )
+        {
+            gameRewards[ playerIndex ] = playerIndex == winnerIndex
+                ? engine.getScore( game, winnerIndex ) - env->scoresBefore[ game ]
+                : -engine.getHandScore( game, playerIndex );
+        }
+        dones[ game ] = UNO_DONE_ROUND_OVER;
+        engine.initializeRound( game );
+    }
+
+    return 0;
+}
+
+// Writes every game's observation as bytes.
+// 
+// PRE: env is a live batch that has been reset; obs has room for UNO_OBS_SIZE values per game
+// POST: none
+void
+uno_env_observe( const UnoEnv* env, int8_t* obs )
+{
+    for ( int game = 0; game < env->engine.getGameCount(); game++ )
+    {
+        observeGame( env->engine, game, INT8_MAX, obs + size_t( game ) * UNO_OBS_SIZE );
+    }
+}
+
+// Writes every game's observation as floats.
+// 
+// PRE: env is a live batch that has been reset; obs has room for UNO_OBS_SIZE values per game
+// POST: none
+void
+uno_env_observe_float( const UnoEnv* env, float* obs )
+{
+    for ( int game = 0; game < env->engine.getGameCount(); game++ )
+    {
+        observeGame( env->engine, game, TOTAL_CARDS, obs + size_t( game ) * UNO_OBS_SIZE );
+    }
+}
+
+// Writes the mask of legal actions of every game.
+// 
+// PRE: env is a live batch that has been reset; masks has room for UNO_N_ACTIONS flags per game
+// POST: none
+void
+uno_env_action_masks( const UnoEnv* env, uint8_t* masks )
+{
+    const BatchEngine& engine = env->engine;
+    int nGames = engine.getGameCount();
+    vector< CardMask > playMasks( nGames );
+    engine.legalPlayMasks( playMasks.data() );
+    for ( int game = 0; game < nGames; game++ )
+    {
+        uint8_t* gameMask = masks + size_t( game ) * UNO_N_ACTIONS;
+        fill( gameMask, gameMask + UNO_N_ACTIONS, uint8_t( 0 ) );
+        if ( engine.getPhase( game ) == FIRST_COLOR_PHASE )
+        {
+            fill( gameMask + UNO_ACTION_CHOOSE_COLOR, gameMask + UNO_ACTION_CHOOSE_COLOR + N_COLORS, uint8_t( 1 ) );
+            continue;
+        }
+
+        // Each colored card is one action, and each wild card is one action per color
+        CardMask playable = playMasks[ game ];
+        for ( int id = 0; id < FIRST_WILD_ID; id++ )
+        {
+            gameMask[ UNO_ACTION_PLAY + id ] = ( playable >> id ) & 1;
+        }
+        uint8_t wild = ( playable >> cardId( NO_COLOR_INDEX, WILD_INDEX ) ) & 1;
+        uint8_t draw4 = ( playable >> cardId( NO_COLOR_INDEX, DRAW4_WILD_INDEX ) ) & 1;
+        fill( gameMask + UNO_ACTION_PLAY_WILD, gameMask + UNO_ACTION_PLAY_WILD + N_COLORS, wild );
+        fill( gameMask + UNO_ACTION_PLAY_DRAW4, gameMask + UNO_ACTION_PLAY_DRAW4 + N_COLORS, draw4 );
+        gameMask[ UNO_ACTION_DRAW ] = 1;
+    }
+}
+
+// Writes the seat whose decision is pending in every game.
+// 
+// PRE: env is a live batch that has been reset; players has room for one seat per game
+// POST: none
+void
+uno_env_current_players( const UnoEnv* env, int32_t* players )
+{
+    for ( int game = 0; game < env->engine.getGameCount(); game++ )
+    {
+        players[ game ] = env->engine.getCurrentPlayerIndex( game );
+    }
+}
@@ -0,0 +1,301 @@
+#include <assert.h>
+#include <stddef.h>
+#include "events.hpp"
+#include "game.hpp"
+using namespace std;
+
+// Destroys the event sink.
+// 
+// PRE: none
+// POST: none
+GameEvents::~GameEvents()
+{
+}
+
+// Called for every card in every hand once a round has been dealt, before onFirstStock().
+// The hands are reported as they stand after the first stock's effect, so a first stock Draw2's cards are included.
+// 
+// PRE: none
+// POST: none
+void
+GameEvents::onDeal( const Game&, int, Card )
+{
+}
+
+// Called after the first stock of a round has been turned over and its effect applied to the first player.
+// 
+// PRE: none
+// POST: none
+void
+GameEvents::onFirstStock( const Game&, int, Card )
+{
+}
+
+// Called after a player draws a card on their turn.
+// 
+// PRE: none
+// POST: none
+void
+GameEvents::onDraw( const Game&, int, Card )
+{
+}
+
+// Called when a player wants to draw but neither pile has a card to spare, so their turn is skipped.
+// 
+// PRE: none
+// POST: none
+void
+GameEvents::onTableEmpty( const Game&, int )
+{
+}
+
+// Called after a player plays a card onto the discard pile, before its effect is reported.
+// 
+// PRE: none
+// POST: none
+void
+GameEvents::onPlay( const Game&, int, Card )
+{
+}
+
+// Called for each card a player draws because of a Draw2 or Draw4 Wild, before onDrawPenalty().
+// 
+// PRE: none
+// POST: none
+void
+GameEvents::onPenaltyCard( const Game&, int, Card )
+{
+}
+
+// Called after a player is made to draw nCards by a Draw2 or Draw4 Wild, of which nDrawn were actually available.
+// 
+// PRE: 0 <= nDrawn <= nCards
+// POST: none
+void
+GameEvents::onDrawPenalty( const Game&, int, int, int )
+{
+}
+
+// Called after the given player reverses the direction of play.
+// 
+// PRE: none
+// POST: none
+void
+GameEvents::onReverse( const Game&, int )
+{
+}
+
+// Called when the given player will be skipped.
+// 
+// PRE: none
+// POST: none
+void
+GameEvents::onSkip( const Game&, int )
+{
+}
+
+// Called after the given player picks the color of a wild card.
+// 
+// PRE: 0 <= color < N_COLORS
+// POST: none
+void
+GameEvents::onColorChosen( const Game&, int, int )
+{
+}
+
+// Called when the draw pile has run out and every discard but the stock is about to become the new draw pile.
+// 
+// PRE: none
+// POST: none
+void
+GameEvents::onReshuffle( const Game& )
+{
+}
+
+// Called after a round is scored, with the winner and the points they scored.
+// 
+// PRE: points >= 0
+// POST: none
+void
+GameEvents::onRoundScored( const Game&, int, int )
+{
+}
+
+// Initializes a fanout with no sinks.
+// 
+// PRE: none
+// POST: events will go nowhere until a sink is added
+EventFanout::EventFanout()
+{
+    nSinks = 0;
+}
+
+// Adds a sink to forward every event to.
+// 
+// PRE: sink != NULL; fewer than MAX_EVENT_SINKS sinks have been added; sink must outlive the fanout
+// POST: sink will receive every event after the sinks added before it
+void
+EventFanout::add( GameEvents* sink )
+{
+    // Assert the preconditions
+    assert( sink != NULL );
+    assert( nSinks < MAX_EVENT_SINKS );
+
+    sinks[ nSinks++ ] = sink;
+}
+
+// Forwards the onDeal event to every sink.
+// 
+// PRE: none
+// POST: none
+void
+EventFanout::onDeal( const Game& game, int playerIndex, Card card )
+{
+    for ( int sinkIndex = 0; sinkIndex < nSinks; sinkIndex++ )
+    {
+        sinks[ sinkIndex ]->onDeal( game, playerIndex, card );
+    }
+}
+
+// Forwards the onFirstStock event to every sink.
+// 
+// PRE: none
+// POST: none
+void
+EventFanout::onFirstStock( const Game& game, int playerIndex, Card stock )
+{
+    for ( int sinkIndex = 0; sinkIndex < nSinks; sinkIndex++ )
+    {
+        sinks[ sinkIndex ]->onFirstStock( game, playerIndex, stock );
+    }
+}
+
+// Forwards the onDraw event to every sink.
+// 
+// PRE: none
+// POST: none
+void
+EventFanout::onDraw( const Game& game, int playerIndex, Card card )
+{
+    for ( int sinkIndex = 0; sinkIndex < nSinks; sinkIndex++ )
+    {
+        sinks[ sinkIndex ]->onDraw( game, playerIndex, card );
+    }
+}
+
+// Forwards the onTableEmpty event to every sink.
+// 
+// PRE: none
+// POST: none
+void
+EventFanout::onTableEmpty( const Game& game, int playerIndex )
+{
+    for ( int sinkIndex = 0; sinkIndex < nSinks; sinkIndex++ )
+    {
+        sinks[ sinkIndex ]->onTableEmpty( game, playerIndex );
+    }
+}
+
+// Forwards the onPlay event to every sink.
+// 
+// PRE: none
+// POST: none
+void
+EventFanout::onPlay( const Game& game, int playerIndex, Card card )
+{
+    for ( int sinkIndex = 0; sinkIndex < nSinks; sinkIndex++ )
+    {
+        sinks[ sinkIndex ]->onPlay( game, playerIndex, card );
+    }
+}
+
+// Forwards the onPenaltyCard event to every sink.
+// 
+// PRE: none
+// POST: none
+void
+EventFanout::onPenaltyCard( const Game& game, int playerIndex, Card card )
+{
+    for ( int sinkIndex = 0; sinkIndex < nSinks; sinkIndex++ )
+    {
+        sinks[ sinkIndex ]->onPenaltyCard( game, playerIndex, card );
+    }
+}
+
+// Forwards the onDrawPenalty event to every sink.
+// 
+// PRE: none
+// POST: none
+void
+EventFanout::onDrawPenalty( const Game& game, int playerIndex, int nCards, int nDrawn )
+{
+    for ( int sinkIndex = 0; sinkIndex < nSinks; sinkIndex++ )
+    {
+        sinks[ sinkIndex ]->onDrawPenalty( game, playerIndex, nCards, nDrawn );
+    }
+}
+
+// Forwards the onReverse event to every sink.
+// 
+// PRE: none
+// POST: none
+void
+EventFanout::onReverse( const Game& game, int playerIndex )
+{
+    for ( int sinkIndex = 0; sinkIndex < nSinks; sinkIndex++ )
+    {
+        sinks[ sinkIndex ]->onReverse( game, playerIndex );
+    }
+}
+
+// Forwards the onSkip event to every sink.
+// 
+// PRE: none
+// POST: none
+void
+EventFanout::onSkip( const Game& game, int playerIndex )
+{
+    for ( int sinkIndex = 0; sinkIndex < nSinks; sinkIndex++ )
+    {
+        sinks[ sinkIndex ]->onSkip( game, playerIndex );
+    }
+}
+
+// Forwards the onColorChosen event to every sink.
+// 
+// PRE: none
+// POST: none
+void
+EventFanout::onColorChosen( const Game& game, int playerIndex, int color )
+{
+    for ( int sinkIndex = 0; sinkIndex < nSinks; sinkIndex++ )
+    {
+        sinks[ sinkIndex ]->onColorChosen( game, playerIndex, color );
+    }
+}
+
+// Forwards the onReshuffle event to every sink.
+// 
+// PRE: none
+// POST: none
+void
+EventFanout::onReshuffle( const Game& game )
+{
+    for ( int sinkIndex = 0; sinkIndex < nSinks; sinkIndex++ )
+    {
+        sinks[ sinkIndex ]->onReshuffle( game );
+    }
+}
+
+// Forwards the onRoundScored event to every sink.
+// 
+// PRE: none
+// POST: none
+void
+EventFanout::onRoundScored( const Game& game, int playerIndex, int points )
+{
+    for ( int sinkIndex = 0; sinkIndex < nSinks; sinkIndex++ )
+    {
+        sinks[ sinkIndex ]->onRoundScored( game, playerIndex, points );
+    }
+}
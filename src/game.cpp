@@ -4,184 +4,83 @@
 #include "game.hpp"
 using namespace std;
 
-// Initializes a Game with the given players and goal score.
+// Initializes a Game with the given players, the agents that make their decisions, the goal score,
+// and an optional event sink.
 // 
-// PRE: p should be of size nP
-//      2 <= nP <= MAX_PLAYERS
-//      gS >= 1
-// POST: 
-Game::Game( string playerNames[], int nPlayers )
+// PRE: playerNames and playerAgents should be of size nPlayers
+//      2 <= nPlayers <= MAX_PLAYERS
+//      goalScore >= 1
+//      every agent must outlive the game; the same agent may be used for several players
+// POST: if gameEvents is NULL, nothing that happens in the game will be reported
+Game::Game( string playerNames[], PlayerAgent* playerAgents[], int nPlayers, int goalScore, GameEvents* gameEvents )
+    : state( nPlayers, goalScore )
 {
-    // Assert the preconditions
-    assert( nPlayers >= 2 );
-    assert( nPlayers <= MAX_PLAYERS );
-
-    // Foo* pFoo = new Foo();
-    // (*pFoo).counter ++;
-    // pFoo->counter++;
+    events = gameEvents;
 
-    // Initialize nPlayers
-    this->nPlayers = nPlayers;
-    
-    // Copy players to the players array
+    // Copy the players' names and their agents to the names and agents arrays
     for ( int playerIndex = 0; playerIndex < nPlayers; playerIndex++ )
     {
-        players[ playerIndex ] = Player( playerNames[ playerIndex ] );
+        assert( playerAgents[ playerIndex ] != NULL );
+
+        names[ playerIndex ] = playerNames[ playerIndex ];
+        agents[ playerIndex ] = playerAgents[ playerIndex ];
     }
 }
 
-// Prompts for a valid color (red, yellow, green, or blue) for a wild card.
+// Seeds the random number generator used to shuffle the deck.
+// A game is fully determined by its seed, stream, and the decisions of its players.
 // 
 // PRE: none
-// POST: 0 <= return value <= 3
-int
-Game::getColorInput() const
+// POST: none
+void
+Game::seed( uint64_t seedValue, uint64_t stream )
 {
-    // Prompt until a valid color is entered, at which point the function will return
-    while (true)
-    {
-        // Prompt for the color of the wild card
-        cout << "Choose a color for your wild card (r, y, g, b): ";
-        string color;
-        getline( cin, color);
-        if ( color.size() == 1 )
-        {
-            // If just one character was entered, get the int corresponding to the character
-            // It may better to iterate over the colors array, but this would probably be slower
-            switch ( color.at( 0 ) )
-            {
-                case 'r':
-                    return 0;
-                case 'y':
-                    return 1;
-                case 'g':
-                    return 2;
-                case 'b':
-                    return 3;
-                default:
-                    // A character other than r, y, g, or b was entered, so print an error and re-prompt
-                    cout << "Please enter r, y, g, or b." << endl;
-                    break;
-            }
-        }
-        else
-        {
-            // More than one character was entered, so print an error and re-prompt
-            cout << "Please enter just one character (r, y, g, or b)." << endl;
-        }
-    }
+    state.seed( seedValue, stream );
 }
 
-// Initializes the game for a round.
+// Sets whether the deck is shuffled lazily, one card per draw, rather than all at once at the start of each round.
+// See Table::setLazyShuffle().
 // 
 // PRE: none
-// POST: table, currentPlayerIndex, reverse, skip, and wildColor will be initialized
-//       all players' hands will be cleared and they will be dealt new cards
+// POST: none
 void
-Game::initializeRound()
+Game::setLazyShuffle( bool lazy )
 {
-    // Initialize fields
-    table.initialize();
-    currentPlayerIndex = 0;
-    reverse = false;
-    skip = false;
-    wildColor = NO_COLOR_INDEX;
-
-    // Empty each player's hand
-    for ( int playerIndex = 0; playerIndex < nPlayers; playerIndex++ )
-    {
-        players[ playerIndex ].getHand().clear();
-    }
-
-    // Deal cards to each player
-    for ( int card = 0; card < STARTING_HAND_SIZE; card++ )
-    {
-        for ( int playerIndex = 0; playerIndex < nPlayers; playerIndex++ )
-        {
-            players[ playerIndex ].drawCard( table );
-        }
-    }
-
-    // Apply the effects of the stock to the first player
-    // Optimally, processCardAction() would be used for this, but it depends on other variables initialized in this function
-    Player& firstPlayer = players[ 0 ];
-    switch ( table.getStock().getValue() )
-    {
-        // First player draws 2 cards
-        case DRAW2_INDEX:
-            firstPlayer.drawCards( 2, table );
-            cout << endl;
-            cout << "The first stock is a Draw2, so " << firstPlayer.getName() << " draws 2 cards." << endl;
-            break;
-        // Play is reversed following the first player's turn
-        case REVERSE_INDEX:
-            reverse = !reverse;
-            cout << endl;
-            cout << "The first stock is a Reverse, so the direction of play starts reversed." << endl;
-            break;
-        // First player is skipped
-        case SKIP_INDEX:
-            skip = true;
-            cout << endl;
-            cout << "The first stock is a Skip, so " << firstPlayer.getName() << " is skipped." << endl;
-            break;
-        // First player may choose the color of the Wild card
-        case WILD_INDEX:
-            cout << endl;
-            cout << "The first stock is a Wild card, so " << firstPlayer.getName() << " will pick its color." << endl;
-            cout << "Your Hand: ";
-            firstPlayer.getHand().printContents();
-            cout << endl;
-            wildColor = getColorInput();
-            break;
-    }
+    state.setLazyShuffle( lazy );
 }
 
-// Returns the player who will take their turn next.
+// Initializes the game for a round and reports the effect of the first stock.
+// If the first stock is a Wild card, the first player's agent is asked for its color right away,
+// so the color is known before their turn begins.
 // 
-// PRE: the round should have been initialized
-// POST: none
-int
-Game::getNextPlayerIndex() const
+// PRE: none
+// POST: all players' hands will be cleared and they will be dealt new cards
+//       getPhase() == PLAY_PHASE
+void
+Game::initializeRound()
 {
-    // Determine the player increment (the difference between the current player's index and the next player's)
-    int playerIncrement = reverse ? -1 : 1;
-    int nextPlayerIndex = currentPlayerIndex + playerIncrement;
-    if ( skip )
+    state.initializeRound();
+    if ( events != NULL )
     {
-        // To skip the player who would normally be next, just increment one more time
-        nextPlayerIndex += playerIncrement;
-    }
-
-    // If nextPlayerIndex is negative, manually wrap it by adding nPlayers
-    if ( nextPlayerIndex < 0 )
-    {
-        while ( nextPlayerIndex < 0 )
+        for ( int playerIndex = 0; playerIndex < getPlayerCount(); playerIndex++ )
         {
-            nextPlayerIndex += nPlayers;
+            const Hand& hand = state.getPlayer( playerIndex ).getHand();
+            for ( int cardIndex = 0; cardIndex < hand.getSize(); cardIndex++ )
+            {
+                events->onDeal( *this, playerIndex, hand.getCardAt( cardIndex ) );
+            }
         }
+        events->onFirstStock( *this, 0, state.getStock() );
     }
-    // If nextPlayerIndex is positive, simply wrap it with a mod operation
-    else
+
+    if ( state.getPhase() == FIRST_COLOR_PHASE )
     {
-        nextPlayerIndex %= nPlayers;
+        MoveList moves;
+        legalMoves( moves );
+        apply( agents[ 0 ]->chooseMove( *this, moves ) );
     }
-
-    return nextPlayerIndex;
 }
 
-// Sets the current player to the next player in the turn sequence.
-// 
-// PRE: round should be initialized
-// POST: skip will be set to false
-void
-Game::nextPlayer()
-{
-    currentPlayerIndex = getNextPlayerIndex();
-    skip = false;
-}
-
-
 // Prints a header for the current player, containing pertinent information for their turn.
 // 
 // PRE: round should be initialized
@@ -189,31 +88,31 @@ Game::nextPlayer()
 void
 Game::printTurnHeader() const
 {
-    // Define convenience variables (no references)
-    Player player = players[ currentPlayerIndex ];
+    // Define convenience variables
+    int currentPlayerIndex = state.getCurrentPlayerIndex();
+    const Player& player = state.getPlayer( currentPlayerIndex );
 
     // Print whose turn it is and who the next player is
-    cout << "*** " << player.getName() << "'s Turn ***" << endl;
-    cout << "Next Player: " << players[ getNextPlayerIndex() ].getName() << endl;
+    cout << "*** " << names[ currentPlayerIndex ] << "'s Turn ***" << endl;
+    cout << "Next Player: " << names[ state.getNextPlayerIndex() ] << endl;
 
     // Print the number of cards each player has remaining
     cout << "Cards Remaining:";
-    for ( int i = 0; i < nPlayers; i++ )
+    for ( int i = 0; i < state.getPlayerCount(); i++ )
     {
         if ( i != currentPlayerIndex )
         {
-            Player p = players[ i ];
-            cout << " " << p.getHand().getSize() << " ( " << p.getName() << " )";
+            cout << " " << state.getPlayer( i ).getHand().getSize() << " ( " << names[ i ] << " )";
         }
     }
     cout << endl;
 
     // Print the stock and its color if it's wild
-    Card stock = table.getStock();
+    Card stock = state.getStock();
     cout << "Stock: " << stock.toStringLong() << " ( " << stock.toStringShort() << " )";
     if ( stock.isWild() )
     {
-        cout << " ( " << COLOR_STRINGS[ wildColor ] << " )";
+        cout << " ( " << COLOR_STRINGS[ state.getWildColor() ] << " )";
     }
     cout << endl;
 
@@ -223,240 +122,148 @@ Game::printTurnHeader() const
     cout << endl;
 }
 
-// Draws a card for the current player, if possible, and prompts them if they want to play it.
+// Processes the current player's turn, asking their agent for moves until the turn is over.
 // 
-// PRE: the round should be initialized
-// POST: the current player will draw a card from the table, if possible, and potentially play it
+// PRE: round should be initialized
+// POST: the player will either:
+//       -draw,
+//       -draw and play the drawn card,
+//       -fail to draw (because the table is empty), or
+//       -play from their hand
+//       if the round is not over, the next player will be the current player
 void
-Game::drawCard()
+Game::processPlayerTurn()
 {
-    // Define convenience variables
-    Player& player = players[ currentPlayerIndex ];
-
-    // If possible, draw a card
-    if ( table.canDrawCard() )
+    int turn = state.getTurnNumber();
+    MoveList moves;
+    while ( state.getTurnNumber() == turn )
     {
-        Card card = player.drawCard( table );
-        cout << "You drew a " << card.toStringLong() + "." << endl;
-
-        // If the player can play the card, prompt to see if they want to play it (default is yes)
-        if ( card.canPlayOn( table.getStock(), wildColor ) )
-        {
-            cout << "Play it? (Y/n) ";
-            string input;
-            getline( cin, input );
-
-            // If the player chooses to play the card, play it
-            if ( input != "n" && input != "N" )
-            {
-                player.playCard( card, table, wildColor );
-                processCardAction( card );
-            }
-        }
-    }
-    // If the table is empty, the player won't be able to draw a card, so print a message
-    else
-    {
-        cout << endl;
-        cout << "The draw and discard piles are empty, so your turn is skipped." << endl;
+        legalMoves( moves );
+        apply( agents[ state.getCurrentPlayerIndex() ]->chooseMove( *this, moves ) );
     }
 }
 
-// Prompts for a valid card for the current player to play.
+// Fills the given list with every move the current player may make.
+// See GameState::legalMoves().
 // 
-// PRE: the round should be initialized
-// POST: return value will be a valid card for the current player to play
-//       the game will not change
-Card
-Game::getCardInput() const
+// PRE: round should be initialized and not over
+// POST: moves will not be empty
+void
+Game::legalMoves( MoveList& moves ) const
 {
-    // Define convenience variables (no references)
-    Player player = players[ currentPlayerIndex ];
-    Hand hand = player.getHand();
-    Card stock = table.getStock();
-
-    // Will continue until valid input is received, upon which the method will return
-    while ( true )
-    {
-        // Prompt the player for the card to play
-        string cardString;
-        cout << "Choose a card to play: ";
-        getline( cin, cardString );
-        int cardIndex = player.getHand().findString( cardString );
-
-        // The card was not found in the player's hand, so print an error
-        if ( cardIndex == -1 )
-        {
-            cout << "You do not have the card \"" << cardString << "\" in your hand." << endl;
-            cout << "Enter one of the cards in your hand, as listed above." << endl;
-            cout << endl;
-        }
-        // The player entered a valid card, so check if it can be played
-        else
-        {
-            Card card = hand.getCardAt( cardIndex );
-            
-            // If this card cannot be played on the stock, it is not valid
-            if ( !card.canPlayOn( stock, wildColor ) )
-            {
-                cout << "You cannot play a " << card.toStringLong() << " on a " << stock.toStringLong() << "." << endl;
-                cout << "Either the color or the value must match." << endl;
-                cout << endl;
-            }
-            // This card is valid, so return it
-            else
-            {
-                return card;
-            }
-        }
-    }
+    state.legalMoves( moves );
 }
 
-// Makes the given player draw up to the given number of cards and print a message.
+// Returns true if the current player may play the given card from their hand.
 // 
-// PRE: nCards >= 0; round should be initialized
-// POST: the given player will draw at most the given number of cards
-void
-Game::drawUpTo( Player& player, int nCards )
+// PRE: round should be initialized; getPhase() == PLAY_PHASE
+// POST: none
+bool
+Game::isLegalPlay( Card card ) const
 {
-    assert( nCards >= 0 );
+    return state.isLegalPlay( card );
+}
 
-    // If the number of cards to draw is 0, return without drawing anything
-    if ( nCards == 0 )
+// Makes the given move for the current player and reports what happened to the event sink.
+// See GameState::apply().
+// 
+// PRE: round should be initialized and not over; move must be one of the moves listed by legalMoves()
+// POST: if the turn ended and the round is not over, the next player is the current player
+UndoRecord
+Game::apply( Move move )
+{
+    UndoRecord record = state.apply( move );
+    if ( events != NULL )
     {
-        return;
+        reportMove( record );
     }
 
-    // If the number of cards on the table is less than the number of cards specified, draw all the cards on the table
-    int maxCards = min( table.getTotalCards() - 1, nCards );
-    player.drawCards( maxCards, table );
-
-    // Print a message corresponding to the number of cards drawn
-    if ( maxCards == 0 )
-    {
-        cout << "The table is empty, so " << player.getName() << " draws no cards." << endl;
-    }
-    else if ( maxCards == 1 )
-    {
-        if ( nCards == 1 )
-        {
-            cout << player.getName() << " draws 1 card." << endl;
-        }
-        else
-        {
-            cout << player.getName() << " draws 1 card, but there are not enough cards on the table to draw up to " << nCards << "." << endl;
-        }
-    }
-    else if ( maxCards < nCards )
-    {
-        cout << player.getName() << " draws " << maxCards << " cards, but there are not enough cards on the table to draw up to " << nCards << "." << endl;
-    }
-    else
-    {
-        cout << player.getName() << " draws " << nCards << " cards." << endl;
-    }
+    return record;
 }
 
-// Processes the action of the given card as if the current player played it.
+// Takes back the given move without reporting anything. See GameState::undo().
 // 
-// PRE: round should be initialized
-// POST: 
+// PRE: record was returned by the most recent apply() that has not been undone
+// POST: the game will be exactly as it was before that apply()
 void
-Game::processCardAction( Card card )
+Game::undo( const UndoRecord& record )
 {
-    // If the card is an action card, process its effect and print a message
-    // maxCards and nextPlayer must be initialized here, otherwise the jump to later case labels crosses their initialization
-    Player& nextPlayer = players[ getNextPlayerIndex() ] ;
-    switch ( card.getValue() )
-    {
-        // Make the next player draw 2 cards
-        // The official rules say that this also skips the next player, but the spec does not mention this
-        case DRAW2_INDEX:
-            drawUpTo( nextPlayer, 2 );
-            break;
-        // Reverse the direction of play
-        case REVERSE_INDEX:
-            reverse = !reverse;
-            cout << "The direction of play has been reversed." << endl;
-            break;
-        // Skip the next player
-        case SKIP_INDEX:
-            skip = true;
-            cout << nextPlayer.getName() << " is skipped." << endl;
-            break;
-        // Choose a color
-        case WILD_INDEX:
-            wildColor = getColorInput();
-            break;
-        // Choose a color and make the next player draw 4 cards
-        // The official rules say that this also skips the next player, but the spec does not mention this
-        case DRAW4_WILD_INDEX:
-            wildColor = getColorInput();
-            drawUpTo( nextPlayer, 4 );
-    }
+    state.undo( record );
 }
 
-// Processes the current player's turn, including input, drawing, and playing.
+// Reports the events of a move that was just applied.
+// Everything worth reporting can be read back from the move's undo record, so the rules never need to know about the sink.
 // 
-// PRE: round should be initialized
-// POST: the player will either:
-//       -draw,
-//       -draw and play the drawn card,
-//       -fail to draw (because the table is empty), or
-//       -play from their hand
+// PRE: events != NULL; record was returned by the most recent apply()
+// POST: none
 void
-Game::processPlayerTurn()
+Game::reportMove( const UndoRecord& record ) const
 {
     // Define convenience variables
-    Player& player = players[ currentPlayerIndex ];
-    Hand& hand = player.getHand();
-    string junk;
+    Move move = record.move;
+    int playerIndex = record.playerIndex;
 
-    // Check to see if the player can play any card
-    bool canPlay = false;
-    for ( int cardIndex = 0; cardIndex < player.getHand().getSize(); cardIndex++ )
-    {
-        if ( hand.getCardAt( cardIndex ).canPlayOn( table.getStock(), wildColor ) )
-        {
-            canPlay = true;
-            break;
-        }
-    }
+    // The move drew more cards than the draw pile held, so the discard pile was shuffled in before its draws
+    bool reshuffled = record.nDrawn > record.table.drawSize;
 
-    // If the player cannot play, automatically draw for them
-    if ( !canPlay )
-    {
-        cout << "You have no plays available. Press enter to draw a card.";
-        getline( cin, junk );
-        drawCard();
-    }
-    // If the player can play, prompt to see if they want to draw
-    else
+    switch ( move.getType() )
     {
-        cout << "Draw a card? (y/N) ";
-        string input;
-        getline( cin, input );
-
-        // If the player chooses to draw a card, they will draw and not play from their hand
-        if ( input == "y" || input == "Y" )
-        {
-            drawCard();
-        }
-        // If the player chooses not to draw, they will choose a card from their hand to play
-        else
+        case DRAW_CARD:
+            if ( record.nDrawn == 0 )
+            {
+                events->onTableEmpty( *this, playerIndex );
+            }
+            else
+            {
+                if ( reshuffled )
+                {
+                    events->onReshuffle( *this );
+                }
+                events->onDraw( *this, playerIndex, record.drawn[ 0 ] );
+            }
+            break;
+        case CHOOSE_COLOR:
+            events->onColorChosen( *this, playerIndex, move.getColor() );
+            break;
+        case PLAY_CARD:
+        case PLAY_DRAWN:
         {
-            // Prompt for a valid card to play
-            Card card = getCardInput();
-            
-            // Play the card
-            player.playCard( card, table, wildColor );
-
-            // Print a message for other players to reference
-            cout << endl;
-            cout << player.getName() << " plays a " << card.toStringLong() << "." << endl;
-            
-            // Process the effect of the card, if any
-            processCardAction( card );
+            Card card = move.getCard();
+            events->onPlay( *this, playerIndex, card );
+            if ( card.isWild() )
+            {
+                events->onColorChosen( *this, playerIndex, move.getColor() );
+            }
+
+            // Report the effect of the card on the player it targeted
+            if ( reshuffled )
+            {
+                events->onReshuffle( *this );
+            }
+            switch ( card.getValue() )
+            {
+                case DRAW2_INDEX:
+                    for ( int draw = 0; draw < record.nDrawn; draw++ )
+                    {
+                        events->onPenaltyCard( *this, record.targetIndex, record.drawn[ draw ] );
+                    }
+                    events->onDrawPenalty( *this, record.targetIndex, 2, record.nDrawn );
+                    break;
+                case REVERSE_INDEX:
+                    events->onReverse( *this, playerIndex );
+                    break;
+                case SKIP_INDEX:
+                    events->onSkip( *this, record.targetIndex );
+                    break;
+                case DRAW4_WILD_INDEX:
+                    for ( int draw = 0; draw < record.nDrawn; draw++ )
+                    {
+                        events->onPenaltyCard( *this, record.targetIndex, record.drawn[ draw ] );
+                    }
+                    events->onDrawPenalty( *this, record.targetIndex, 4, record.nDrawn );
+                    break;
+            }
+            break;
         }
     }
 }
@@ -468,67 +275,43 @@ Game::processPlayerTurn()
 bool
 Game::roundIsOver() const
 {
-    // Iterate through each player
-    for ( int playerIndex = 0; playerIndex < nPlayers; playerIndex++ )
-    {
-        // If this player's hand is empty, they have won the round
-        Player player = players[ playerIndex ];
-        if ( player.getHand().isEmpty() )
-        {
-            return true;
-        }
-    }
-
-    return false;
+    return state.roundIsOver();
 }
 
-// Returns the winner of the current round.
+// Returns the index of the winner of the current round.
 // 
 // PRE: the round must be over
-// POST: none
-Player&
-Game::getRoundWinner()
+// POST: 0 <= return value < getPlayerCount()
+int
+Game::getRoundWinnerIndex() const
 {
-    // Assert the preconditions
-    assert( roundIsOver() );
-
-    // Iterate through each player
-    for ( int playerIndex = 0; playerIndex < nPlayers; playerIndex++ )
-    {
-        // If this player's hand is empty, they have won the round
-        Player& player = players[ playerIndex ];
-        if ( player.getHand().isEmpty() )
-        {
-            return player;
-        }
-    }
-
-    // Because the round is over, this should not be reached
-    assert( false );
+    return state.getRoundWinnerIndex();
 }
 
-// Increases the winner's score by the sum of their opponents' cards.
+// Increases the winner's score by the sum of their opponents' cards, and reports the points they scored.
 // 
 // PRE: the round must be over
 // POST: none
 void
 Game::scoreRound()
 {
-    // Assert the preconditions
-    assert( roundIsOver() );
-
-    Player& winner = getRoundWinner();
-
-    // Iterate through each player and add their hand's score to the round score
-    // The winner's score will be 0, so it doesn't matter that their hand is included
-    int roundScore = 0;
-    for ( int playerIndex = 0; playerIndex < nPlayers; playerIndex++ )
+    int winnerIndex = state.getRoundWinnerIndex();
+    int scoreBefore = state.getPlayer( winnerIndex ).getScore();
+    state.scoreRound();
+    if ( events != NULL )
     {
-        roundScore += players[ playerIndex ].getHand().getScore();
+        events->onRoundScored( *this, winnerIndex, state.getPlayer( winnerIndex ).getScore() - scoreBefore );
     }
+}
 
-    // Increase the winner's score
-    winner.setScore( winner.getScore() + roundScore );
+// Returns true if any player has reached the goal score.
+// 
+// PRE: none
+// POST: none
+bool
+Game::gameIsOver() const
+{
+    return state.gameIsOver();
 }
 
 // Prints the scores of each player, sorted in descending order.
@@ -540,6 +323,7 @@ Game::printScores() const
 {
     // Create a ranks array and populate it with each possible player index in ascending order
     // The players array cannot be changed as its order determines the turn order
+    int nPlayers = state.getPlayerCount();
     int ranks[ nPlayers ];
     for ( int i = 0; i < nPlayers; i++ )
     {
@@ -550,7 +334,7 @@ Game::printScores() const
     for ( int i = 0; i < nPlayers; i++ )
     {
         int j = i;
-        while ( j > 0 && players[ ranks[ j - 1 ] ].getScore() > players[ ranks[ j ] ].getScore() )
+        while ( j > 0 && state.getPlayer( ranks[ j - 1 ] ).getScore() > state.getPlayer( ranks[ j ] ).getScore() )
         {
             int swap = ranks[ j ];
             ranks[ j ] = ranks[ j - 1 ];
@@ -562,7 +346,111 @@ Game::printScores() const
     // Print the players and their scores from highest (best) to lowest (worst) score
     for ( int rank = nPlayers - 1; rank >= 0; rank-- )
     {
-        Player player = players[ ranks[ rank ] ];
-        cout << rank + 1 << ". " << player.getName() << " ( " << player.getScore() << " )" << endl;
+        int playerIndex = ranks[ rank ];
+        cout << rank + 1 << ". " << names[ playerIndex ] << " ( " << state.getPlayer( playerIndex ).getScore() << " )" << endl;
     }
 }
+
+// Returns the state of the game, which can be copied to search or park the game without its names and agents.
+// 
+// PRE: none
+// POST: none
+const GameState&
+Game::getState() const
+{
+    return state;
+}
+
+// Returns the name of the player at the given index.
+// 
+// PRE: 0 <= playerIndex < getPlayerCount()
+// POST: none
+string
+Game::getPlayerName( int playerIndex ) const
+{
+    // Assert the preconditions
+    assert( playerIndex >= 0 );
+    assert( playerIndex < state.getPlayerCount() );
+
+    return names[ playerIndex ];
+}
+
+// Returns the number of players in the game.
+// 
+// PRE: none
+// POST: 2 <= return value <= MAX_PLAYERS
+int
+Game::getPlayerCount() const
+{
+    return state.getPlayerCount();
+}
+
+// Returns the index of the player whose turn it is.
+// 
+// PRE: round should be initialized
+// POST: 0 <= return value < getPlayerCount()
+int
+Game::getCurrentPlayerIndex() const
+{
+    return state.getCurrentPlayerIndex();
+}
+
+// Returns the player at the given index.
+// 
+// PRE: 0 <= playerIndex < getPlayerCount()
+// POST: none
+const Player&
+Game::getPlayer( int playerIndex ) const
+{
+    return state.getPlayer( playerIndex );
+}
+
+// Returns the top card of the discard pile.
+// 
+// PRE: round should be initialized
+// POST: none
+Card
+Game::getStock() const
+{
+    return state.getStock();
+}
+
+// Returns the color chosen for the most recent wild card, or NO_COLOR_INDEX if none has been chosen this round.
+// 
+// PRE: round should be initialized
+// POST: 0 <= return value < N_COLORS, or return value == NO_COLOR_INDEX
+int
+Game::getWildColor() const
+{
+    return state.getWildColor();
+}
+
+// Returns true if the direction of play is currently reversed.
+// 
+// PRE: round should be initialized
+// POST: none
+bool
+Game::isReversed() const
+{
+    return state.isReversed();
+}
+
+// Returns the kind of decision the current player must make next.
+// 
+// PRE: round should be initialized
+// POST: return value is a GamePhase
+int
+Game::getPhase() const
+{
+    return state.getPhase();
+}
+
+// Returns the card the current player just drew.
+// 
+// PRE: getPhase() == DRAWN_CARD_PHASE
+// POST: none
+Card
+Game::getDrawnCard() const
+{
+    return state.getDrawnCard();
+}
@@ -1,19 +1,23 @@
-#include <algorithm>
 #include <assert.h>
 #include <iostream>
 #include "card.hpp"
 #include "hand.hpp"
 using namespace std;
 
-// Initializes a Hand with enough capacity to hold all but 1 of the cards in the game (one must always be face up).
-// Note that the capacity is already set at compile time and this constructor merely initializes size and capacity.
+// Initializes an empty Hand.
 // 
 // PRE: none
-// POST: size == 0; capacity == TOTAL_CARDS - 1; cards will remain of size TOTAL_CARDS - 1
+// POST: size == 0; every count is 0
 Hand::Hand()
 {
+    for ( int id = 0; id < N_CARD_IDS; id++ )
+    {
+        counts[ id ] = 0;
+    }
+    mask = 0;
     size = 0;
-    capacity = TOTAL_CARDS - 1;
+    score = 0;
+    hash = 0;
 }
 
 // Prints the size, capacity, and comma-separated contents of the hand.
@@ -23,18 +27,18 @@ Hand::Hand()
 void
 Hand::print() const
 {
-    cout << "Hand ( " << size << " / " << capacity << " cards): [";
+    cout << "Hand ( " << size << " / " << HAND_CAPACITY << " cards): [";
 
-    // If there is at least one card, special case it and print the others (if any)
-    if ( size > 0 )
+    // Print each card separated by a comma and space
+    // Adding the space before the first card rather than in the last print statement prevents a double space if the hand is empty
+    const char* separator = " ";
+    for ( CardMask remaining = mask; remaining != 0; remaining &= remaining - 1 )
     {
-        // Adding the space here rather than in the last print statement prevents a double space if the hand is empty
-        cout << " " << cards[ 0 ].toStringShort();
-
-        // Iterate over the hand and print each card separated by a comma and space
-        for ( int i = 1; i < size; i++ )
+        int id = lowestCardId( remaining );
+        for ( int copy = 0; copy < counts[ id ]; copy++ )
         {
-            cout << ", " << cards[ i ].toStringShort();
+            cout << separator << Card::fromId( id ).getShortName();
+            separator = ", ";
         }
     }
 
@@ -48,52 +52,40 @@ Hand::print() const
 void
 Hand::printContents() const
 {
-    // If the hand is empty, print nothing
-    if ( isEmpty() )
-    {
-        return;
-    }
-
-    // Special case the first card and put a space before each subsequent card
-    cout << cards[ 0 ].toStringShort();
-    for ( int i = 1; i < size; i++ )
+    // Put a space before each card but the first
+    const char* separator = "";
+    for ( CardMask remaining = mask; remaining != 0; remaining &= remaining - 1 )
     {
-        cout << " " << cards[ i ].toStringShort();
+        int id = lowestCardId( remaining );
+        for ( int copy = 0; copy < counts[ id ]; copy++ )
+        {
+            cout << separator << Card::fromId( id ).getShortName();
+            separator = " ";
+        }
     }
 }
 
-// Appends the given card to the end of the hand (the first open slot).
+// Adds the given card to the hand.
 // 
 // PRE: hand must not be full
-// POST: size will increase by 1; cards[ size - 1 ] == c
+// POST: size will increase by 1; count( c ) will increase by 1
 void
 Hand::add( Card c )
 {
     // Assert the preconditions
-    assert( size < capacity );
-
-    // If the hand is empty, just put the card in the first slot of the hand
-    if ( size == 0 )
-    {
-        cards[ 0 ] = c;
-        size++;
-        return;
-    }
+    assert( size < HAND_CAPACITY );
+    assert( counts[ c.getId() ] < MAX_CARD_COPIES );
 
-    // Insert the card into the hand, effectively using one iteration of insertion sort
-    int i = size;
-    cards[ i ] = c;
-    while ( i > 0 && cards[ i - 1 ].isGreaterThan( cards[ i ] ) )
-    {
-        swap( cards[ i ], cards[ i - 1 ] );
-        i--;
-    }
-
-    // Increment the size as a card has been added
+    int id = c.getId();
+    hash ^= ZOBRIST_KEYS.handCards[ id ][ counts[ id ] ];
+    counts[ id ]++;
+    mask |= CardMask( 1 ) << id;
     size++;
+    score += c.getScore();
 }
 
-// Returns the card at the given index.
+// Returns the card at the given index, where the cards are in sorted order.
+// This walks the distinct cards in the hand, so it takes at most N_CARD_IDS steps.
 // 
 // PRE: 0 <= index < size
 // POST: none
@@ -104,14 +96,24 @@ Hand::getCardAt( int index ) const
     assert( 0 <= index );
     assert( index < size );
 
-    // If index is valid, simply return the value at it
-    return cards[ index ];
+    // Skip over the copies of each card until the index falls within one of them
+    CardMask remaining = mask;
+    while ( true )
+    {
+        int id = lowestCardId( remaining );
+        if ( index < counts[ id ] )
+        {
+            return Card::fromId( id );
+        }
+        index -= counts[ id ];
+        remaining &= remaining - 1;
+    }
 }
 
 // Returns the current size of the hand.
 // 
 // PRE: none
-// POST: 0 <= return value <= capacity
+// POST: 0 <= return value <= HAND_CAPACITY
 int
 Hand::getSize() const
 {
@@ -125,7 +127,7 @@ Hand::getSize() const
 bool
 Hand::isFull() const
 {
-    return size == capacity;
+    return size == HAND_CAPACITY;
 }
 
 // Returns true if the hand is empty (i.e. the size equals 0).
@@ -138,40 +140,96 @@ Hand::isEmpty() const
     return size == 0;
 }
 
-// Removes the card at the given index and shifts the others over to fill its place.
+// Removes one copy of the given card.
 // 
-// PRE: 0 <= index < size
-// POST: size will decrease by 1; values after index will be moved to the next lower index
+// PRE: the hand contains c
+// POST: size will decrease by 1; count( c ) will decrease by 1
 void
-Hand::removeCardAt( int index )
+Hand::remove( Card c )
 {
     // Assert the preconditions
-    assert( 0 <= index );
-    assert( index < size );
+    int id = c.getId();
+    assert( counts[ id ] > 0 );
 
-    // Starting at the value after index, shift every card down, overwriting the previous one
-    // The only card overwritten and not rewritten will be the value at index
-    for ( int i = index + 1; i < size; i++ )
+    // Once the last copy is gone, the card leaves the mask
+    counts[ id ]--;
+    hash ^= ZOBRIST_KEYS.handCards[ id ][ counts[ id ] ];
+    if ( counts[ id ] == 0 )
     {
-        cards[ i - 1 ] = cards[ i ];
+        mask &= ~( CardMask( 1 ) << id );
     }
-
-    // Decrement size
-    // There will be an unused duplicate value of cards[ size - 1 ] at cards[ size ] that should never be accessed
-    // If there is only 1 card in the hand, the loop will be skipped but the size will decrease to 0, having the same effect
     size--;
+    score -= c.getScore();
+}
 
-    assert( isSorted() );
+// Removes the card at the given index; cards after it will move down one index.
+// Finding the card walks the distinct cards like getCardAt does, so callers that know the card should use remove.
+// 
+// PRE: 0 <= index < size
+// POST: size will decrease by 1
+void
+Hand::removeCardAt( int index )
+{
+    remove( getCardAt( index ) );
 }
 
-// Empties the hand by setting size to 0, making any previous contents inaccessible.
+// Empties the hand.
 // 
 // PRE: none
 // POST: size == 0
 void
 Hand::clear()
 {
+    // Only the cards in the mask have non-zero counts
+    for ( CardMask remaining = mask; remaining != 0; remaining &= remaining - 1 )
+    {
+        counts[ lowestCardId( remaining ) ] = 0;
+    }
+    mask = 0;
     size = 0;
+    score = 0;
+    hash = 0;
+}
+
+// Returns the number of copies of the given card in the hand.
+// 
+// PRE: none
+// POST: 0 <= return value <= size
+int
+Hand::count( Card c ) const
+{
+    return counts[ c.getId() ];
+}
+
+// Returns true if the hand holds at least one copy of the given card.
+// 
+// PRE: none
+// POST: none
+bool
+Hand::contains( Card c ) const
+{
+    return ( mask >> c.getId() ) & 1;
+}
+
+// Returns the set of card ids in the hand.
+// 
+// PRE: none
+// POST: none
+CardMask
+Hand::getMask() const
+{
+    return mask;
+}
+
+// Returns the set of card ids in the hand that can be played on the given stock.
+// This is a single AND against the precomputed set of cards playable on the stock, so it never branches.
+// 
+// PRE: 0 <= wildColor <= NO_COLOR_INDEX; if the stock is wild, wildColor should be the color chosen for it
+// POST: every id in the return value is also in getMask()
+CardMask
+Hand::playableMask( Card stock, int wildColor ) const
+{
+    return mask & Card::TABLES.playable[ stock.getId() ][ wildColor ];
 }
 
 // Returns the first index of c in the hand.
@@ -181,19 +239,19 @@ Hand::clear()
 int
 Hand::find( Card c ) const
 {
-    // Iterate across the hand, comparing each card with c
-    for ( int i = 0; i < size; i++ )
+    if ( !contains( c ) )
     {
-        // If this card is equal to c, return the index
-        // Even if there are other cards equal to c, we only care about the first card
-        if ( cards[ i ].isEqual( c ) )
-        {
-            return i;
-        }
+        return -1;
     }
 
-    // If the loop completed without returning an index, c is not present, so return -1
-    return -1;
+    // The first copy of c comes after every copy of each lower card
+    int index = 0;
+    for ( CardMask lower = mask & ( ( CardMask( 1 ) << c.getId() ) - 1 ); lower != 0; lower &= lower - 1 )
+    {
+        index += counts[ lowestCardId( lower ) ];
+    }
+
+    return index;
 }
 
 // Returns the first index of a card whose toStringShort() matches the given string.
@@ -203,61 +261,37 @@ Hand::find( Card c ) const
 int
 Hand::findString( string s ) const
 {
-    // Iterate across the hand, comparing each card with c
-    for ( int i = 0; i < size; i++ )
+    // Iterate across the distinct cards in the hand, comparing each card's short name with s
+    for ( CardMask remaining = mask; remaining != 0; remaining &= remaining - 1 )
     {
-        // If this card is equal to c, return the index
-        // Even if there are other cards equal to c, we only care about the first card
-        if ( s == cards[ i ].toStringShort() )
+        Card card = Card::fromId( lowestCardId( remaining ) );
+        if ( s == card.getShortName() )
         {
-            return i;
+            return find( card );
         }
     }
 
-    // If the loop completed without returning an index, c is not present, so return -1
+    // If the loop completed without returning an index, no card matches, so return -1
     return -1;
 }
 
-// Returns true if the hand is sorted in ascending order.
+// Returns the sum of the score of every card in the hand.
+// The sum is kept up to date as cards are added and removed.
 // 
 // PRE: none
 // POST: none
-bool
-Hand::isSorted() const
+int
+Hand::getScore() const
 {
-    // If the hand is empty or has only 1 card, it must be "sorted"
-    if ( size <= 1 )
-    {
-        return true;
-    }
-
-    // Iterate across the hand, comparing each value to see if it is greater than the previous
-    for ( int i = 1; i < size; i++ )
-    {
-        // If this card is not greater than or equal the previous, the hand is not sorted
-        if ( cards[ i ].isLessThan( cards[ i - 1 ] ) )
-        {
-            return false;
-        }
-    }
-
-    // If the loop completed without returning false, no out-of-place cards were found and the hand is sorted 
-    return true;
+    return score;
 }
 
-// Sums the score of every card in the hand and returns this sum.
+// Returns the Zobrist hash of the cards in the hand. Two hands with the same cards have the same hash.
 // 
 // PRE: none
 // POST: none
-int
-Hand::getScore() const
+uint64_t
+Hand::getHash() const
 {
-    // Sum the scores of cards in the hand
-    int score = 0;
-    for ( int i = 0; i < size; i++ )
-    {
-        score += cards[ i ].getScore();
-    }
-
-    return score;
+    return hash;
 }
@@ -0,0 +1,375 @@
+#include <assert.h>
+#include <stdio.h>
+#include "log.hpp"
+using namespace std;
+
+// Starts a session of the log on the given writer.
+// 
+// PRE: out is open, and must outlive the log
+// POST: none
+EventLog::EventLog( BufferedWriter& writer )
+    : out( writer ), bits( writer )
+{
+    finished = false;
+    bits.write( LOG_MAGIC, LOG_MAGIC_BITS );
+    bits.write( LOG_VERSION, LOG_VERSION_BITS );
+}
+
+// Finishes the session, if finish() has not already.
+// 
+// PRE: none
+// POST: none
+EventLog::~EventLog()
+{
+    finish();
+}
+
+// Records the start of a game. Together with the players' decisions, the seed and stream determine the whole game.
+// 
+// PRE: 2 <= nPlayers <= MAX_PLAYERS; 1 <= goalScore < 2 ^ LOG_GOAL_BITS; finish() has not been called
+// POST: none
+void
+EventLog::beginGame( uint64_t seedValue, uint64_t stream, int nPlayers, int goalScore )
+{
+    // Assert the preconditions
+    assert( !finished );
+
+    bits.write( LOG_GAME_START, LOG_TYPE_BITS );
+    bits.write( seedValue, 64 );
+    bits.write( stream, 64 );
+    bits.write( nPlayers, LOG_PLAYER_BITS );
+    bits.write( goalScore, LOG_GOAL_BITS );
+}
+
+// Ends the session with a LOG_END record and flushes it to the file, so it can be read back complete.
+// Further events are ignored.
+// 
+// PRE: none
+// POST: every record of the session has reached the file
+void
+EventLog::finish()
+{
+    if ( finished )
+    {
+        return;
+    }
+
+    bits.write( LOG_END, LOG_TYPE_BITS );
+    bits.alignToByte();
+    out.flush();
+    finished = true;
+}
+
+// Records that a card was dealt to the given player.
+// 
+// PRE: none
+// POST: none
+void
+EventLog::onDeal( const Game&, int playerIndex, Card card )
+{
+    writeCardEvent( LOG_DEAL, playerIndex, card );
+}
+
+// Records the first stock of a round.
+// 
+// PRE: none
+// POST: none
+void
+EventLog::onFirstStock( const Game&, int playerIndex, Card stock )
+{
+    writeCardEvent( LOG_FIRST_STOCK, playerIndex, stock );
+}
+
+// Records a card drawn on a player's turn.
+// 
+// PRE: none
+// POST: none
+void
+EventLog::onDraw( const Game&, int playerIndex, Card card )
+{
+    writeCardEvent( LOG_DRAW, playerIndex, card );
+}
+
+// Records that a player could not draw from the empty table.
+// 
+// PRE: none
+// POST: none
+void
+EventLog::onTableEmpty( const Game&, int playerIndex )
+{
+    if ( !finished )
+    {
+        bits.write( LOG_TABLE_EMPTY, LOG_TYPE_BITS );
+        bits.write( playerIndex, LOG_PLAYER_BITS );
+    }
+}
+
+// Records a card played.
+// 
+// PRE: none
+// POST: none
+void
+EventLog::onPlay( const Game&, int playerIndex, Card card )
+{
+    writeCardEvent( LOG_PLAY, playerIndex, card );
+}
+
+// Records a card drawn for a Draw2 or Draw4 Wild.
+// 
+// PRE: none
+// POST: none
+void
+EventLog::onPenaltyCard( const Game&, int playerIndex, Card card )
+{
+    writeCardEvent( LOG_PENALTY_CARD, playerIndex, card );
+}
+
+// Records the cards a player was made to draw, and how many of them the table had.
+// 
+// PRE: 0 <= nDrawn <= nCards <= MAX_REWIND_DRAWS
+// POST: none
+void
+EventLog::onDrawPenalty( const Game&, int playerIndex, int nCards, int nDrawn )
+{
+    if ( !finished )
+    {
+        bits.write( LOG_DRAW_PENALTY, LOG_TYPE_BITS );
+        bits.write( playerIndex, LOG_PLAYER_BITS );
+        bits.write( nCards, LOG_PENALTY_BITS );
+        bits.write( nDrawn, LOG_PENALTY_BITS );
+    }
+}
+
+// Records that a player reversed the direction of play.
+// 
+// PRE: none
+// POST: none
+void
+EventLog::onReverse( const Game&, int playerIndex )
+{
+    if ( !finished )
+    {
+        bits.write( LOG_REVERSE, LOG_TYPE_BITS );
+        bits.write( playerIndex, LOG_PLAYER_BITS );
+    }
+}
+
+// Records that a player was skipped.
+// 
+// PRE: none
+// POST: none
+void
+EventLog::onSkip( const Game&, int playerIndex )
+{
+    if ( !finished )
+    {
+        bits.write( LOG_SKIP, LOG_TYPE_BITS );
+        bits.write( playerIndex, LOG_PLAYER_BITS );
+    }
+}
+
+// Records the color a player named for a wild card.
+// 
+// PRE: 0 <= color < N_COLORS
+// POST: none
+void
+EventLog::onColorChosen( const Game&, int playerIndex, int color )
+{
+    if ( !finished )
+    {
+        bits.write( LOG_COLOR_CHOSEN, LOG_TYPE_BITS );
+        bits.write( playerIndex, LOG_PLAYER_BITS );
+        bits.write( color, LOG_COLOR_BITS );
+    }
+}
+
+// Records that the discard pile was shuffled into the draw pile.
+// 
+// PRE: none
+// POST: none
+void
+EventLog::onReshuffle( const Game& )
+{
+    if ( !finished )
+    {
+        bits.write( LOG_RESHUFFLE, LOG_TYPE_BITS );
+    }
+}
+
+// Records the winner of a round and the points they scored.
+// 
+// PRE: 0 <= points < 2 ^ LOG_POINTS_BITS
+// POST: none
+void
+EventLog::onRoundScored( const Game&, int playerIndex, int points )
+{
+    if ( !finished )
+    {
+        bits.write( LOG_ROUND_SCORED, LOG_TYPE_BITS );
+        bits.write( playerIndex, LOG_PLAYER_BITS );
+        bits.write( points, LOG_POINTS_BITS );
+    }
+}
+
+// Writes a record of the given type that names a player and a card.
+// 
+// PRE: none
+// POST: none
+void
+EventLog::writeCardEvent( int type, int playerIndex, Card card )
+{
+    if ( !finished )
+    {
+        bits.write( type, LOG_TYPE_BITS );
+        bits.write( playerIndex, LOG_PLAYER_BITS );
+        bits.write( card.getId(), LOG_CARD_BITS );
+    }
+}
+
+// Initializes a reader with nothing to read.
+// 
+// PRE: none
+// POST: next() will return false until a file is opened
+EventLogReader::EventLogReader()
+    : bits( NULL, 0 )
+{
+    inSession = false;
+    corrupt = false;
+}
+
+// Reads the whole log file at the given path into memory, to read its records from the start.
+// Returns false if the file cannot be read.
+// 
+// PRE: none
+// POST: none
+bool
+EventLogReader::open( const string& path )
+{
+    data.clear();
+    inSession = false;
+    corrupt = false;
+
+    FILE* file = fopen( path.c_str(), "rb" );
+    if ( file == NULL )
+    {
+        bits = BitReader( NULL, 0 );
+        return false;
+    }
+    unsigned char chunk[ 1 << 16 ];
+    size_t nRead;
+    while ( ( nRead = fread( chunk, 1, sizeof( chunk ), file ) ) > 0 )
+    {
+        data.insert( data.end(), chunk, chunk + nRead );
+    }
+    fclose( file );
+
+    bits = BitReader( data.data(), data.size() );
+    return true;
+}
+
+// Reads the next record into event. Returns false at the end of the log, or if the rest of it cannot be read.
+// 
+// PRE: none
+// POST: if the return value is false, event is unchanged
+bool
+EventLogReader::next( LogEvent& event )
+{
+    // Start the next session, if the last one ended
+    if ( !inSession )
+    {
+        if ( !bits.canRead( LOG_MAGIC_BITS + LOG_VERSION_BITS ) )
+        {
+            return false;
+        }
+        if ( bits.read( LOG_MAGIC_BITS ) != LOG_MAGIC || bits.read( LOG_VERSION_BITS ) != LOG_VERSION )
+        {
+            corrupt = true;
+            return false;
+        }
+        inSession = true;
+    }
+
+    // A session that was cut off ends partway through a record
+    if ( !bits.canRead( LOG_TYPE_BITS ) )
+    {
+        corrupt = true;
+        return false;
+    }
+    LogEvent read = LogEvent();
+    read.type = bits.read( LOG_TYPE_BITS );
+    switch ( read.type )
+    {
+        case LOG_GAME_START:
+            if ( !bits.canRead( 128 + LOG_PLAYER_BITS + LOG_GOAL_BITS ) )
+            {
+                corrupt = true;
+                return false;
+            }
+            read.seed = bits.read( 64 );
+            read.stream = bits.read( 64 );
+            read.count = bits.read( LOG_PLAYER_BITS );
+            read.value = bits.read( LOG_GOAL_BITS );
+            break;
+        case LOG_END:
+            // The session is over; the next one starts on the next byte
+            bits.alignToByte();
+            inSession = false;
+            return next( event );
+        case LOG_RESHUFFLE:
+            break;
+        default:
+        {
+            // Every other record names a player, and then a card or a few small numbers
+            int type = read.type;
+            bool hasCard = type == LOG_DEAL || type == LOG_FIRST_STOCK || type == LOG_DRAW || type == LOG_PLAY
+                || type == LOG_PENALTY_CARD;
+            int nBits = LOG_PLAYER_BITS + ( hasCard ? LOG_CARD_BITS : 0 )
+                + ( type == LOG_DRAW_PENALTY ? 2 * LOG_PENALTY_BITS : 0 )
+                + ( type == LOG_COLOR_CHOSEN ? LOG_COLOR_BITS : 0 ) + ( type == LOG_ROUND_SCORED ? LOG_POINTS_BITS : 0 );
+            if ( type > LOG_ROUND_SCORED || !bits.canRead( nBits ) )
+            {
+                corrupt = true;
+                return false;
+            }
+
+            read.playerIndex = bits.read( LOG_PLAYER_BITS );
+            if ( hasCard )
+            {
+                int id = bits.read( LOG_CARD_BITS );
+                if ( id >= N_CARD_IDS )
+                {
+                    corrupt = true;
+                    return false;
+                }
+                read.card = Card::fromId( id );
+            }
+            if ( type == LOG_DRAW_PENALTY )
+            {
+                read.value = bits.read( LOG_PENALTY_BITS );
+                read.count = bits.read( LOG_PENALTY_BITS );
+            }
+            else if ( type == LOG_COLOR_CHOSEN )
+            {
+                read.value = bits.read( LOG_COLOR_BITS );
+            }
+            else if ( type == LOG_ROUND_SCORED )
+            {
+                read.value = bits.read( LOG_POINTS_BITS );
+            }
+            break;
+        }
+    }
+
+    event = read;
+    return true;
+}
+
+// Returns true if next() stopped because the log was cut off or is not a log, rather than at its end.
+// 
+// PRE: none
+// POST: none
+bool
+EventLogReader::isCorrupt() const
+{
+    return corrupt;
+}
@@ -0,0 +1,286 @@
+#include <assert.h>
+#include <math.h>
+#include "game.hpp"
+#include "mcts.hpp"
+using namespace std;
+
+// How strongly the search favors moves it has tried less often over moves that have won more often (the UCB constant)
+const double EXPLORATION = 0.7;
+
+// The number of iterations between checks of the clock
+const int ITERATIONS_PER_CLOCK_CHECK = 64;
+
+// Initializes an agent that searches with the given number of threads, for the given time per move.
+// If iterationsPerMove is positive, each search instead runs that many iterations in total regardless of time,
+// which makes its choices depend only on the seed.
+// 
+// PRE: nThreads >= 1; millisPerMove >= 0; iterationsPerMove >= 0
+// POST: none
+MctsAgent::MctsAgent( int nThreads, int millisPerMove, uint64_t seed, int iterationsPerMove )
+    : pool( nThreads ), random( seed, 0 ), trees( nThreads )
+{
+    // Assert the preconditions
+    assert( nThreads >= 1 );
+    assert( millisPerMove >= 0 );
+    assert( iterationsPerMove >= 0 );
+
+    this->millisPerMove = millisPerMove;
+    this->iterationsPerMove = iterationsPerMove;
+    lastPlayouts = 0;
+    for ( int playerIndex = 0; playerIndex < MAX_PLAYERS; playerIndex++ )
+    {
+        trackers[ playerIndex ] = NULL;
+    }
+}
+
+// Picks a move by searching from the game's current state.
+// 
+// PRE: moves is the non-empty list of legal moves for the current player of game
+// POST: return value is one of the moves in the list
+Move
+MctsAgent::chooseMove( const Game& game, const MoveList& moves )
+{
+    return search( game.getState(), moves );
+}
+
+// Returns the next move of a playout: a random move, except that a player never draws while they can play,
+// and always plays a playable card they drew. This is much closer to real play than picking uniformly among the moves.
+// 
+// PRE: moves is the non-empty list of legal moves for the current player of state
+// POST: return value is one of the moves in the list
+static Move
+choosePlayoutMove( const GameState& state, const MoveList& moves, Random& random )
+{
+    // Every color is equally good for the first stock
+    if ( state.getPhase() == FIRST_COLOR_PHASE )
+    {
+        return moves.get( random.nextBelow( moves.getSize() ) );
+    }
+
+    // Otherwise, the last move is drawing or keeping the drawn card, so leave it out unless it is the only move
+    if ( moves.getSize() == 1 )
+    {
+        return moves.get( 0 );
+    }
+    return moves.get( random.nextBelow( moves.getSize() - 1 ) );
+}
+
+// Searches from the given state and returns the best of the given moves for its current player.
+// Every thread grows its own tree, so they never contend; the move whose root node was visited the most across all trees
+// is chosen, since the search spends its visits on the moves that are winning most often.
+// 
+// PRE: moves is the non-empty list of legal moves for the current player of state
+// POST: return value is one of the moves in the list
+Move
+MctsAgent::search( const GameState& state, const MoveList& moves )
+{
+    // Assert the preconditions
+    assert( !moves.isEmpty() );
+
+    // There is nothing to search if there is only one move
+    lastPlayouts = 0;
+    if ( moves.getSize() == 1 )
+    {
+        return moves.get( 0 );
+    }
+
+    // Grow every tree in parallel; each gets its own stream of a seed drawn from the agent's generator
+    uint64_t searchSeed = ( uint64_t( random.next() ) << 32 ) | random.next();
+    chrono::steady_clock::time_point deadline = chrono::steady_clock::now() + chrono::milliseconds( millisPerMove );
+    int nTrees = trees.size();
+    vector< long > treePlayouts( nTrees, 0 );
+    pool.run( nTrees, [ & ]( int treeIndex, int )
+    {
+        Random treeRandom( searchSeed, treeIndex );
+        treePlayouts[ treeIndex ] = growTree( trees[ treeIndex ], state, treeRandom, deadline );
+    } );
+
+    // Sum the visits of each move at the roots of every tree
+    long visits[ MAX_MOVES ] = { 0 };
+    for ( int treeIndex = 0; treeIndex < nTrees; treeIndex++ )
+    {
+        const vector< MctsNode >& tree = trees[ treeIndex ];
+        for ( int child = tree[ 0 ].firstChild; child != -1; child = tree[ child ].nextSibling )
+        {
+            int moveIndex = moves.find( tree[ child ].move );
+            if ( moveIndex != -1 )
+            {
+                visits[ moveIndex ] += tree[ child ].visits;
+            }
+        }
+        lastPlayouts += treePlayouts[ treeIndex ];
+    }
+
+    // Pick the most visited move
+    int bestIndex = 0;
+    for ( int moveIndex = 1; moveIndex < moves.getSize(); moveIndex++ )
+    {
+        if ( visits[ moveIndex ] > visits[ bestIndex ] )
+        {
+            bestIndex = moveIndex;
+        }
+    }
+
+    return moves.get( bestIndex );
+}
+
+// Returns the number of playouts run by the most recent search, across every thread.
+// 
+// PRE: none
+// POST: return value >= 0
+long
+MctsAgent::getLastPlayouts() const
+{
+    return lastPlayouts;
+}
+
+// Sets the belief tracker that determinizes the cards the given seat cannot see when the agent searches for it.
+// The tracker must be receiving the events of the game the agent plays in; NULL goes back to uniform determinizations.
+// 
+// PRE: 0 <= playerIndex < MAX_PLAYERS; tracker is NULL or its observer index is playerIndex
+// POST: none
+void
+MctsAgent::setBeliefTracker( int playerIndex, const BeliefTracker* tracker )
+{
+    // Assert the preconditions
+    assert( playerIndex >= 0 );
+    assert( playerIndex < MAX_PLAYERS );
+    assert( tracker == NULL || tracker->getObserverIndex() == playerIndex );
+
+    trackers[ playerIndex ] = tracker;
+}
+
+// Grows a new tree from the given state until the deadline (or the tree's share of the iterations) and returns the
+// number of iterations run. Each iteration determinizes the state, selects down the tree among the children whose
+// moves are legal in that determinization, expands one untried move, plays out the rest of the round, and credits
+// the round's winner along the path.
+// 
+// PRE: root's round is initialized and not over
+// POST: tree[ 0 ] is the root; its children hold the statistics of the current player's moves
+long
+MctsAgent::growTree( vector< MctsNode >& tree, const GameState& root, Random& treeRandom, chrono::steady_clock::time_point deadline )
+{
+    // Start from a tree holding just the root, which stands for everything the current player considers possible
+    MctsNode rootNode = MctsNode();
+    rootNode.parent = -1;
+    rootNode.firstChild = -1;
+    rootNode.nextSibling = -1;
+    tree.clear();
+    tree.push_back( rootNode );
+
+    // Define convenience variables
+    int observerIndex = root.getCurrentPlayerIndex();
+    const BeliefTracker* tracker = trackers[ observerIndex ];
+    int nTrees = trees.size();
+    long maxIterations = iterationsPerMove > 0 ? ( iterationsPerMove + nTrees - 1 ) / nTrees : 0;
+    MoveList moves;
+
+    long iterations = 0;
+    while ( true )
+    {
+        // Stop after a fixed number of iterations if one was given, otherwise when time runs out
+        if ( maxIterations > 0 )
+        {
+            if ( iterations >= maxIterations )
+            {
+                break;
+            }
+        }
+        else if ( iterations % ITERATIONS_PER_CLOCK_CHECK == 0 && chrono::steady_clock::now() >= deadline )
+        {
+            break;
+        }
+
+        // Deal the unseen cards at random, consistently with what the observer knows if they have a tracker.
+        // If what they know turns out to be impossible (an opponent drew while they could play), deal as if they knew nothing
+        GameState state = root;
+        if ( tracker == NULL || !tracker->sample( state, treeRandom ) )
+        {
+            state.determinize( observerIndex, treeRandom );
+        }
+
+        // Select down the tree until reaching a move that has not been tried, then add it to the tree
+        int node = 0;
+        while ( !state.roundIsOver() )
+        {
+            state.legalMoves( moves );
+
+            // Of the children whose moves are legal here, find the one with the best upper confidence bound
+            // Each of them was available to be chosen on this visit
+            bool tried[ MAX_MOVES ] = { false };
+            int bestChild = -1;
+            double bestBound = -1;
+            for ( int child = tree[ node ].firstChild; child != -1; child = tree[ child ].nextSibling )
+            {
+                int moveIndex = moves.find( tree[ child ].move );
+                if ( moveIndex == -1 )
+                {
+                    continue;
+                }
+                tried[ moveIndex ] = true;
+
+                MctsNode& childNode = tree[ child ];
+                childNode.availability++;
+                double bound = childNode.wins / childNode.visits + EXPLORATION * sqrt( log( double( childNode.availability ) ) / childNode.visits );
+                if ( bound > bestBound )
+                {
+                    bestBound = bound;
+                    bestChild = child;
+                }
+            }
+
+            // If any legal move has not been tried, expand one of them at random and stop selecting
+            int untried[ MAX_MOVES ];
+            int nUntried = 0;
+            for ( int moveIndex = 0; moveIndex < moves.getSize(); moveIndex++ )
+            {
+                if ( !tried[ moveIndex ] )
+                {
+                    untried[ nUntried++ ] = moveIndex;
+                }
+            }
+            if ( nUntried > 0 )
+            {
+                MctsNode childNode = MctsNode();
+                childNode.move = moves.get( untried[ treeRandom.nextBelow( nUntried ) ] );
+                childNode.moverIndex = state.getCurrentPlayerIndex();
+                childNode.parent = node;
+                childNode.firstChild = -1;
+                childNode.nextSibling = tree[ node ].firstChild;
+                childNode.availability = 1;
+                tree[ node ].firstChild = tree.size();
+                tree.push_back( childNode );
+
+                node = tree.size() - 1;
+                state.apply( childNode.move );
+                break;
+            }
+
+            node = bestChild;
+            state.apply( tree[ node ].move );
+        }
+
+        // Play out the rest of the round
+        for ( int move = 0; move < MAX_PLAYOUT_MOVES && !state.roundIsOver(); move++ )
+        {
+            state.legalMoves( moves );
+            state.apply( choosePlayoutMove( state, moves, treeRandom ) );
+        }
+
+        // Credit the win to every move along the path that the winner made
+        // An abandoned playout has no winner, so it counts as a loss for everyone
+        int winnerIndex = state.roundIsOver() ? state.getRoundWinnerIndex() : -1;
+        for ( ; node != -1; node = tree[ node ].parent )
+        {
+            tree[ node ].visits++;
+            if ( node != 0 && tree[ node ].moverIndex == winnerIndex )
+            {
+                tree[ node ].wins += 1;
+            }
+        }
+
+        iterations++;
+    }
+
+    return iterations;
+}
@@ -0,0 +1,274 @@
+#include <assert.h>
+#include "move.hpp"
+using namespace std;
+
+// Initializes a Move as drawing a card.
+// 
+// PRE: none
+// POST: type == DRAW_CARD
+Move::Move()
+{
+    type = DRAW_CARD;
+    color = NO_COLOR_INDEX;
+    target = 0;
+}
+
+// Initializes a Move of the given type, card, and color.
+// 
+// PRE: t is a MoveType; 0 <= c <= NO_COLOR_INDEX
+// POST: type == t; card == k; color == c
+Move::Move( int t, Card k, int c )
+{
+    // Assert the preconditions
+    assert( t >= PLAY_CARD );
+    assert( t <= PASS );
+    assert( c >= 0 );
+    assert( c <= NO_COLOR_INDEX );
+
+    type = t;
+    card = k;
+    color = c;
+    target = 0;
+}
+
+// Returns a move playing the given card from the hand, naming the given color if it is wild.
+// 
+// PRE: if the card is wild, 0 <= wildColor < N_COLORS
+// POST: none
+Move
+Move::playCard( Card card, int wildColor )
+{
+    return Move( PLAY_CARD, card, card.isWild() ? wildColor : NO_COLOR_INDEX );
+}
+
+// Returns a move drawing a card.
+// 
+// PRE: none
+// POST: none
+Move
+Move::drawCard()
+{
+    return Move( DRAW_CARD, Card(), NO_COLOR_INDEX );
+}
+
+// Returns a move playing the card just drawn, naming the given color if it is wild.
+// 
+// PRE: if the card is wild, 0 <= wildColor < N_COLORS
+// POST: none
+Move
+Move::playDrawn( Card card, int wildColor )
+{
+    return Move( PLAY_DRAWN, card, card.isWild() ? wildColor : NO_COLOR_INDEX );
+}
+
+// Returns a move keeping the card just drawn.
+// 
+// PRE: none
+// POST: none
+Move
+Move::keepDrawn()
+{
+    return Move( KEEP_DRAWN, Card(), NO_COLOR_INDEX );
+}
+
+// Returns a move naming the color of a wild first stock.
+// 
+// PRE: 0 <= color < N_COLORS
+// POST: none
+Move
+Move::chooseColor( int color )
+{
+    return Move( CHOOSE_COLOR, Card(), color );
+}
+
+// Returns a move swapping hands with the given player.
+// 
+// PRE: 0 <= playerIndex < the number of players
+// POST: none
+Move
+Move::swapHands( int playerIndex )
+{
+    Move move( SWAP_HANDS, Card(), NO_COLOR_INDEX );
+    move.target = playerIndex;
+    return move;
+}
+
+// Returns a move declining to jump in.
+// 
+// PRE: none
+// POST: none
+Move
+Move::pass()
+{
+    return Move( PASS, Card(), NO_COLOR_INDEX );
+}
+
+// Returns the type of the move.
+// 
+// PRE: none
+// POST: return value is a MoveType
+int
+Move::getType() const
+{
+    return type;
+}
+
+// Returns the card played by the move. Only meaningful for PLAY_CARD and PLAY_DRAWN.
+// 
+// PRE: none
+// POST: none
+Card
+Move::getCard() const
+{
+    return card;
+}
+
+// Returns the color named by the move, or NO_COLOR_INDEX if it names none.
+// 
+// PRE: none
+// POST: 0 <= return value <= NO_COLOR_INDEX
+int
+Move::getColor() const
+{
+    return color;
+}
+
+// Returns the player to swap hands with. Only meaningful for SWAP_HANDS.
+// 
+// PRE: none
+// POST: none
+int
+Move::getTarget() const
+{
+    return target;
+}
+
+// Returns true if this move is the same decision as the given move.
+// 
+// PRE: none
+// POST: none
+bool
+Move::isEqual( Move other ) const
+{
+    return type == other.type && card.isEqual( other.card ) && color == other.color && target == other.target;
+}
+
+// Returns a readable description of the move (e.g. "play Wild as Red").
+// 
+// PRE: none
+// POST: none
+string
+Move::toString() const
+{
+    string description;
+    switch ( type )
+    {
+        case PLAY_CARD:
+            description = "play " + card.toStringLong();
+            break;
+        case DRAW_CARD:
+            return "draw";
+        case PLAY_DRAWN:
+            description = "play drawn " + card.toStringLong();
+            break;
+        case KEEP_DRAWN:
+            return "keep drawn card";
+        case CHOOSE_COLOR:
+            return "choose " + COLOR_STRINGS[ color ];
+        case SWAP_HANDS:
+            return "swap hands with player " + to_string( target + 1 );
+        case PASS:
+            return "pass";
+    }
+
+    if ( color != NO_COLOR_INDEX )
+    {
+        description += " as " + COLOR_STRINGS[ color ];
+    }
+    return description;
+}
+
+// Initializes an empty MoveList.
+// 
+// PRE: none
+// POST: size == 0
+MoveList::MoveList()
+{
+    size = 0;
+}
+
+// Empties the list.
+// 
+// PRE: none
+// POST: size == 0
+void
+MoveList::clear()
+{
+    size = 0;
+}
+
+// Appends the given move to the list.
+// 
+// PRE: the list must not be full
+// POST: size will increase by 1
+void
+MoveList::add( Move move )
+{
+    // Assert the preconditions
+    assert( size < MAX_MOVES );
+
+    moves[ size ] = move;
+    size++;
+}
+
+// Returns the number of moves in the list.
+// 
+// PRE: none
+// POST: 0 <= return value <= MAX_MOVES
+int
+MoveList::getSize() const
+{
+    return size;
+}
+
+// Returns true if the list has no moves.
+// 
+// PRE: none
+// POST: none
+bool
+MoveList::isEmpty() const
+{
+    return size == 0;
+}
+
+// Returns the move at the given index.
+// 
+// PRE: 0 <= index < size
+// POST: none
+Move
+MoveList::get( int index ) const
+{
+    // Assert the preconditions
+    assert( 0 <= index );
+    assert( index < size );
+
+    return moves[ index ];
+}
+
+// Returns the index of the given move in the list.
+// 
+// PRE: none
+// POST: return value will be -1 if the move is not in the list
+int
+MoveList::find( Move move ) const
+{
+    for ( int i = 0; i < size; i++ )
+    {
+        if ( moves[ i ].isEqual( move ) )
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
@@ -3,41 +3,20 @@
 #include "deck.hpp"
 #include "hand.hpp"
 #include "player.hpp"
+#include "rules.hpp"
 #include "table.hpp"
 using namespace std;
 
-// Initializes a Player with the name "Player" and an empty hand.
+// Initializes a Player with a score of 0 and an empty hand.
 // 
 // PRE: none
-// POST: name == "Player"; hand is a new, empty hand
+// POST: score == 0; hand is a new, empty hand
 Player::Player()
 {
-    name = "Player";
     score = 0;
     hand = Hand();
 }
 
-// Initializes a Player with a name and empty hand.
-// 
-// PRE: none
-// POST: name == n; hand is a new, empty hand
-Player::Player( string n )
-{
-    name = n;
-    score = 0;
-    hand = Hand();
-}
-
-// Returns the name of this player.
-// 
-// PRE: none
-// POST: none
-string
-Player::getName() const
-{
-    return name;
-}
-
 // Returns this player's score.
 // 
 // PRE: none
@@ -58,6 +37,16 @@ Player::getHand()
     return hand;
 }
 
+// Returns a read-only reference to this player's hand.
+// 
+// PRE: none
+// POST: none
+const Hand&
+Player::getHand() const
+{
+    return hand;
+}
+
 // Sets this player's score to the given value.
 // 
 // PRE: s >= 0
@@ -77,8 +66,9 @@ Player::setScore( int s )
 // POST: return value is the card drawn
 //       hand size will increase by one
 //       the discard pile will be shuffled into the draw pile if the latter is empty
+template < int N_DECKS >
 Card
-Player::drawCard( Table& table )
+Player::drawCard( BasicTable< N_DECKS >& table )
 {
     Card card = table.drawCard();
     hand.add( card );
@@ -89,8 +79,9 @@ Player::drawCard( Table& table )
 // 
 // PRE: 0 <= nCards; table should have previously been initialized and should not be empty
 // POST: hand size will increase by nCards; the discard pile will be shuffled into the draw pile if the latter is empty
+template < int N_DECKS >
 void
-Player::drawCards( int nCards, Table& table )
+Player::drawCards( int nCards, BasicTable< N_DECKS >& table )
 {
     // Assert the preconditions
     assert( nCards >= 0 );
@@ -106,8 +97,9 @@ Player::drawCards( int nCards, Table& table )
 // 
 // PRE: 0 <= cardIndex < hand size; the card must be playable on the table's top card
 // POST: hand size will decrease by 1
+template < int N_DECKS >
 void
-Player::playCardIndex( int cardIndex, Table& table, int wildColor )
+Player::playCardIndex( int cardIndex, BasicTable< N_DECKS >& table, int wildColor )
 {
     // Assert the preconditions
     assert( cardIndex >= 0 );
@@ -118,24 +110,32 @@ Player::playCardIndex( int cardIndex, Table& table, int wildColor )
     // Play the card on the table and remove it from the hand
     // Table will assert that this card is playable on its top card
     table.playCard( card, wildColor );
-    hand.removeCardAt( cardIndex );
+    hand.remove( card );
 }
 
-// Plays the card at the given index on the given table.
+// Plays the given card on the given table.
 // 
 // PRE: the card must be in the hand; the card must be playable on the table's top card
 // POST: hand size will decrease by 1
+template < int N_DECKS >
 void
-Player::playCard( Card card, Table& table, int wildColor )
+Player::playCard( Card card, BasicTable< N_DECKS >& table, int wildColor )
 {
-    // Find the index of the card
-    int cardIndex = hand.find( card );
-    
     // Assert that the card is valid
-    assert( cardIndex != -1 );
+    assert( hand.contains( card ) );
 
     // Play the card on the table and remove it from the hand
     // Table will assert that this card is playable on its top card
     table.playCard( card, wildColor );
-    hand.removeCardAt( cardIndex );
+    hand.remove( card );
 }
+
+// The deck counts of the limits in rules.hpp; a new deck count must be added here
+template Card Player::drawCard( BasicTable< StandardLimits::N_DECKS >& );
+template Card Player::drawCard( BasicTable< TournamentLimits::N_DECKS >& );
+template void Player::drawCards( int, BasicTable< StandardLimits::N_DECKS >& );
+template void Player::drawCards( int, BasicTable< TournamentLimits::N_DECKS >& );
+template void Player::playCard( Card, BasicTable< StandardLimits::N_DECKS >&, int );
+template void Player::playCard( Card, BasicTable< TournamentLimits::N_DECKS >&, int );
+template void Player::playCardIndex( int, BasicTable< StandardLimits::N_DECKS >&, int );
+template void Player::playCardIndex( int, BasicTable< TournamentLimits::N_DECKS >&, int );
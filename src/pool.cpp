@@ -0,0 +1,150 @@
+#include <assert.h>
+#include <atomic>
+#include <stdint.h>
+#include <thread>
+#include <vector>
+#include "pool.hpp"
+using namespace std;
+
+// The unclaimed task indices [ begin, end ) of one worker, packed into one word so that
+// the owner (taking from the front) and thieves (taking from the back) can both claim work with a single CAS.
+// Each range is aligned to its own cache line so that workers do not contend for the same line.
+struct alignas( 64 ) TaskRange
+{
+    atomic< uint64_t > bounds;
+};
+
+static uint64_t
+packRange( uint32_t begin, uint32_t end )
+{
+    return ( uint64_t( begin ) << 32 ) | end;
+}
+
+// Claims the first task of the given range.
+// 
+// PRE: none
+// POST: if the range was empty, returns false and taskIndex is untouched
+static bool
+takeTask( TaskRange& range, int& taskIndex )
+{
+    uint64_t bounds = range.bounds.load();
+    while ( true )
+    {
+        uint32_t begin = bounds >> 32;
+        uint32_t end = uint32_t( bounds );
+        if ( begin >= end )
+        {
+            return false;
+        }
+
+        // On failure, bounds is reloaded with the current value and the claim is retried
+        if ( range.bounds.compare_exchange_weak( bounds, packRange( begin + 1, end ) ) )
+        {
+            taskIndex = begin;
+            return true;
+        }
+    }
+}
+
+// Moves the back half of another worker's range (rounded up, so a single task can be stolen) into the thief's range.
+// Victims are visited in order starting after the thief, so thieves spread out over the other workers.
+// 
+// PRE: the thief's own range is empty
+// POST: returns false if every other worker's range was empty
+static bool
+stealTasks( vector< TaskRange >& ranges, int thiefIndex )
+{
+    int nRanges = ranges.size();
+    for ( int offset = 1; offset < nRanges; offset++ )
+    {
+        TaskRange& victim = ranges[ ( thiefIndex + offset ) % nRanges ];
+        uint64_t bounds = victim.bounds.load();
+        while ( true )
+        {
+            uint32_t begin = bounds >> 32;
+            uint32_t end = uint32_t( bounds );
+            if ( begin >= end )
+            {
+                break;
+            }
+
+            uint32_t middle = begin + ( end - begin ) / 2;
+            if ( victim.bounds.compare_exchange_weak( bounds, packRange( begin, middle ) ) )
+            {
+                ranges[ thiefIndex ].bounds.store( packRange( middle, end ) );
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+// Initializes a pool that will run tasks on the given number of threads.
+// 
+// PRE: nThreads >= 1
+// POST: none
+WorkStealingPool::WorkStealingPool( int nThreads )
+{
+    // Assert the preconditions
+    assert( nThreads >= 1 );
+
+    this->nThreads = nThreads;
+}
+
+// Returns the number of threads tasks are run on.
+// 
+// PRE: none
+// POST: return value >= 1
+int
+WorkStealingPool::getThreadCount() const
+{
+    return nThreads;
+}
+
+// Runs task( taskIndex, threadIndex ) once for every taskIndex in [ 0, nTasks ) and waits for all of them to finish.
+// threadIndex identifies the worker running the task, so tasks may safely use per-worker state indexed by it.
+// 
+// PRE: nTasks >= 0; task must be safe to call from several threads at once
+// POST: every task has been run exactly once
+void
+WorkStealingPool::run( int nTasks, const function< void( int, int ) >& task )
+{
+    // Assert the preconditions
+    assert( nTasks >= 0 );
+
+    // Give every worker an equal share of the tasks to start with
+    vector< TaskRange > ranges( nThreads );
+    for ( int threadIndex = 0; threadIndex < nThreads; threadIndex++ )
+    {
+        uint32_t begin = int64_t( nTasks ) * threadIndex / nThreads;
+        uint32_t end = int64_t( nTasks ) * ( threadIndex + 1 ) / nThreads;
+        ranges[ threadIndex ].bounds.store( packRange( begin, end ) );
+    }
+
+    // Each worker runs its own tasks, then steals until no other worker has tasks left to give
+    // Tasks that have already been claimed are finished by whoever claimed them, so none are lost when a worker exits
+    auto work = [ & ]( int threadIndex )
+    {
+        int taskIndex;
+        do
+        {
+            while ( takeTask( ranges[ threadIndex ], taskIndex ) )
+            {
+                task( taskIndex, threadIndex );
+            }
+        } while ( stealTasks( ranges, threadIndex ) );
+    };
+
+    // The calling thread acts as the first worker
+    vector< thread > threads;
+    for ( int threadIndex = 1; threadIndex < nThreads; threadIndex++ )
+    {
+        threads.push_back( thread( work, threadIndex ) );
+    }
+    work( 0 );
+    for ( size_t i = 0; i < threads.size(); i++ )
+    {
+        threads[ i ].join();
+    }
+}
@@ -0,0 +1,127 @@
+#include <assert.h>
+#include "random.hpp"
+using namespace std;
+
+// The multiplier of the underlying LCG, from the PCG reference implementation
+const uint64_t PCG_MULTIPLIER = 6364136223846793005ULL;
+
+// Initializes a generator with seed 0 on stream 0.
+// 
+// PRE: none
+// POST: none
+Random::Random()
+{
+    seed( 0, 0 );
+}
+
+// Initializes a generator with the given seed on the given stream.
+// 
+// PRE: none
+// POST: none
+Random::Random( uint64_t seedValue, uint64_t stream )
+{
+    seed( seedValue, stream );
+}
+
+// Restarts the generator from the given seed on the given stream.
+// 
+// PRE: none
+// POST: the following outputs depend only on seedValue and stream
+void
+Random::seed( uint64_t seedValue, uint64_t stream )
+{
+    // The increment must be odd for the LCG to have full period
+    state = 0;
+    increment = ( stream << 1 ) | 1;
+    next();
+    state += seedValue;
+    next();
+}
+
+// Returns the next 32 uniformly distributed random bits.
+// 
+// PRE: none
+// POST: none
+uint32_t
+Random::next()
+{
+    // Advance the LCG, then output a permutation of the old state
+    // The xorshift folds the high bits down and the random rotation hides the weak low bits of the LCG
+    uint64_t oldState = state;
+    state = oldState * PCG_MULTIPLIER + increment;
+    uint32_t xorShifted = uint32_t( ( ( oldState >> 18 ) ^ oldState ) >> 27 );
+    uint32_t rotation = uint32_t( oldState >> 59 );
+    return ( xorShifted >> rotation ) | ( xorShifted << ( ( -rotation ) & 31 ) );
+}
+
+// Returns a uniformly distributed integer in [ 0, bound ), without the bias of next() % bound.
+// 
+// PRE: bound >= 1
+// POST: 0 <= return value < bound
+uint32_t
+Random::nextBelow( uint32_t bound )
+{
+    // Assert the preconditions
+    assert( bound >= 1 );
+
+    // Scale a 32-bit value into [ 0, bound ) with a multiply (Lemire's method)
+    // The low half of the product tells if this value falls in the few that would be over-represented; if so, retry
+    uint64_t product = uint64_t( next() ) * bound;
+    uint32_t low = uint32_t( product );
+    if ( low < bound )
+    {
+        uint32_t threshold = -bound % bound;
+        while ( low < threshold )
+        {
+            product = uint64_t( next() ) * bound;
+            low = uint32_t( product );
+        }
+    }
+
+    return uint32_t( product >> 32 );
+}
+
+// Returns a hash of the generator's position: two generators with the same hash will almost surely produce the same outputs.
+// 
+// PRE: none
+// POST: none
+uint64_t
+Random::getHash() const
+{
+    return state ^ increment * PCG_MULTIPLIER;
+}
+
+// Returns the state of the underlying LCG, which with getIncrement() is everything setState() needs to resume from here.
+// 
+// PRE: none
+// POST: none
+uint64_t
+Random::getState() const
+{
+    return state;
+}
+
+// Returns the increment of the underlying LCG, which selects the stream.
+// 
+// PRE: none
+// POST: the return value is odd
+uint64_t
+Random::getIncrement() const
+{
+    return increment;
+}
+
+// Moves the generator to the given state of the LCG with the given increment, as returned by getState() and
+// getIncrement(), so that it produces the same outputs the generator they came from did.
+// 
+// PRE: newIncrement is odd
+// POST: none
+void
+Random::setState( uint64_t newState, uint64_t newIncrement )
+{
+    // Assert the preconditions
+    assert( newIncrement & 1 );
+
+    state = newState;
+    increment = newIncrement;
+}
@@ -0,0 +1,793 @@
+#include <algorithm>
+#include <assert.h>
+#include <stdio.h>
+#include "replay.hpp"
+using namespace std;
+
+// Destroys the recorder.
+// 
+// PRE: none
+// POST: none
+DecisionRecorder::~DecisionRecorder()
+{
+}
+
+// Starts a session of the replay file on the given writer, storing a keyframe every keyframeInterval rounds of each game,
+// or none if it is 0.
+// 
+// PRE: out is open, and must outlive the recorder; keyframeInterval >= 0
+// POST: none
+ReplayRecorder::ReplayRecorder( BufferedWriter& writer, int keyframeInterval )
+    : out( writer ), bits( writer )
+{
+    // Assert the preconditions
+    assert( keyframeInterval >= 0 );
+
+    this->keyframeInterval = keyframeInterval;
+    sessionStart = out.getBytesWritten();
+    gameTurn = 0;
+    gameRound = 0;
+    finished = false;
+    bits.write( REPLAY_MAGIC, REPLAY_MAGIC_BITS );
+    bits.write( REPLAY_VERSION, REPLAY_VERSION_BITS );
+    bits.write( keyframeInterval, REPLAY_COUNT_BITS );
+}
+
+// Finishes the session, if finish() has not already.
+// 
+// PRE: none
+// POST: none
+ReplayRecorder::~ReplayRecorder()
+{
+    finish();
+}
+
+// Records the start of a game. Every turn and decision recorded until the next game belongs to it, in the order played.
+// 
+// PRE: 2 <= header.nPlayers <= MAX_PLAYERS; header.goalScore >= 1; header.maxTurnsPerRound >= 0;
+//      finish() has not been called
+// POST: none
+void
+ReplayRecorder::beginGame( const ReplayHeader& header )
+{
+    // Assert the preconditions
+    assert( !finished );
+    assert( header.nPlayers >= 2 );
+    assert( header.nPlayers <= MAX_PLAYERS );
+    assert( header.goalScore >= 1 );
+    assert( header.maxTurnsPerRound >= 0 );
+
+    // Each game starts on a byte boundary, so the index can point at it, with a set bit;
+    // the end of the session starts with a clear one
+    bits.alignToByte();
+    gameOffsets.push_back( getOffset() );
+    gameKeyframes.push_back( keyframeOffsets.size() );
+    gameTurn = 0;
+    gameRound = 0;
+
+    bits.write( 1, 1 );
+    bits.write( header.seed, 64 );
+    bits.write( header.stream, 64 );
+    bits.write( header.nPlayers, REPLAY_PLAYER_BITS );
+    bits.write( header.goalScore, REPLAY_GOAL_BITS );
+    bits.write( header.maxTurnsPerRound, REPLAY_TURN_LIMIT_BITS );
+    bits.write( header.lazyShuffle, 1 );
+}
+
+// Records the start of a round of the current game, and stores a keyframe of the given state if one is due.
+// The caller must call this before each round is dealt, for keyframes to land where Replayer expects them.
+// 
+// PRE: state is the game's position before the round is dealt, so no player has reached the goal score
+// POST: none
+void
+ReplayRecorder::beginRound( const GameState& state )
+{
+    if ( !finished && keyframeInterval > 0 && gameRound > 0 && gameRound % keyframeInterval == 0 )
+    {
+        bits.alignToByte();
+        keyframeOffsets.push_back( getOffset() );
+        keyframeTurns.push_back( gameTurn );
+        const Random& generator = state.getTable().getGenerator();
+        bits.write( generator.getState(), REPLAY_GENERATOR_BITS );
+        bits.write( generator.getIncrement(), REPLAY_GENERATOR_BITS );
+
+        // A score below the goal fits in as many bits as a choice among that many moves
+        int scoreBits = getChoiceBits( state.getGoalScore() );
+        for ( int playerIndex = 0; playerIndex < state.getPlayerCount(); playerIndex++ )
+        {
+            assert( state.getPlayer( playerIndex ).getScore() < state.getGoalScore() );
+            bits.write( state.getPlayer( playerIndex ).getScore(), scoreBits );
+        }
+    }
+    gameRound++;
+}
+
+// Records the start of a turn of the current game.
+// The caller must call this before each turn, once the round is dealt, so that keyframes are indexed by the right turn.
+// 
+// PRE: none
+// POST: none
+void
+ReplayRecorder::beginTurn()
+{
+    gameTurn++;
+}
+
+// Records that the current player chose the given move from the given legal moves.
+// 
+// PRE: move is in moves; moves is the full list of legal moves, in the order legalMoves() gave them
+// POST: none
+void
+ReplayRecorder::recordDecision( const Game&, const MoveList& moves, Move move )
+{
+    // Assert the preconditions
+    assert( moves.find( move ) >= 0 );
+
+    // A forced move is implied by the position, so it takes no bits at all
+    int nBits = getChoiceBits( moves.getSize() );
+    if ( !finished && nBits > 0 )
+    {
+        bits.write( moves.find( move ), nBits );
+    }
+}
+
+// Ends the session, writes its index and trailer, and flushes it to the file, so it can be replayed complete.
+// Further games and decisions are ignored.
+// 
+// PRE: none
+// POST: every game of the session has reached the file
+void
+ReplayRecorder::finish()
+{
+    if ( finished )
+    {
+        return;
+    }
+
+    // End the games with a clear bit where the next game's set bit would have been
+    bits.alignToByte();
+    bits.write( 0, 1 );
+    bits.alignToByte();
+
+    // Write the index
+    uint64_t indexOffset = getOffset();
+    bits.write( gameOffsets.size(), REPLAY_COUNT_BITS );
+    bits.write( keyframeOffsets.size(), REPLAY_COUNT_BITS );
+    for ( size_t i = 0; i < gameOffsets.size(); i++ )
+    {
+        bits.write( gameOffsets[ i ], REPLAY_OFFSET_BITS );
+        bits.write( gameKeyframes[ i ], REPLAY_COUNT_BITS );
+    }
+    for ( size_t i = 0; i < keyframeOffsets.size(); i++ )
+    {
+        bits.write( keyframeOffsets[ i ], REPLAY_OFFSET_BITS );
+        bits.write( keyframeTurns[ i ], REPLAY_COUNT_BITS );
+    }
+    bits.alignToByte();
+
+    // Write the trailer, which a reader finds from the end of the session
+    uint64_t sessionLength = getOffset() + REPLAY_TRAILER_BYTES;
+    bits.write( indexOffset, REPLAY_OFFSET_BITS );
+    bits.write( sessionLength, REPLAY_OFFSET_BITS );
+    bits.write( REPLAY_INDEX_MAGIC, REPLAY_MAGIC_BITS );
+    bits.alignToByte();
+    out.flush();
+    finished = true;
+}
+
+// Returns the number of bits needed to tell apart the given number of choices.
+// 
+// PRE: nChoices >= 1
+// POST: none
+int
+ReplayRecorder::getChoiceBits( int nChoices )
+{
+    // Assert the preconditions
+    assert( nChoices >= 1 );
+
+    int nBits = 0;
+    while ( ( uint64_t( 1 ) << nBits ) < uint64_t( nChoices ) )
+    {
+        nBits++;
+    }
+
+    return nBits;
+}
+
+// Returns the number of bytes written since the session started.
+// 
+// PRE: the bit stream is at a byte boundary, so every byte of it has reached the writer
+// POST: none
+uint64_t
+ReplayRecorder::getOffset() const
+{
+    return out.getBytesWritten() - sessionStart;
+}
+
+// Initializes an agent that lets the given agent decide and records its decisions with the given recorder.
+// 
+// PRE: inner and recorder must outlive the agent
+// POST: none
+RecordingAgent::RecordingAgent( PlayerAgent& innerAgent, DecisionRecorder& decisionRecorder )
+    : inner( innerAgent ), recorder( decisionRecorder )
+{
+}
+
+// Asks the inner agent for a move and records it.
+// 
+// PRE: moves is not empty
+// POST: none
+Move
+RecordingAgent::chooseMove( const Game& game, const MoveList& moves )
+{
+    Move move = inner.chooseMove( game, moves );
+    recorder.recordDecision( game, moves, move );
+    return move;
+}
+
+// Initializes a replayer with nothing to replay.
+// 
+// PRE: none
+// POST: replayNext() and seek() will return false until a file is opened
+Replayer::Replayer()
+    : bits( NULL, 0 ), state( 2, 1 )
+{
+    header = ReplayHeader();
+    nDecisions = 0;
+    keyframeInterval = 0;
+    gameTurn = 0;
+    gameRound = 0;
+    inSession = false;
+    inGame = false;
+    inRound = false;
+    turnStarted = false;
+    indexed = false;
+    corrupt = false;
+}
+
+// Reads the whole replay file at the given path into memory and indexes its games, to replay them from the start.
+// Returns false if the file cannot be read.
+// 
+// PRE: none
+// POST: getDecisionCount() == 0
+bool
+Replayer::open( const string& path )
+{
+    data.clear();
+    nDecisions = 0;
+    inSession = false;
+    inGame = false;
+    corrupt = false;
+
+    FILE* file = fopen( path.c_str(), "rb" );
+    if ( file == NULL )
+    {
+        bits = BitReader( NULL, 0 );
+        buildIndex();
+        return false;
+    }
+    unsigned char chunk[ 1 << 16 ];
+    size_t nRead;
+    while ( ( nRead = fread( chunk, 1, sizeof( chunk ), file ) ) > 0 )
+    {
+        data.insert( data.end(), chunk, chunk + nRead );
+    }
+    fclose( file );
+
+    bits = BitReader( data.data(), data.size() );
+    buildIndex();
+    return true;
+}
+
+// Plays the next game of the file from its first deal until it is over, exactly as it was first played.
+// If seek() left a game part way through, that game is finished first, and the one after it is played.
+// Returns false at the end of the file, or if the rest of it cannot be replayed.
+// 
+// PRE: none
+// POST: if the return value is true, getState() is the final position of the game and getHeader() describes it
+bool
+Replayer::replayNext()
+{
+    while ( inGame && playTurn() )
+    {
+    }
+    if ( corrupt || !beginGame() )
+    {
+        return false;
+    }
+    while ( playTurn() )
+    {
+    }
+
+    return !corrupt;
+}
+
+// Moves to the start of the given turn of the given game, counting from 0 across every round of the game.
+// Loads the last keyframe at or before the turn, if the game has one, and replays the turns after it.
+// Returns false if the file has no index, the game does not exist, or the game ends before the turn.
+// 
+// PRE: none
+// POST: if the return value is true, getState() is the position at the start of the turn (dealt, if it starts a round),
+//       or the final position if the turn is the number of turns the game took; getTurn() == turn
+bool
+Replayer::seek( int gameIndex, int turn )
+{
+    if ( !indexed || gameIndex < 0 || gameIndex >= int( games.size() ) || turn < 0 )
+    {
+        return false;
+    }
+
+    // Read the game's header, as if the session had just reached it
+    const GameEntry& entry = games[ gameIndex ];
+    corrupt = false;
+    bits.seek( entry.offset * 8 );
+    inSession = true;
+    keyframeInterval = entry.keyframeInterval;
+    if ( !beginGame() )
+    {
+        return false;
+    }
+
+    // Find the last keyframe at or before the turn; the first was taken before round keyframeInterval, and so on
+    // Starting the round there loads it in place of the rounds before
+    for ( int keyframeIndex = entry.nKeyframes - 1; keyframeIndex >= 0; keyframeIndex-- )
+    {
+        const KeyframeEntry& keyframe = keyframes[ entry.firstKeyframe + keyframeIndex ];
+        if ( keyframe.turn <= turn )
+        {
+            bits.seek( keyframe.offset * 8 );
+            gameTurn = keyframe.turn;
+            gameRound = ( keyframeIndex + 1 ) * entry.keyframeInterval;
+            break;
+        }
+    }
+
+    // Replay the turns from there
+    while ( gameTurn < turn )
+    {
+        if ( !playTurn() )
+        {
+            return false;
+        }
+    }
+    if ( !turnStarted )
+    {
+        startTurn();
+    }
+
+    return !corrupt;
+}
+
+// Plays the next turn of the current game: every decision the current player made until their turn ended,
+// then the scoring of the round if it ended.
+// Returns false if the game is over, or the rest of it cannot be replayed.
+// 
+// PRE: none
+// POST: if the return value is true, getTurn() has increased by 1
+bool
+Replayer::playTurn()
+{
+    if ( !inGame || corrupt || ( !turnStarted && !startTurn() ) )
+    {
+        return false;
+    }
+
+    // Play every decision of the turn
+    int turn = state.getTurnNumber();
+    MoveList moves;
+    while ( state.getTurnNumber() == turn )
+    {
+        Move move;
+        state.legalMoves( moves );
+        if ( !readDecision( moves, move ) )
+        {
+            corrupt = true;
+            return false;
+        }
+        state.apply( move );
+    }
+    gameTurn++;
+    turnStarted = false;
+
+    // End the round if it is over, just as the game was played through Game, or abandon it if it reached the turn limit
+    if ( state.roundIsOver() )
+    {
+        state.scoreRound();
+        inRound = false;
+    }
+    else if ( header.maxTurnsPerRound > 0 && state.getTurnNumber() >= header.maxTurnsPerRound )
+    {
+        inRound = false;
+    }
+
+    return true;
+}
+
+// Returns the position reached by the last call to replayNext(), seek(), or playTurn().
+// 
+// PRE: none
+// POST: none
+const GameState&
+Replayer::getState() const
+{
+    return state;
+}
+
+// Returns the header of the current game.
+// 
+// PRE: replayNext() or seek() has returned true
+// POST: none
+const ReplayHeader&
+Replayer::getHeader() const
+{
+    return header;
+}
+
+// Returns the number of turns of the current game played so far, counting every round.
+// 
+// PRE: none
+// POST: none
+int
+Replayer::getTurn() const
+{
+    return gameTurn;
+}
+
+// Returns the number of games in the file's index.
+// 
+// PRE: none
+// POST: none
+int
+Replayer::getGameCount() const
+{
+    return games.size();
+}
+
+// Returns the number of decisions replayed since the file was opened, including those with only one legal move.
+// 
+// PRE: none
+// POST: none
+uint64_t
+Replayer::getDecisionCount() const
+{
+    return nDecisions;
+}
+
+// Returns true if every session of the file ends with an index, so that seek() can find any game in it.
+// A session that never finished (e.g. because its process died) has no index, though its games may still be replayed.
+// 
+// PRE: none
+// POST: none
+bool
+Replayer::isIndexed() const
+{
+    return indexed;
+}
+
+// Returns true if replaying stopped because the file was cut off or is not a replay file, rather than at its end.
+// 
+// PRE: none
+// POST: none
+bool
+Replayer::isCorrupt() const
+{
+    return corrupt;
+}
+
+// Reads the header of a session, which must start at the current position.
+// Returns false at the end of the file, or if there is no session there.
+// 
+// PRE: the current position is a byte boundary
+// POST: none
+bool
+Replayer::beginSession()
+{
+    if ( !bits.canRead( 1 ) )
+    {
+        return false;
+    }
+    if ( !bits.canRead( REPLAY_MAGIC_BITS + REPLAY_VERSION_BITS + REPLAY_COUNT_BITS )
+         || bits.read( REPLAY_MAGIC_BITS ) != REPLAY_MAGIC || bits.read( REPLAY_VERSION_BITS ) != REPLAY_VERSION )
+    {
+        corrupt = true;
+        return false;
+    }
+    keyframeInterval = bits.read( REPLAY_COUNT_BITS );
+    inSession = true;
+    return true;
+}
+
+// Reads the header of the next game and sets up its first position, skipping past the ends of sessions.
+// Returns false at the end of the file, or if the rest of it cannot be read.
+// 
+// PRE: the current position is the end of a game, or of a session
+// POST: none
+bool
+Replayer::beginGame()
+{
+    while ( true )
+    {
+        if ( !inSession && !beginSession() )
+        {
+            return false;
+        }
+
+        // A game starts with a set bit; a clear one ends the session, and its index and trailer follow
+        bits.alignToByte();
+        if ( !bits.canRead( 1 ) )
+        {
+            corrupt = true;
+            return false;
+        }
+        if ( bits.read( 1 ) == 1 )
+        {
+            break;
+        }
+        bits.alignToByte();
+        if ( !bits.canRead( 2 * REPLAY_COUNT_BITS ) )
+        {
+            corrupt = true;
+            return false;
+        }
+        size_t nEntries = bits.read( REPLAY_COUNT_BITS );
+        nEntries += bits.read( REPLAY_COUNT_BITS );
+        size_t nIndexBits = nEntries * ( REPLAY_OFFSET_BITS + REPLAY_COUNT_BITS ) + REPLAY_TRAILER_BYTES * 8;
+        if ( !bits.canRead( nIndexBits ) )
+        {
+            corrupt = true;
+            return false;
+        }
+        bits.seek( bits.getBitPosition() + nIndexBits );
+        inSession = false;
+    }
+
+    // Read the header
+    if ( !bits.canRead( 128 + REPLAY_PLAYER_BITS + REPLAY_GOAL_BITS + REPLAY_TURN_LIMIT_BITS + 1 ) )
+    {
+        corrupt = true;
+        return false;
+    }
+    header.seed = bits.read( 64 );
+    header.stream = bits.read( 64 );
+    header.nPlayers = bits.read( REPLAY_PLAYER_BITS );
+    header.goalScore = bits.read( REPLAY_GOAL_BITS );
+    header.maxTurnsPerRound = bits.read( REPLAY_TURN_LIMIT_BITS );
+    header.lazyShuffle = bits.read( 1 );
+    if ( header.nPlayers < 2 || header.nPlayers > MAX_PLAYERS || header.goalScore < 1 || header.maxTurnsPerRound < 0 )
+    {
+        corrupt = true;
+        return false;
+    }
+
+    state = GameState( header.nPlayers, header.goalScore );
+    state.seed( header.seed, header.stream );
+    state.setLazyShuffle( header.lazyShuffle );
+    gameTurn = 0;
+    gameRound = 0;
+    inGame = true;
+    inRound = false;
+    turnStarted = false;
+    return true;
+}
+
+// Prepares the next turn of the current game: deals a new round if the last one is over, first loading the keyframe
+// stored at the start of the round, if there is one. Returns false if the game is over, or the file is cut off.
+// 
+// PRE: inGame
+// POST: none
+bool
+Replayer::startTurn()
+{
+    if ( !inRound )
+    {
+        if ( state.gameIsOver() )
+        {
+            inGame = false;
+            return false;
+        }
+
+        // Having replayed the rounds before, the state already matches the keyframe; after seek(), it stands in for them
+        if ( keyframeInterval > 0 && gameRound > 0 && gameRound % keyframeInterval == 0 && !readKeyframe() )
+        {
+            corrupt = true;
+            return false;
+        }
+        gameRound++;
+        state.initializeRound();
+        inRound = true;
+
+        // Game::initializeRound() asks the first player to name the color of a wild first stock as part of the deal
+        if ( state.getPhase() == FIRST_COLOR_PHASE )
+        {
+            Move move;
+            MoveList moves;
+            state.legalMoves( moves );
+            if ( !readDecision( moves, move ) )
+            {
+                corrupt = true;
+                return false;
+            }
+            state.apply( move );
+        }
+    }
+
+    turnStarted = true;
+    return true;
+}
+
+// Reads the next decision from among the given legal moves into move.
+// Returns false if the file is cut off or names a move that is not in the list.
+// 
+// PRE: moves is not empty
+// POST: none
+bool
+Replayer::readDecision( const MoveList& moves, Move& move )
+{
+    int nBits = ReplayRecorder::getChoiceBits( moves.getSize() );
+    int index = 0;
+    if ( nBits > 0 )
+    {
+        if ( !bits.canRead( nBits ) )
+        {
+            return false;
+        }
+        index = bits.read( nBits );
+        if ( index >= moves.getSize() )
+        {
+            return false;
+        }
+    }
+
+    move = moves.get( index );
+    nDecisions++;
+    return true;
+}
+
+// Reads the keyframe at the current position, which must start a round, into the state's scores and generator.
+// Returns false if the file is cut off or the keyframe holds a score or generator no game could reach.
+// 
+// PRE: inGame; the current round is over
+// POST: if the return value is true, the state will deal the next round exactly as the recorded game did
+bool
+Replayer::readKeyframe()
+{
+    bits.alignToByte();
+    int scoreBits = ReplayRecorder::getChoiceBits( header.goalScore );
+    if ( !bits.canRead( 2 * REPLAY_GENERATOR_BITS + size_t( header.nPlayers ) * scoreBits ) )
+    {
+        return false;
+    }
+    uint64_t generatorState = bits.read( REPLAY_GENERATOR_BITS );
+    uint64_t generatorIncrement = bits.read( REPLAY_GENERATOR_BITS );
+    int scores[ MAX_PLAYERS ];
+    for ( int playerIndex = 0; playerIndex < header.nPlayers; playerIndex++ )
+    {
+        scores[ playerIndex ] = bits.read( scoreBits );
+    }
+
+    // A generator's increment is always odd, and nobody has reached the goal before a round
+    if ( ( generatorIncrement & 1 ) == 0 )
+    {
+        return false;
+    }
+    for ( int playerIndex = 0; playerIndex < header.nPlayers; playerIndex++ )
+    {
+        if ( scores[ playerIndex ] >= header.goalScore )
+        {
+            return false;
+        }
+    }
+
+    Random generator;
+    generator.setState( generatorState, generatorIncrement );
+    state.setGenerator( generator );
+    for ( int playerIndex = 0; playerIndex < header.nPlayers; playerIndex++ )
+    {
+        state.setScore( playerIndex, scores[ playerIndex ] );
+    }
+    return true;
+}
+
+// Builds the index of every game and keyframe in the file from the index of each session,
+// walking back from the end of the file through the sessions' trailers. If any session has no index, none is built.
+// 
+// PRE: none
+// POST: none
+void
+Replayer::buildIndex()
+{
+    games.clear();
+    keyframes.clear();
+    indexed = false;
+
+    // Find where each session and its index start, last session first
+    vector< size_t > sessionStarts;
+    vector< size_t > indexStarts;
+    size_t end = data.size();
+    while ( end > 0 )
+    {
+        if ( end < size_t( REPLAY_TRAILER_BYTES ) )
+        {
+            return;
+        }
+        BitReader trailer( &data[ end - REPLAY_TRAILER_BYTES ], REPLAY_TRAILER_BYTES );
+        uint64_t indexOffset = trailer.read( REPLAY_OFFSET_BITS );
+        uint64_t sessionLength = trailer.read( REPLAY_OFFSET_BITS );
+        if ( trailer.read( REPLAY_MAGIC_BITS ) != REPLAY_INDEX_MAGIC || sessionLength > end
+             || indexOffset + REPLAY_TRAILER_BYTES > sessionLength )
+        {
+            return;
+        }
+        sessionStarts.push_back( end - sessionLength );
+        indexStarts.push_back( end - sessionLength + indexOffset );
+        end -= sessionLength;
+    }
+
+    // Read the index of each session, first session first
+    for ( int session = int( sessionStarts.size() ) - 1; session >= 0; session-- )
+    {
+        size_t start = sessionStarts[ session ];
+        BitReader sessionHeader( &data[ start ], indexStarts[ session ] - start );
+        if ( !sessionHeader.canRead( REPLAY_MAGIC_BITS + REPLAY_VERSION_BITS + REPLAY_COUNT_BITS )
+             || sessionHeader.read( REPLAY_MAGIC_BITS ) != REPLAY_MAGIC
+             || sessionHeader.read( REPLAY_VERSION_BITS ) != REPLAY_VERSION )
+        {
+            games.clear();
+            keyframes.clear();
+            return;
+        }
+        int sessionKeyframeInterval = sessionHeader.read( REPLAY_COUNT_BITS );
+
+        BitReader index( &data[ indexStarts[ session ] ], data.size() - indexStarts[ session ] );
+        size_t nGames = index.read( REPLAY_COUNT_BITS );
+        size_t nKeyframes = index.read( REPLAY_COUNT_BITS );
+        if ( !index.canRead( ( nGames + nKeyframes ) * ( REPLAY_OFFSET_BITS + REPLAY_COUNT_BITS ) ) )
+        {
+            games.clear();
+            keyframes.clear();
+            return;
+        }
+        size_t firstGame = games.size();
+        size_t firstKeyframe = keyframes.size();
+        for ( size_t i = 0; i < nGames; i++ )
+        {
+            GameEntry entry;
+            entry.offset = start + index.read( REPLAY_OFFSET_BITS );
+            entry.firstKeyframe = firstKeyframe + index.read( REPLAY_COUNT_BITS );
+            entry.keyframeInterval = sessionKeyframeInterval;
+            games.push_back( entry );
+        }
+        for ( size_t i = 0; i < nKeyframes; i++ )
+        {
+            KeyframeEntry entry;
+            entry.offset = start + index.read( REPLAY_OFFSET_BITS );
+            entry.turn = index.read( REPLAY_COUNT_BITS );
+            keyframes.push_back( entry );
+        }
+
+        // Each game's keyframes run up to the next game's first one; every entry must point inside the session
+        for ( size_t i = firstGame; i < games.size(); i++ )
+        {
+            int nextKeyframe = i + 1 < games.size() ? games[ i + 1 ].firstKeyframe : int( keyframes.size() );
+            games[ i ].nKeyframes = nextKeyframe - games[ i ].firstKeyframe;
+            if ( games[ i ].offset >= indexStarts[ session ] || games[ i ].firstKeyframe < int( firstKeyframe )
+                 || games[ i ].nKeyframes < 0 || ( games[ i ].nKeyframes > 0 && sessionKeyframeInterval <= 0 ) )
+            {
+                games.clear();
+                keyframes.clear();
+                return;
+            }
+        }
+        for ( size_t i = firstKeyframe; i < keyframes.size(); i++ )
+        {
+            if ( keyframes[ i ].offset >= indexStarts[ session ] || keyframes[ i ].turn < 0 )
+            {
+                games.clear();
+                keyframes.clear();
+                return;
+            }
+        }
+    }
+
+    indexed = true;
+}
@@ -0,0 +1,194 @@
+#include <assert.h>
+#include <stdlib.h>
+#include "solver.hpp"
+using namespace std;
+
+// Greater than the magnitude of any value
+const int INFINITE_VALUE = 32000;
+
+// The depth of the first iteration and how much deeper each one goes
+const int SOLVER_DEPTH_STEP = 4;
+
+// Initializes a solver with a transposition table of 2 ^ log2TableSize slots (see TranspositionTable)
+// that never searches more than maxDepth moves ahead.
+// 
+// PRE: 1 <= log2TableSize <= 30; 1 <= maxDepth <= MAX_SOLVER_DEPTH
+// POST: none
+EndgameSolver::EndgameSolver( int log2TableSize, int maxDepth )
+    : table( log2TableSize )
+{
+    // Assert the preconditions
+    assert( maxDepth >= 1 );
+    assert( maxDepth <= MAX_SOLVER_DEPTH );
+
+    this->maxDepth = maxDepth;
+    rootIndex = 0;
+    rootKey = 0;
+    nodes = 0;
+}
+
+// Returns true if no hand holds more than the given number of cards, which is when solving is usually quick.
+// 
+// PRE: round should be initialized
+// POST: none
+bool
+EndgameSolver::isEndgame( const GameState& state, int maxHandSize )
+{
+    for ( int playerIndex = 0; playerIndex < state.getPlayerCount(); playerIndex++ )
+    {
+        if ( state.getPlayer( playerIndex ).getHand().getSize() > maxHandSize )
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Solves the round from the given position for its current player.
+// Each iteration searches a few moves deeper than the last, until one follows every line to the end of the round
+// or the depth cap is reached; the moves that were best in shallower iterations are searched first in deeper ones.
+// 
+// PRE: root's round is initialized and not over
+// POST: result.bestMove is one of root's legal moves
+SolverResult
+EndgameSolver::solve( const GameState& root )
+{
+    // Assert the preconditions
+    assert( !root.roundIsOver() );
+
+    GameState state = root;
+    rootIndex = state.getCurrentPlayerIndex();
+    rootKey = mixKey( uint64_t( rootIndex + 1 ) << 32 );
+    nodes = 0;
+
+    SolverResult result;
+    int value = 0;
+    for ( int depth = SOLVER_DEPTH_STEP; ; depth += SOLVER_DEPTH_STEP )
+    {
+        result.depth = min( depth, maxDepth );
+        value = search( state, result.depth, -INFINITE_VALUE, INFINITE_VALUE, result.exact );
+        if ( result.exact || result.depth == maxDepth )
+        {
+            break;
+        }
+    }
+
+    // A value's sign is the outcome, and its magnitude is one more than the points the round is worth
+    result.outcome = value > 0 ? 1 : value < 0 ? -1 : 0;
+    result.scoreSwing = value == 0 ? 0 : abs( value ) - 1;
+    result.nodes = nodes;
+
+    // The root's entry holds the best move, unless another position has taken its slot since
+    MoveList moves;
+    state.legalMoves( moves );
+    TranspositionEntry entry;
+    bool found = table.probe( state.getHash() ^ state.getTable().getDrawHash() ^ rootKey, entry );
+    result.bestMove = moves.get( found && entry.moveIndex < moves.getSize() ? entry.moveIndex : 0 );
+
+    return result;
+}
+
+// Searches the given position to the given depth within the window ( alpha, beta ) and returns its value to the root
+// player: positive if they win, negative if they lose, and 0 if the depth ran out before the round was decided.
+// resolved is set to whether the value is final, i.e. no line that decided it reached the depth cap.
+// 
+// PRE: depth >= 0; alpha < beta
+// POST: state is unchanged
+int
+EndgameSolver::search( GameState& state, int depth, int alpha, int beta, bool& resolved )
+{
+    nodes++;
+
+    // A finished round is worth one more than its score, so that a win is never worth 0
+    if ( state.roundIsOver() )
+    {
+        resolved = true;
+        int roundScore = 0;
+        for ( int playerIndex = 0; playerIndex < state.getPlayerCount(); playerIndex++ )
+        {
+            roundScore += state.getPlayer( playerIndex ).getHand().getScore();
+        }
+        return state.getRoundWinnerIndex() == rootIndex ? roundScore + 1 : -( roundScore + 1 );
+    }
+    if ( depth == 0 )
+    {
+        resolved = false;
+        return 0;
+    }
+
+    // Use what is known about the position if it was searched at least this deep, or was solved
+    uint64_t hash = state.getHash() ^ state.getTable().getDrawHash() ^ rootKey;
+    TranspositionEntry entry;
+    int rememberedIndex = NO_MOVE_INDEX;
+    if ( table.probe( hash, entry ) )
+    {
+        rememberedIndex = entry.moveIndex;
+        if ( entry.depth >= depth )
+        {
+            if ( entry.bound == EXACT_BOUND
+                || ( entry.bound == LOWER_BOUND && entry.value >= beta )
+                || ( entry.bound == UPPER_BOUND && entry.value <= alpha ) )
+            {
+                resolved = entry.depth == SOLVED_DEPTH;
+                return entry.value;
+            }
+        }
+    }
+
+    // Search the remembered best move first, then the rest in order: plays before drawing
+    MoveList moves;
+    state.legalMoves( moves );
+    int order[ MAX_MOVES ];
+    int nOrdered = 0;
+    if ( rememberedIndex < moves.getSize() )
+    {
+        order[ nOrdered++ ] = rememberedIndex;
+    }
+    for ( int moveIndex = 0; moveIndex < moves.getSize(); moveIndex++ )
+    {
+        if ( moveIndex != rememberedIndex )
+        {
+            order[ nOrdered++ ] = moveIndex;
+        }
+    }
+
+    // The root player maximizes the value and every opponent minimizes it
+    bool maximizing = state.getCurrentPlayerIndex() == rootIndex;
+    int originalAlpha = alpha;
+    int originalBeta = beta;
+    int bestValue = maximizing ? -INFINITE_VALUE : INFINITE_VALUE;
+    int bestIndex = order[ 0 ];
+    resolved = true;
+    for ( int i = 0; i < nOrdered && alpha < beta; i++ )
+    {
+        bool childResolved;
+        UndoRecord record = state.apply( moves.get( order[ i ] ) );
+        int value = search( state, depth - 1, alpha, beta, childResolved );
+        state.undo( record );
+        resolved = resolved && childResolved;
+
+        if ( maximizing ? value > bestValue : value < bestValue )
+        {
+            bestValue = value;
+            bestIndex = order[ i ];
+        }
+        if ( maximizing )
+        {
+            alpha = max( alpha, value );
+        }
+        else
+        {
+            beta = min( beta, value );
+        }
+    }
+
+    // Remember the result, and whether it is a bound because the window cut the search short
+    entry.value = bestValue;
+    entry.depth = resolved ? SOLVED_DEPTH : depth;
+    entry.bound = bestValue <= originalAlpha ? UPPER_BOUND : bestValue >= originalBeta ? LOWER_BOUND : EXACT_BOUND;
+    entry.moveIndex = bestIndex;
+    table.store( hash, entry );
+
+    return bestValue;
+}
@@ -0,0 +1,1069 @@
+#include <assert.h>
+#include "state.hpp"
+using namespace std;
+
+// The number of bits each seat's hand hash is rotated by more than the previous seat's
+// It is odd, so every one of up to 64 seats gets a different rotation
+const int SEAT_HASH_ROTATION = 11;
+
+// Initializes the state of a game between the given number of players, played to the given goal score.
+// 
+// PRE: 2 <= nPlayers <= Limits::MAX_SEATS
+//      goalScore >= 1
+// POST: every player has a score of 0 and an empty hand; the round must be initialized before play
+template < class Rules, class Limits >
+BasicGameState< Rules, Limits >::BasicGameState( int nPlayers, int goalScore )
+{
+    // Assert the preconditions
+    assert( nPlayers >= 2 );
+    assert( nPlayers <= Limits::MAX_SEATS );
+    assert( goalScore >= 1 );
+
+    this->nPlayers = nPlayers;
+    this->goalScore = goalScore;
+    currentPlayerIndex = 0;
+    reverse = false;
+    skip = false;
+    wildColor = NO_COLOR_INDEX;
+    phase = PLAY_PHASE;
+    turnNumber = 0;
+    pendingPenalty = 0;
+    jumpTurnIndex = 0;
+    jumpPlayerIndex = 0;
+}
+
+// Seeds the random number generator used to shuffle the deck.
+// A game is fully determined by its seed, stream, and the decisions of its players.
+// 
+// PRE: none
+// POST: none
+template < class Rules, class Limits >
+void
+BasicGameState< Rules, Limits >::seed( uint64_t seedValue, uint64_t stream )
+{
+    table.seed( seedValue, stream );
+}
+
+// Sets whether the deck is shuffled lazily, one card per draw, rather than all at once at the start of each round.
+// See Table::setLazyShuffle().
+// 
+// PRE: none
+// POST: none
+template < class Rules, class Limits >
+void
+BasicGameState< Rules, Limits >::setLazyShuffle( bool lazy )
+{
+    table.setLazyShuffle( lazy );
+}
+
+// Replaces the generator the table shuffles with. Between rounds, the generator and the scores are all that is left of
+// the rounds before, so setting them resumes a game where it left off. See Table::setGenerator().
+// 
+// PRE: none
+// POST: the next round is dealt as the given generator would deal it
+template < class Rules, class Limits >
+void
+BasicGameState< Rules, Limits >::setGenerator( const Random& generator )
+{
+    table.setGenerator( generator );
+}
+
+// Sets the score of the given player.
+// 
+// PRE: 0 <= playerIndex < getPlayerCount(); score >= 0
+// POST: getPlayer( playerIndex ).getScore() == score
+template < class Rules, class Limits >
+void
+BasicGameState< Rules, Limits >::setScore( int playerIndex, int score )
+{
+    // Assert the preconditions
+    assert( playerIndex >= 0 );
+    assert( playerIndex < nPlayers );
+
+    players[ playerIndex ].setScore( score );
+}
+
+// Initializes the game for a round.
+// 
+// PRE: none
+// POST: table, currentPlayerIndex, reverse, skip, and wildColor will be initialized
+//       all players' hands will be cleared and they will be dealt new cards
+//       if the first stock is a Wild card, phase == FIRST_COLOR_PHASE
+template < class Rules, class Limits >
+void
+BasicGameState< Rules, Limits >::initializeRound()
+{
+    // Initialize fields
+    table.initialize();
+    currentPlayerIndex = 0;
+    reverse = false;
+    skip = false;
+    wildColor = NO_COLOR_INDEX;
+    phase = PLAY_PHASE;
+    turnNumber = 0;
+    pendingPenalty = 0;
+
+    // Empty each player's hand
+    for ( int playerIndex = 0; playerIndex < nPlayers; playerIndex++ )
+    {
+        players[ playerIndex ].getHand().clear();
+    }
+
+    // Deal cards to each player
+    for ( int card = 0; card < STARTING_HAND_SIZE; card++ )
+    {
+        for ( int playerIndex = 0; playerIndex < nPlayers; playerIndex++ )
+        {
+            players[ playerIndex ].drawCard( table );
+        }
+    }
+
+    // Apply the effects of the stock to the first player
+    // Optimally, processCardAction() would be used for this, but it depends on other variables initialized in this function
+    Player& firstPlayer = players[ 0 ];
+    switch ( table.getStock().getValue() )
+    {
+        // First player draws 2 cards, and loses their turn if a Draw2 skips
+        case DRAW2_INDEX:
+            firstPlayer.drawCards( 2, table );
+            if constexpr ( Rules::DRAW2_SKIPS )
+            {
+                currentPlayerIndex = getNextPlayerIndex();
+            }
+            break;
+        // Play is reversed following the first player's turn
+        case REVERSE_INDEX:
+            reverse = !reverse;
+            break;
+        // First player is skipped
+        case SKIP_INDEX:
+            skip = true;
+            break;
+        // First player may choose the color of the Wild card
+        // Their first move names the color, after which their turn begins as usual
+        case WILD_INDEX:
+            phase = FIRST_COLOR_PHASE;
+            break;
+    }
+}
+
+// Returns the player who will take their turn next.
+// 
+// PRE: the round should have been initialized
+// POST: none
+template < class Rules, class Limits >
+int
+BasicGameState< Rules, Limits >::getNextPlayerIndex() const
+{
+    // Determine the player increment (the difference between the current player's index and the next player's)
+    int playerIncrement = reverse ? -1 : 1;
+    int nextPlayerIndex = currentPlayerIndex + playerIncrement;
+    if ( skip )
+    {
+        // To skip the player who would normally be next, just increment one more time
+        nextPlayerIndex += playerIncrement;
+    }
+
+    // If nextPlayerIndex is negative, manually wrap it by adding nPlayers
+    if ( nextPlayerIndex < 0 )
+    {
+        while ( nextPlayerIndex < 0 )
+        {
+            nextPlayerIndex += nPlayers;
+        }
+    }
+    // If nextPlayerIndex is positive, simply wrap it with a mod operation
+    else
+    {
+        nextPlayerIndex %= nPlayers;
+    }
+
+    return nextPlayerIndex;
+}
+
+// Sets the current player to the next player in the turn sequence.
+// 
+// PRE: round should be initialized
+// POST: skip will be set to false
+template < class Rules, class Limits >
+void
+BasicGameState< Rules, Limits >::nextPlayer()
+{
+    currentPlayerIndex = getNextPlayerIndex();
+    skip = false;
+}
+
+// Returns the set of cards in the current player's hand that they may legally play.
+// A Draw4 Wild may only be played if the player has no cards of the current color (the stock's, or the color named for it).
+// 
+// PRE: round should be initialized; phase != FIRST_COLOR_PHASE
+// POST: none
+template < class Rules, class Limits >
+CardMask
+BasicGameState< Rules, Limits >::legalPlayMask() const
+{
+    const Hand& hand = players[ currentPlayerIndex ].getHand();
+    Card stock = table.getStock();
+    CardMask playable = hand.playableMask( stock, wildColor );
+
+    int currentColor = stock.isWild() ? wildColor : stock.getColor();
+    if ( ( hand.getMask() & Card::TABLES.colorMasks[ currentColor ] ) != 0 )
+    {
+        playable &= ~( CardMask( 1 ) << cardId( NO_COLOR_INDEX, DRAW4_WILD_INDEX ) );
+    }
+
+    return playable;
+}
+
+// Fills the given list with every move the current player may make.
+// A wild card appears once for each color that may be named for it.
+// 
+// PRE: round should be initialized and not over
+// POST: moves will not be empty
+template < class Rules, class Limits >
+void
+BasicGameState< Rules, Limits >::legalMoves( MoveList& moves ) const
+{
+    moves.clear();
+
+    switch ( phase )
+    {
+        // Any color may be named for the first stock
+        case FIRST_COLOR_PHASE:
+            for ( int color = 0; color < N_COLORS; color++ )
+            {
+                moves.add( Move::chooseColor( color ) );
+            }
+            break;
+        // The drawn card can always be kept; it is only in this phase if it can be played
+        case DRAWN_CARD_PHASE:
+            if ( drawnCard.isWild() )
+            {
+                for ( int color = 0; color < N_COLORS; color++ )
+                {
+                    moves.add( Move::playDrawn( drawnCard, color ) );
+                }
+            }
+            else
+            {
+                moves.add( Move::playDrawn( drawnCard, NO_COLOR_INDEX ) );
+            }
+            moves.add( Move::keepDrawn() );
+            break;
+        // A stacked penalty may be passed on with any card of the same kind as the stock, or accepted by drawing
+        case PENALTY_PHASE:
+        {
+            const Hand& hand = players[ currentPlayerIndex ].getHand();
+            int penaltyValue = table.getStock().getValue();
+            for ( CardMask stackable = hand.getMask(); stackable != 0; stackable &= stackable - 1 )
+            {
+                Card card = Card::fromId( lowestCardId( stackable ) );
+                if ( card.getValue() != penaltyValue )
+                {
+                    continue;
+                }
+                if ( card.isWild() )
+                {
+                    for ( int color = 0; color < N_COLORS; color++ )
+                    {
+                        moves.add( Move::playCard( card, color ) );
+                    }
+                }
+                else
+                {
+                    moves.add( Move::playCard( card, NO_COLOR_INDEX ) );
+                }
+            }
+            moves.add( Move::drawCard() );
+            break;
+        }
+        // The player must keep drawing
+        case FORCED_DRAW_PHASE:
+            moves.add( Move::drawCard() );
+            break;
+        // Any other player may be chosen
+        case SWAP_PHASE:
+            for ( int playerIndex = 0; playerIndex < nPlayers; playerIndex++ )
+            {
+                if ( playerIndex != currentPlayerIndex )
+                {
+                    moves.add( Move::swapHands( playerIndex ) );
+                }
+            }
+            break;
+        // The player holds a card identical to the stock, which is never wild
+        case JUMP_IN_PHASE:
+            moves.add( Move::playCard( table.getStock(), NO_COLOR_INDEX ) );
+            moves.add( Move::pass() );
+            break;
+        // Any legal card may be played, and the player may always draw instead
+        case PLAY_PHASE:
+            for ( CardMask playable = legalPlayMask(); playable != 0; playable &= playable - 1 )
+            {
+                Card card = Card::fromId( lowestCardId( playable ) );
+                if ( card.isWild() )
+                {
+                    for ( int color = 0; color < N_COLORS; color++ )
+                    {
+                        moves.add( Move::playCard( card, color ) );
+                    }
+                }
+                else
+                {
+                    moves.add( Move::playCard( card, NO_COLOR_INDEX ) );
+                }
+            }
+            moves.add( Move::drawCard() );
+            break;
+    }
+}
+
+// Returns true if the current player may play the given card from their hand.
+// 
+// PRE: round should be initialized; phase == PLAY_PHASE
+// POST: none
+template < class Rules, class Limits >
+bool
+BasicGameState< Rules, Limits >::isLegalPlay( Card card ) const
+{
+    return ( legalPlayMask() >> card.getId() ) & 1;
+}
+
+// Makes the given move for the current player, ending their turn unless they drew a card they can play.
+// Returns a record of everything the move changed, which undo() uses to take it back.
+// 
+// PRE: round should be initialized and not over; move must be one of the moves listed by legalMoves()
+// POST: if the turn ended and the round is not over, the next player is the current player
+template < class Rules, class Limits >
+UndoRecord
+BasicGameState< Rules, Limits >::apply( Move move )
+{
+    // Define convenience variables
+    Player& player = players[ currentPlayerIndex ];
+
+    // Save the state the move may change; the hands and piles are restored from the cards it records
+    UndoRecord record;
+    record.move = move;
+    record.table = table.getState();
+    record.drawnCard = drawnCard;
+    record.nDrawn = 0;
+    record.targetIndex = currentPlayerIndex;
+    record.playerIndex = currentPlayerIndex;
+    record.wildColor = wildColor;
+    record.phase = phase;
+    record.pendingPenalty = pendingPenalty;
+    record.jumpTurnIndex = jumpTurnIndex;
+    record.jumpPlayerIndex = jumpPlayerIndex;
+    record.reverse = reverse;
+    record.skip = skip;
+    record.turnNumber = turnNumber;
+
+    switch ( move.getType() )
+    {
+        case PLAY_CARD:
+            assert( phase == PLAY_PHASE || phase == PENALTY_PHASE || phase == JUMP_IN_PHASE );
+            assert( phase != PLAY_PHASE || isLegalPlay( move.getCard() ) );
+            playCard( move.getCard(), move.getColor(), record );
+            endPlay( record.playerIndex );
+            break;
+        case DRAW_CARD:
+            assert( phase == PLAY_PHASE || phase == PENALTY_PHASE || phase == FORCED_DRAW_PHASE );
+
+            // If the table is empty, the player won't be able to draw a card, so their turn is over
+            if ( !table.canDrawCard() )
+            {
+                pendingPenalty = 0;
+                endTurn();
+                break;
+            }
+            drawnCard = player.drawCard( table );
+            record.drawn[ record.nDrawn++ ] = drawnCard;
+
+            // A stacked penalty is drawn one card at a time; once it is drawn, the turn ends if the card skips
+            if ( pendingPenalty > 0 )
+            {
+                pendingPenalty--;
+                bool skips = table.getStock().getValue() == DRAW2_INDEX ? Rules::DRAW2_SKIPS : Rules::DRAW4_SKIPS;
+                if ( pendingPenalty > 0 )
+                {
+                    phase = FORCED_DRAW_PHASE;
+                }
+                else if ( skips )
+                {
+                    endTurn();
+                }
+                else
+                {
+                    phase = PLAY_PHASE;
+                }
+            }
+            // Otherwise, if the player can play the card, they get to decide whether to
+            // If not, they keep drawing if they must and can, and their turn is over otherwise
+            else if ( isLegalPlay( drawnCard ) )
+            {
+                phase = DRAWN_CARD_PHASE;
+            }
+            else if ( Rules::DRAW_UNTIL_PLAYABLE && table.canDrawCard() )
+            {
+                phase = FORCED_DRAW_PHASE;
+            }
+            else
+            {
+                endTurn();
+            }
+            break;
+        case PLAY_DRAWN:
+            assert( phase == DRAWN_CARD_PHASE );
+            assert( move.getCard().isEqual( drawnCard ) );
+            playCard( drawnCard, move.getColor(), record );
+            endPlay( record.playerIndex );
+            break;
+        case KEEP_DRAWN:
+            assert( phase == DRAWN_CARD_PHASE );
+            endTurn();
+            break;
+        case CHOOSE_COLOR:
+            assert( phase == FIRST_COLOR_PHASE );
+            assert( move.getColor() < N_COLORS );
+
+            // Naming the color does not use up the first player's turn
+            wildColor = move.getColor();
+            phase = PLAY_PHASE;
+            break;
+        case SWAP_HANDS:
+            assert( phase == SWAP_PHASE );
+            assert( move.getTarget() != currentPlayerIndex );
+            assert( move.getTarget() < nPlayers );
+
+            // The 7 has now had its effect, so the play can end
+            swap( player.getHand(), players[ move.getTarget() ].getHand() );
+            record.targetIndex = move.getTarget();
+            phase = PLAY_PHASE;
+            endPlay( record.playerIndex );
+            break;
+        case PASS:
+        {
+            assert( phase == JUMP_IN_PHASE );
+
+            // Offer the jump to the next player who could make it, or go back to the player whose turn it is
+            int jumperIndex = findJumpIn( currentPlayerIndex );
+            turnNumber++;
+            currentPlayerIndex = jumperIndex != -1 ? jumperIndex : jumpTurnIndex;
+            phase = jumperIndex != -1 ? JUMP_IN_PHASE : PLAY_PHASE;
+            break;
+        }
+    }
+
+    return record;
+}
+
+// Takes back the given move, which must be the last move applied that has not been undone.
+// Hands, piles (including their order), the generator, and the turn state are all restored exactly,
+// so a search can make and unmake moves on one state instead of copying it.
+// 
+// PRE: record was returned by the most recent apply() that has not been undone
+// POST: the game will be exactly as it was before that apply()
+template < class Rules, class Limits >
+void
+BasicGameState< Rules, Limits >::undo( const UndoRecord& record )
+{
+    // Swap back swapped hands, and pass rotated hands back the way they came
+    // A 0 played as the last card ends the round instead of rotating, so the player's hand is then still empty
+    int type = record.move.getType();
+    bool played = type == PLAY_CARD || type == PLAY_DRAWN;
+    if ( type == SWAP_HANDS )
+    {
+        swap( players[ record.playerIndex ].getHand(), players[ record.targetIndex ].getHand() );
+    }
+    if constexpr ( Rules::SEVEN_ZERO )
+    {
+        if ( played && record.move.getCard().getValue() == ROTATE_HANDS_VALUE && !players[ record.playerIndex ].getHand().isEmpty() )
+        {
+            rotateHands( true );
+        }
+    }
+
+    // Take the drawn cards back out of the drawer's hand, and return a played card to the player's hand
+    Hand& drawerHand = players[ record.targetIndex ].getHand();
+    for ( int draw = 0; draw < record.nDrawn; draw++ )
+    {
+        drawerHand.remove( record.drawn[ draw ] );
+    }
+    if ( played )
+    {
+        players[ record.playerIndex ].getHand().add( record.move.getCard() );
+    }
+
+    // Put the cards back where they came from on the table
+    table.rewind( record.table, played, record.drawn, record.nDrawn );
+
+    // Restore the turn state
+    currentPlayerIndex = record.playerIndex;
+    reverse = record.reverse;
+    skip = record.skip;
+    wildColor = record.wildColor;
+    phase = record.phase;
+    pendingPenalty = record.pendingPenalty;
+    jumpTurnIndex = record.jumpTurnIndex;
+    jumpPlayerIndex = record.jumpPlayerIndex;
+    drawnCard = record.drawnCard;
+    turnNumber = record.turnNumber;
+}
+
+// Replaces everything the given player cannot see with a random arrangement they would consider possible.
+// The cards in the other players' hands and the draw pile are pooled, shuffled, and dealt back out in the same amounts.
+// This is the determinization step of an information set search: the result is a fully known game to search.
+// 
+// PRE: round should be initialized; 0 <= observerIndex < nPlayers
+// POST: the observer's hand, the discard pile, and every hand size are unchanged
+template < class Rules, class Limits >
+void
+BasicGameState< Rules, Limits >::determinize( int observerIndex, Random& random )
+{
+    // Assert the preconditions
+    assert( observerIndex >= 0 );
+    assert( observerIndex < nPlayers );
+
+    // Pool the cards the observer cannot see
+    Card unseen[ BasicTable< Limits::N_DECKS >::CAPACITY ];
+    int nUnseen = 0;
+    for ( int playerIndex = 0; playerIndex < nPlayers; playerIndex++ )
+    {
+        if ( playerIndex == observerIndex )
+        {
+            continue;
+        }
+        const Hand& hand = players[ playerIndex ].getHand();
+        for ( CardMask remaining = hand.getMask(); remaining != 0; remaining &= remaining - 1 )
+        {
+            Card card = Card::fromId( lowestCardId( remaining ) );
+            for ( int copy = hand.count( card ); copy > 0; copy-- )
+            {
+                unseen[ nUnseen++ ] = card;
+            }
+        }
+    }
+    int drawSize = table.getDrawSize();
+    for ( int depth = 0; depth < drawSize; depth++ )
+    {
+        unseen[ nUnseen++ ] = table.getDrawCardAt( depth );
+    }
+
+    // Shuffle the unseen cards (a Fisher-Yates shuffle) and deal them back out
+    for ( int i = nUnseen - 1; i > 0; i-- )
+    {
+        swap( unseen[ i ], unseen[ random.nextBelow( i + 1 ) ] );
+    }
+    dealUnseen( observerIndex, unseen, random );
+}
+
+// Deals the given cards in place of everything the given player cannot see: the other players, in seat order,
+// each get as many cards as they hold now, and the rest become the draw pile from the top down.
+// The table's generator is reseeded, so future shuffles do not follow the real game's either.
+// 
+// PRE: round should be initialized; 0 <= observerIndex < nPlayers
+//      cards holds exactly as many cards as the other players' hands and the draw pile
+// POST: the observer's hand, the discard pile, and every hand size are unchanged
+template < class Rules, class Limits >
+void
+BasicGameState< Rules, Limits >::dealUnseen( int observerIndex, const Card cards[], Random& random )
+{
+    // Assert the preconditions
+    assert( observerIndex >= 0 );
+    assert( observerIndex < nPlayers );
+
+    int dealt = 0;
+    for ( int playerIndex = 0; playerIndex < nPlayers; playerIndex++ )
+    {
+        if ( playerIndex == observerIndex )
+        {
+            continue;
+        }
+        Hand& hand = players[ playerIndex ].getHand();
+        int handSize = hand.getSize();
+        hand.clear();
+        for ( int card = 0; card < handSize; card++ )
+        {
+            hand.add( cards[ dealt++ ] );
+        }
+    }
+    for ( int depth = 0; depth < table.getDrawSize(); depth++ )
+    {
+        table.setDrawCardAt( depth, cards[ dealt++ ] );
+    }
+    table.seed( random.next(), random.next() );
+}
+
+// Ends the current player's turn, moving on to the next player unless the round is over.
+// The next player starts by facing any stacked penalty.
+// 
+// PRE: round should be initialized
+// POST: phase == PENALTY_PHASE if a penalty is pending, PLAY_PHASE otherwise
+template < class Rules, class Limits >
+void
+BasicGameState< Rules, Limits >::endTurn()
+{
+    phase = pendingPenalty > 0 ? PENALTY_PHASE : PLAY_PHASE;
+    turnNumber++;
+    if ( !roundIsOver() )
+    {
+        nextPlayer();
+    }
+}
+
+// Finishes a move that played a card (or chose whom to swap hands with after one) by the given player.
+// The player must first choose whom to swap hands with if they played a 7; otherwise their turn ends,
+// and then any player holding a card identical to the stock gets the chance to jump in, in the order of play.
+// 
+// PRE: round should be initialized; the given player made the move
+// POST: none
+template < class Rules, class Limits >
+void
+BasicGameState< Rules, Limits >::endPlay( int playerIndex )
+{
+    if ( phase == SWAP_PHASE )
+    {
+        return;
+    }
+    endTurn();
+
+    // Nobody can jump in on a wild card (it is never identical, having a color named) or over a stacked penalty
+    if constexpr ( Rules::JUMP_IN )
+    {
+        if ( roundIsOver() || table.getStock().isWild() || pendingPenalty > 0 )
+        {
+            return;
+        }
+        jumpTurnIndex = currentPlayerIndex;
+        jumpPlayerIndex = playerIndex;
+        int jumperIndex = findJumpIn( currentPlayerIndex );
+        if ( jumperIndex != -1 )
+        {
+            currentPlayerIndex = jumperIndex;
+            phase = JUMP_IN_PHASE;
+        }
+    }
+}
+
+// Returns the next player after the given one, in the direction of play, who may jump in: they hold a card identical
+// to the stock and neither played it nor have the turn. Returns -1 if there is none before reaching jumpTurnIndex.
+// 
+// PRE: round should be initialized; jumpTurnIndex and jumpPlayerIndex are set
+// POST: return value is -1 or a player index
+template < class Rules, class Limits >
+int
+BasicGameState< Rules, Limits >::findJumpIn( int afterIndex ) const
+{
+    int step = reverse ? nPlayers - 1 : 1;
+    Card stock = table.getStock();
+    for ( int playerIndex = ( afterIndex + step ) % nPlayers; playerIndex != jumpTurnIndex; playerIndex = ( playerIndex + step ) % nPlayers )
+    {
+        if ( playerIndex != jumpPlayerIndex && players[ playerIndex ].getHand().contains( stock ) )
+        {
+            return playerIndex;
+        }
+    }
+
+    return -1;
+}
+
+// Passes every hand to the next player in the direction of play, or to the previous player if backward is true.
+// 
+// PRE: round should be initialized
+// POST: every hand size is moved along with its hand
+template < class Rules, class Limits >
+void
+BasicGameState< Rules, Limits >::rotateHands( bool backward )
+{
+    int step = reverse != backward ? nPlayers - 1 : 1;
+    Hand hands[ Limits::MAX_SEATS ];
+    for ( int playerIndex = 0; playerIndex < nPlayers; playerIndex++ )
+    {
+        hands[ playerIndex ] = players[ playerIndex ].getHand();
+    }
+    for ( int playerIndex = 0; playerIndex < nPlayers; playerIndex++ )
+    {
+        players[ ( playerIndex + step ) % nPlayers ].getHand() = hands[ playerIndex ];
+    }
+}
+
+// Plays the given card from the current player's hand, naming the given color if it is wild, and processes its effect.
+// 
+// PRE: the card is a legal play for the current player
+//      if the card is wild, 0 <= color < N_COLORS
+// POST: any cards drawn as a result will be added to record
+template < class Rules, class Limits >
+void
+BasicGameState< Rules, Limits >::playCard( Card card, int color, UndoRecord& record )
+{
+    Player& player = players[ currentPlayerIndex ];
+    player.playCard( card, table, wildColor );
+
+    // Name the color of a wild card
+    if ( card.isWild() )
+    {
+        assert( color >= 0 );
+        assert( color < N_COLORS );
+
+        wildColor = color;
+    }
+
+    processCardAction( card, record );
+}
+
+// Makes the given player draw up to the given number of cards.
+// 
+// PRE: 0 <= nCards <= MAX_REWIND_DRAWS; round should be initialized; record has no drawn cards yet
+// POST: the given player will draw at most the given number of cards; record will hold the cards they drew
+template < class Rules, class Limits >
+void
+BasicGameState< Rules, Limits >::drawUpTo( int playerIndex, int nCards, UndoRecord& record )
+{
+    // Assert the preconditions
+    assert( nCards >= 0 );
+    assert( nCards <= MAX_REWIND_DRAWS );
+    assert( record.nDrawn == 0 );
+
+    // If the number of cards to draw is 0, return without drawing anything
+    if ( nCards == 0 )
+    {
+        return;
+    }
+
+    // If the number of cards on the table is less than the number of cards specified, draw all the cards on the table
+    Player& player = players[ playerIndex ];
+    int maxCards = min( table.getTotalCards() - 1, nCards );
+    record.targetIndex = playerIndex;
+    for ( int draw = 0; draw < maxCards; draw++ )
+    {
+        record.drawn[ record.nDrawn++ ] = player.drawCard( table );
+    }
+}
+
+// Processes the action of the given card as if the current player played it.
+// The color of a wild card has already been named.
+// 
+// PRE: round should be initialized
+// POST: any cards drawn as a result will be added to record
+template < class Rules, class Limits >
+void
+BasicGameState< Rules, Limits >::processCardAction( Card card, UndoRecord& record )
+{
+    // If the card is an action card, process its effect
+    // nextPlayerIndex must be initialized here, otherwise the jump to later case labels crosses its initialization
+    int nextPlayerIndex = getNextPlayerIndex();
+    switch ( card.getValue() )
+    {
+        // Make the next player draw 2 cards, or add 2 to the penalty they face if penalties stack
+        // The official rules say that this also skips the next player, but the spec does not mention this
+        case DRAW2_INDEX:
+            if constexpr ( Rules::STACKING )
+            {
+                pendingPenalty += 2;
+                break;
+            }
+            drawUpTo( nextPlayerIndex, 2, record );
+            if constexpr ( Rules::DRAW2_SKIPS )
+            {
+                skip = true;
+            }
+            break;
+        // Reverse the direction of play
+        case REVERSE_INDEX:
+            reverse = !reverse;
+            break;
+        // Skip the next player
+        case SKIP_INDEX:
+            skip = true;
+            record.targetIndex = nextPlayerIndex;
+            break;
+        // Make the next player draw 4 cards, or add 4 to the penalty they face if penalties stack
+        // The official rules say that this also skips the next player, but the spec does not mention this
+        case DRAW4_WILD_INDEX:
+            if constexpr ( Rules::STACKING )
+            {
+                pendingPenalty += 4;
+                break;
+            }
+            drawUpTo( nextPlayerIndex, 4, record );
+            if constexpr ( Rules::DRAW4_SKIPS )
+            {
+                skip = true;
+            }
+            break;
+        // Under the 7-0 rule, choose someone to swap hands with, or pass every hand on
+        // A player who has just gone out ends the round instead
+        case SWAP_HANDS_VALUE:
+            if ( Rules::SEVEN_ZERO && !players[ currentPlayerIndex ].getHand().isEmpty() )
+            {
+                phase = SWAP_PHASE;
+            }
+            break;
+        case ROTATE_HANDS_VALUE:
+            if ( Rules::SEVEN_ZERO && !players[ currentPlayerIndex ].getHand().isEmpty() )
+            {
+                rotateHands( false );
+            }
+            break;
+    }
+}
+
+// Returns true if the round is over, i.e. one player has no cards in their hand.
+// 
+// PRE: none
+// POST: none
+template < class Rules, class Limits >
+bool
+BasicGameState< Rules, Limits >::roundIsOver() const
+{
+    // Iterate through each player
+    for ( int playerIndex = 0; playerIndex < nPlayers; playerIndex++ )
+    {
+        // If this player's hand is empty, they have won the round
+        Player player = players[ playerIndex ];
+        if ( player.getHand().isEmpty() )
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Returns the index of the winner of the current round.
+// 
+// PRE: the round must be over
+// POST: 0 <= return value < nPlayers
+template < class Rules, class Limits >
+int
+BasicGameState< Rules, Limits >::getRoundWinnerIndex() const
+{
+    // Assert the preconditions
+    assert( roundIsOver() );
+
+    // Iterate through each player
+    for ( int playerIndex = 0; playerIndex < nPlayers; playerIndex++ )
+    {
+        // If this player's hand is empty, they have won the round
+        if ( players[ playerIndex ].getHand().isEmpty() )
+        {
+            return playerIndex;
+        }
+    }
+
+    // Because the round is over, this should not be reached
+    assert( false );
+    return 0;
+}
+
+// Increases the winner's score by the sum of their opponents' cards.
+// 
+// PRE: the round must be over
+// POST: none
+template < class Rules, class Limits >
+void
+BasicGameState< Rules, Limits >::scoreRound()
+{
+    // Assert the preconditions
+    assert( roundIsOver() );
+
+    Player& winner = players[ getRoundWinnerIndex() ];
+
+    // Iterate through each player and add their hand's score to the round score
+    // The winner's score will be 0, so it doesn't matter that their hand is included
+    int roundScore = 0;
+    for ( int playerIndex = 0; playerIndex < nPlayers; playerIndex++ )
+    {
+        roundScore += players[ playerIndex ].getHand().getScore();
+    }
+
+    // Increase the winner's score
+    winner.setScore( winner.getScore() + roundScore );
+}
+
+// Returns true if any player has reached the goal score.
+// 
+// PRE: none
+// POST: none
+template < class Rules, class Limits >
+bool
+BasicGameState< Rules, Limits >::gameIsOver() const
+{
+    for ( int playerIndex = 0; playerIndex < nPlayers; playerIndex++ )
+    {
+        if ( players[ playerIndex ].getScore() >= goalScore )
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// Returns a Zobrist hash of the position in the current round, for finding positions reached by different moves.
+// It covers the hands, the discard pile and stock, whose turn it is, and the state of the turn. It leaves out the
+// scores, the turn number, and the order of the draw pile, which the hands and discard pile do not determine.
+// The hands and discard pile keep their hashes up to date as cards move, so this only combines a few words.
+// 
+// PRE: round should be initialized
+// POST: none
+template < class Rules, class Limits >
+uint64_t
+BasicGameState< Rules, Limits >::getHash() const
+{
+    // Each seat's hand hash is rotated by a different amount, which is the same as giving every seat its own keys
+    uint64_t hash = table.getHash();
+    for ( int playerIndex = 0; playerIndex < nPlayers; playerIndex++ )
+    {
+        uint64_t handHash = players[ playerIndex ].getHand().getHash();
+        int rotation = playerIndex * SEAT_HASH_ROTATION % 64;
+        hash ^= rotation == 0 ? handHash : ( handHash << rotation ) | ( handHash >> ( 64 - rotation ) );
+    }
+
+    // The rest of the turn fits in a few bits, which are mixed into a key of their own
+    // The wild color and drawn card are left out when the rules would not read them, since they are stale then
+    int color = table.getStock().isWild() ? wildColor : NO_COLOR_INDEX;
+    int drawnId = phase == DRAWN_CARD_PHASE ? drawnCard.getId() : N_CARD_IDS;
+    uint64_t turn = currentPlayerIndex | reverse << 8 | skip << 9 | color << 10 | phase << 13 | uint64_t( drawnId ) << 16;
+    turn |= uint64_t( pendingPenalty ) << 24;
+    if ( phase == JUMP_IN_PHASE )
+    {
+        turn |= uint64_t( jumpTurnIndex ) << 32 | uint64_t( jumpPlayerIndex ) << 40;
+    }
+    return hash ^ mixKey( turn );
+}
+
+// Returns the number of points needed to win the game.
+// 
+// PRE: none
+// POST: return value >= 1
+template < class Rules, class Limits >
+int
+BasicGameState< Rules, Limits >::getGoalScore() const
+{
+    return goalScore;
+}
+
+// Returns the number of players in the game.
+// 
+// PRE: none
+// POST: 2 <= return value <= Limits::MAX_SEATS
+template < class Rules, class Limits >
+int
+BasicGameState< Rules, Limits >::getPlayerCount() const
+{
+    return nPlayers;
+}
+
+// Returns the index of the player whose turn it is.
+// 
+// PRE: round should be initialized
+// POST: 0 <= return value < nPlayers
+template < class Rules, class Limits >
+int
+BasicGameState< Rules, Limits >::getCurrentPlayerIndex() const
+{
+    return currentPlayerIndex;
+}
+
+// Returns the number of turns completed this round; it changes exactly when apply() ends a turn.
+// 
+// PRE: none
+// POST: return value >= 0
+template < class Rules, class Limits >
+int
+BasicGameState< Rules, Limits >::getTurnNumber() const
+{
+    return turnNumber;
+}
+
+// Returns the player at the given index.
+// 
+// PRE: 0 <= playerIndex < nPlayers
+// POST: none
+template < class Rules, class Limits >
+const Player&
+BasicGameState< Rules, Limits >::getPlayer( int playerIndex ) const
+{
+    // Assert the preconditions
+    assert( playerIndex >= 0 );
+    assert( playerIndex < nPlayers );
+
+    return players[ playerIndex ];
+}
+
+// Returns the draw and discard piles.
+// 
+// PRE: none
+// POST: none
+template < class Rules, class Limits >
+const BasicTable< Limits::N_DECKS >&
+BasicGameState< Rules, Limits >::getTable() const
+{
+    return table;
+}
+
+// Returns the top card of the discard pile.
+// 
+// PRE: round should be initialized
+// POST: none
+template < class Rules, class Limits >
+Card
+BasicGameState< Rules, Limits >::getStock() const
+{
+    return table.getStock();
+}
+
+// Returns the color chosen for the most recent wild card, or NO_COLOR_INDEX if none has been chosen this round.
+// This is only meaningful while the stock is a wild card.
+// 
+// PRE: round should be initialized
+// POST: 0 <= return value < N_COLORS, or return value == NO_COLOR_INDEX
+template < class Rules, class Limits >
+int
+BasicGameState< Rules, Limits >::getWildColor() const
+{
+    return wildColor;
+}
+
+// Returns the kind of decision the current player must make next.
+// 
+// PRE: round should be initialized
+// POST: return value is a GamePhase
+template < class Rules, class Limits >
+int
+BasicGameState< Rules, Limits >::getPhase() const
+{
+    return phase;
+}
+
+// Returns the card the current player just drew.
+// 
+// PRE: phase == DRAWN_CARD_PHASE
+// POST: none
+template < class Rules, class Limits >
+Card
+BasicGameState< Rules, Limits >::getDrawnCard() const
+{
+    // Assert the preconditions
+    assert( phase == DRAWN_CARD_PHASE );
+
+    return drawnCard;
+}
+
+// Returns true if the direction of play is currently reversed.
+// 
+// PRE: round should be initialized
+// POST: none
+template < class Rules, class Limits >
+bool
+BasicGameState< Rules, Limits >::isReversed() const
+{
+    return reverse;
+}
+
+// The rule sets and limits that are compiled; a new combination must be added here
+template class BasicGameState< StandardRules >;
+template class BasicGameState< OfficialRules >;
+template class BasicGameState< HouseRules >;
+template class BasicGameState< OfficialRules, TournamentLimits >;
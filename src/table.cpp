@@ -1,59 +1,182 @@
 #include <assert.h>
 #include <iostream>
 #include "card.hpp"
+#include "rules.hpp"
 #include "table.hpp"
 using namespace std;
 
-// Initializes a Table, constructing but not initializing its 2 decks.
+// The multiplier that folds each card of the draw pile into its hash (the 64-bit FNV prime)
+const uint64_t DRAW_HASH_MULTIPLIER = 0x100000001b3ULL;
+
+// Returns the given pool index wrapped around to the start of the pool.
+// 
+// PRE: 0 <= index < 2 * CAPACITY
+// POST: 0 <= return value < CAPACITY
+template < int N_DECKS >
+int
+BasicTable< N_DECKS >::wrapIndex( int index )
+{
+    return index >= CAPACITY ? index - CAPACITY : index;
+}
+
+// Initializes a Table with empty piles.
 // 
 // PRE: none
 // POST: draw and discard will be empty
-Table::Table()
+template < int N_DECKS >
+BasicTable< N_DECKS >::BasicTable()
+{
+    discardBase = 0;
+    discardSize = 0;
+    drawSize = 0;
+    discardHash = 0;
+    lazyShuffle = false;
+}
+
+// Seeds the generator used to shuffle this table's cards.
+// Two tables seeded with the same seed and stream will deal exactly the same cards.
+// 
+// PRE: none
+// POST: none
+template < int N_DECKS >
+void
+BasicTable< N_DECKS >::seed( uint64_t seedValue, uint64_t stream )
+{
+    random.seed( seedValue, stream );
+}
+
+// Returns the generator used to shuffle this table's cards.
+// 
+// PRE: none
+// POST: none
+template < int N_DECKS >
+const Random&
+BasicTable< N_DECKS >::getGenerator() const
+{
+    return random;
+}
+
+// Replaces the generator used to shuffle this table's cards, e.g. with one saved by getGenerator() between rounds.
+// 
+// PRE: none
+// POST: the following shuffles and draws are those the given generator would make
+template < int N_DECKS >
+void
+BasicTable< N_DECKS >::setGenerator( const Random& generator )
+{
+    random = generator;
+}
+
+// Sets whether the draw pile is shuffled lazily, one card per draw, instead of all at once.
+// Both modes deal every ordering with equal probability, but they consume random numbers differently,
+// so the same seed deals different cards in each mode.
+// 
+// PRE: none
+// POST: takes effect from the next initialization or reshuffle
+template < int N_DECKS >
+void
+BasicTable< N_DECKS >::setLazyShuffle( bool lazy )
+{
+    lazyShuffle = lazy;
+}
+
+// Returns true if the draw pile is shuffled lazily, one card per draw.
+// 
+// PRE: none
+// POST: none
+template < int N_DECKS >
+bool
+BasicTable< N_DECKS >::isLazyShuffle() const
 {
-    draw = Deck();
-    discard = Deck();
+    return lazyShuffle;
 }
 
 // Initialize the draw and discard piles.
-// The draw pile will be initialized and shuffled, the discard pile will be emptied,
+// The draw pile will be initialized and shuffled (unless shuffling lazily), the discard pile will be emptied,
 // and cards will be placed from the draw pile onto the discard pile until the top card is not a Draw4 Wild.
 // 
 // PRE: none
-// POST: draw will have at most TOTAL_CARDS - 1 cards
+// POST: draw will have at most CAPACITY - 1 cards
 //       discard will have at least 1 card
 //       the top card of the discard will not be a Draw4 Wild
+template < int N_DECKS >
 void
-Table::initialize()
+BasicTable< N_DECKS >::initialize()
 {
-    // Initialize the decks
-    draw.initialize();
-    draw.shuffle();
-    discard.clear();
+    // The cards of a full deck in order, built once and then copied into the pool each round
+    static const Deck fullDeck = []()
+    {
+        Deck deck;
+        deck.initialize();
+        return deck;
+    }();
+
+    // Fill the pool with a full deck for each deck in play, all of it in the draw pile
+    for ( int i = 0; i < CAPACITY; i++ )
+    {
+        pool[ i ] = fullDeck.getCardAt( i % TOTAL_CARDS );
+    }
+    discardBase = 0;
+    discardSize = 0;
+    discardHash = 0;
+    drawSize = CAPACITY;
+    if ( !lazyShuffle )
+    {
+        shuffleDraw();
+    }
 
     // Put the top card of the deck on the discard pile
     // Repeat until the top card is not a Draw4 Wild
+    // The top of the draw pile is the slot right after the top of the discard pile, so the card stays where it is drawn
     do
     {
-        discard.push( draw.pop() );
-    } while ( discard.peek().getValue() == DRAW4_WILD_INDEX );
+        Card card = drawCard();
+        pool[ wrapIndex( discardBase + discardSize ) ] = card;
+        discardSize++;
+        discardHash += ZOBRIST_KEYS.discardCards[ card.getId() ];
+    } while ( getStock().getValue() == DRAW4_WILD_INDEX );
 }
 
 // Returns the total number of cards on the table.
 // 
 // PRE: none
 // POST: none
+template < int N_DECKS >
+int
+BasicTable< N_DECKS >::getTotalCards() const
+{
+    return drawSize + discardSize;
+}
+
+// Returns the number of cards in the draw pile.
+// 
+// PRE: none
+// POST: none
+template < int N_DECKS >
+int
+BasicTable< N_DECKS >::getDrawSize() const
+{
+    return drawSize;
+}
+
+// Returns the number of cards in the discard pile, including the stock.
+// 
+// PRE: none
+// POST: none
+template < int N_DECKS >
 int
-Table::getTotalCards() const
+BasicTable< N_DECKS >::getDiscardSize() const
 {
-    return draw.getSize() + discard.getSize();
+    return discardSize;
 }
 
 // Returns true if a card can be drawn from the table.
 // 
 // PRE: none
 // POST: none
+template < int N_DECKS >
 bool
-Table::canDrawCard() const
+BasicTable< N_DECKS >::canDrawCard() const
 {
     return getTotalCards() > 1;
 }
@@ -62,8 +185,9 @@ Table::canDrawCard() const
 // 
 // PRE: none
 // POST: none
+template < int N_DECKS >
 bool
-Table::canDrawCards( int nCards ) const
+BasicTable< N_DECKS >::canDrawCards( int nCards ) const
 {
     return getTotalCards() > nCards;
 }
@@ -72,55 +196,309 @@ Table::canDrawCards( int nCards ) const
 // 
 // PRE: the table must not be empty
 // POST: if the draw pile was empty, the discard pile will become the new draw pile, excluding its top card
+template < int N_DECKS >
 Card
-Table::drawCard()
+BasicTable< N_DECKS >::drawCard()
 {
     // Assert the preconditions
     assert( canDrawCard() );
 
     // If the deck is empty, reshuffle the discard pile
-    // This is done by swapping the two decks (except for the top card)
-    if ( draw.isEmpty() )
+    // The draw pile ends at discardBase, so every discard below the top card already sits where the draw pile belongs
+    // Moving discardBase up to the top card makes them the draw pile in place
+    if ( drawSize == 0 )
     {
-        // Keep the top card in play by swapping it to the draw pile (the new discard pile)
-        draw.push( discard.pop() );
-
-        // Swap the draw and discard piles
-        // It may be possible to optimize this operation with references
-        Deck swap = draw;
-        draw = discard;
-        discard = swap;
+        drawSize = discardSize - 1;
+        discardBase = wrapIndex( discardBase + discardSize - 1 );
+        discardSize = 1;
+        discardHash = ZOBRIST_KEYS.discardCards[ getStock().getId() ];
+        if ( !lazyShuffle )
+        {
+            shuffleDraw();
+        }
+    }
 
-        // Shuffle the new draw pile and print a message
-        draw.shuffle();
+    // When shuffling lazily, first swap a random card of the draw pile to the top
+    int drawTop = getDrawTop();
+    if ( lazyShuffle )
+    {
+        swap( pool[ drawTop ], pool[ wrapIndex( drawTop + random.nextBelow( drawSize ) ) ] );
     }
 
-    // Add the top card of the draw pile to the player's hand
-    return draw.pop();
+    // Pop the top card of the draw pile; its slot joins the free slots after the discard pile
+    drawSize--;
+    return pool[ drawTop ];
 }
 
 // Plays the given card onto the top of the discard pile.
 // 
 // PRE: the given card must be playable on the top card of the discard pile
 // POST: none
+template < int N_DECKS >
 void
-Table::playCard( Card card, int wildColor )
+BasicTable< N_DECKS >::playCard( Card card, int wildColor )
 {
     // Assert the preconditions
-    assert( card.canPlayOn( discard.peek(), wildColor ) );
+    assert( card.canPlayOn( getStock(), wildColor ) );
+    assert( getTotalCards() < CAPACITY );
 
-    discard.push( card );
+    // The slot after the top of the discard pile is free, since the card came from a player's hand
+    pool[ wrapIndex( discardBase + discardSize ) ] = card;
+    discardSize++;
+    discardHash += ZOBRIST_KEYS.discardCards[ card.getId() ];
 }
 
 // Returns the top card of the discard pile.
 // 
 // PRE: discard must not be empty (should not occur if table has been initialized)
 // POST: none (discard will not be affected)
+template < int N_DECKS >
+Card
+BasicTable< N_DECKS >::getStock() const
+{
+    // Assert the preconditions
+    assert( discardSize > 0 );
+
+    return pool[ wrapIndex( discardBase + discardSize - 1 ) ];
+}
+
+// Returns the Zobrist hash of the discard pile: its contents, in any order, and which card is the stock.
+// 
+// PRE: discard must not be empty
+// POST: none
+template < int N_DECKS >
+uint64_t
+BasicTable< N_DECKS >::getHash() const
+{
+    return discardHash ^ ZOBRIST_KEYS.stocks[ getStock().getId() ];
+}
+
+// Returns a hash of what getHash() leaves out: the order of the draw pile and the state of the generator, which together
+// decide every future draw. Unlike getHash(), it is not kept up to date, so it takes time proportional to the draw pile.
+// 
+// PRE: none
+// POST: none
+template < int N_DECKS >
+uint64_t
+BasicTable< N_DECKS >::getDrawHash() const
+{
+    uint64_t hash = random.getHash();
+    int drawTop = getDrawTop();
+    for ( int depth = 0; depth < drawSize; depth++ )
+    {
+        hash = ( hash ^ pool[ wrapIndex( drawTop + depth ) ].getId() ) * DRAW_HASH_MULTIPLIER;
+    }
+
+    return mixKey( hash ^ drawSize );
+}
+
+// Returns the card at the given depth of the discard pile, where depth 0 is the stock.
+// 
+// PRE: 0 <= depth < getDiscardSize()
+// POST: none
+template < int N_DECKS >
+Card
+BasicTable< N_DECKS >::getDiscardCardAt( int depth ) const
+{
+    // Assert the preconditions
+    assert( depth >= 0 );
+    assert( depth < discardSize );
+
+    return pool[ wrapIndex( discardBase + discardSize - 1 - depth ) ];
+}
+
+// Returns the card at the given depth of the draw pile, where depth 0 is the top card.
+// 
+// PRE: 0 <= depth < getDrawSize()
+// POST: none
+template < int N_DECKS >
 Card
-Table::getStock() const
+BasicTable< N_DECKS >::getDrawCardAt( int depth ) const
+{
+    // Assert the preconditions
+    assert( depth >= 0 );
+    assert( depth < drawSize );
+
+    return pool[ wrapIndex( getDrawTop() + depth ) ];
+}
+
+// Replaces the card at the given depth of the draw pile, where depth 0 is the top card.
+// This lets a search deal the unseen cards into a different, equally likely draw pile.
+// 
+// PRE: 0 <= depth < getDrawSize()
+// POST: getDrawCardAt( depth ) == card
+template < int N_DECKS >
+void
+BasicTable< N_DECKS >::setDrawCardAt( int depth, Card card )
 {
     // Assert the preconditions
-    assert( !discard.isEmpty() );
+    assert( depth >= 0 );
+    assert( depth < drawSize );
+
+    pool[ wrapIndex( getDrawTop() + depth ) ] = card;
+}
 
-    return discard.peek();
+// Returns the position of the piles and the state of the generator, for undoing the next move with rewind().
+// 
+// PRE: none
+// POST: none
+template < int N_DECKS >
+TableState
+BasicTable< N_DECKS >::getState() const
+{
+    TableState state;
+    state.random = random;
+    state.discardBase = discardBase;
+    state.discardSize = discardSize;
+    state.drawSize = drawSize;
+    return state;
 }
+
+// Returns the table to the given saved state, undoing the cards played and drawn since it was saved.
+// A move plays at most one card and then draws, so replaying the generator from the saved state finds every random swap
+// the draws made; they are undone in reverse order, and the played card simply falls back outside the piles.
+// A drawn card's slot is free once it is drawn, so later moves may have played other cards into it; the drawn cards are
+// written back into their slots before the swaps are undone.
+// 
+// PRE: state was saved from this table; since then, at most one card was played and then nDrawn cards were drawn,
+//      which are given in drawn in the order they were drawn
+//      0 <= nDrawn <= MAX_REWIND_DRAWS
+// POST: the piles, their order, and the generator will be exactly as they were when state was saved
+template < int N_DECKS >
+void
+BasicTable< N_DECKS >::rewind( const TableState& state, bool played, const Card drawn[], int nDrawn )
+{
+    // Assert the preconditions
+    assert( nDrawn >= 0 );
+    assert( nDrawn <= MAX_REWIND_DRAWS );
+
+    // Replay the draws from the saved state, remembering where each lazy draw swapped its card from
+    // and the generator state from before the reshuffle, if the draws needed one
+    int drawTops[ MAX_REWIND_DRAWS ];
+    int swapOffsets[ MAX_REWIND_DRAWS ];
+    int reshuffleDraw = -1;
+    Random reshuffleRandom;
+    random = state.random;
+    discardBase = state.discardBase;
+    discardSize = state.discardSize + ( played ? 1 : 0 );
+    drawSize = state.drawSize;
+    for ( int draw = 0; draw < nDrawn; draw++ )
+    {
+        if ( drawSize == 0 )
+        {
+            drawSize = discardSize - 1;
+            discardBase = wrapIndex( discardBase + discardSize - 1 );
+            discardSize = 1;
+            reshuffleDraw = draw;
+            reshuffleRandom = random;
+            if ( !lazyShuffle )
+            {
+                for ( int i = drawSize - 1; i > 0; i-- )
+                {
+                    random.nextBelow( i + 1 );
+                }
+            }
+        }
+
+        drawTops[ draw ] = getDrawTop();
+        swapOffsets[ draw ] = lazyShuffle ? random.nextBelow( drawSize ) : 0;
+        drawSize--;
+    }
+
+    // Undo the swaps in reverse order, putting each drawn card back on top of the draw pile
+    for ( int draw = nDrawn - 1; draw >= 0; draw-- )
+    {
+        drawSize++;
+        pool[ drawTops[ draw ] ] = drawn[ draw ];
+        swap( pool[ drawTops[ draw ] ], pool[ wrapIndex( drawTops[ draw ] + swapOffsets[ draw ] ) ] );
+
+        // Before this draw, the draw pile was reshuffled, so unshuffle it while the partition is where the shuffle left it
+        if ( draw == reshuffleDraw && !lazyShuffle )
+        {
+            unshuffleDraw( reshuffleRandom );
+        }
+    }
+
+    // Restore the saved partition and generator
+    random = state.random;
+    discardBase = state.discardBase;
+    discardSize = state.discardSize;
+    drawSize = state.drawSize;
+
+    // A played card falls off the hash on its own, but a reshuffle forgot every discard under the stock
+    if ( reshuffleDraw != -1 )
+    {
+        hashDiscard();
+    }
+    else if ( played )
+    {
+        discardHash -= ZOBRIST_KEYS.discardCards[ pool[ wrapIndex( discardBase + discardSize ) ].getId() ];
+    }
+}
+
+// Returns the pool index of the top card of the draw pile.
+// 
+// PRE: none
+// POST: 0 <= return value < CAPACITY
+template < int N_DECKS >
+int
+BasicTable< N_DECKS >::getDrawTop() const
+{
+    return wrapIndex( discardBase - drawSize + CAPACITY );
+}
+
+// Randomizes the order of the draw pile in place, wrapping around the end of the pool if necessary.
+// Every ordering is equally likely (a Fisher-Yates shuffle).
+// 
+// PRE: none
+// POST: none
+template < int N_DECKS >
+void
+BasicTable< N_DECKS >::shuffleDraw()
+{
+    int drawTop = getDrawTop();
+    for ( int i = drawSize - 1; i > 0; i-- )
+    {
+        swap( pool[ wrapIndex( drawTop + i ) ], pool[ wrapIndex( drawTop + random.nextBelow( i + 1 ) ) ] );
+    }
+}
+
+// Undoes the shuffle of the draw pile that was made with the given generator state.
+// The shuffle's swaps are regenerated from the generator and then made again in reverse order.
+// 
+// PRE: the draw pile is exactly as shuffleDraw() left it when the generator was in the given state
+// POST: the draw pile will be in the order it had before that shuffle
+template < int N_DECKS >
+void
+BasicTable< N_DECKS >::unshuffleDraw( Random shuffleRandom )
+{
+    int drawTop = getDrawTop();
+    short swapOffsets[ CAPACITY ];
+    for ( int i = drawSize - 1; i > 0; i-- )
+    {
+        swapOffsets[ i ] = shuffleRandom.nextBelow( i + 1 );
+    }
+    for ( int i = 1; i < drawSize; i++ )
+    {
+        swap( pool[ wrapIndex( drawTop + i ) ], pool[ wrapIndex( drawTop + swapOffsets[ i ] ) ] );
+    }
+}
+
+// Recomputes the hash of the discard pile from its cards.
+// 
+// PRE: none
+// POST: none
+template < int N_DECKS >
+void
+BasicTable< N_DECKS >::hashDiscard()
+{
+    discardHash = 0;
+    for ( int depth = 0; depth < discardSize; depth++ )
+    {
+        discardHash += ZOBRIST_KEYS.discardCards[ getDiscardCardAt( depth ).getId() ];
+    }
+}
+
+// The deck counts of the limits in rules.hpp; a new deck count must be added here
+template class BasicTable< StandardLimits::N_DECKS >;
+template class BasicTable< TournamentLimits::N_DECKS >;
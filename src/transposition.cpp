@@ -0,0 +1,115 @@
+#include <assert.h>
+#include "transposition.hpp"
+using namespace std;
+
+// Set in every packed entry, so an empty slot never reads as an entry
+const uint64_t ENTRY_PRESENT = uint64_t( 1 ) << 63;
+
+// Packs the given entry into one word.
+// 
+// PRE: none
+// POST: return value has ENTRY_PRESENT set
+static uint64_t
+packEntry( const TranspositionEntry& entry )
+{
+    return ENTRY_PRESENT
+        | uint64_t( uint16_t( entry.value ) )
+        | uint64_t( entry.depth ) << 16
+        | uint64_t( entry.bound ) << 24
+        | uint64_t( entry.moveIndex ) << 32;
+}
+
+// Unpacks an entry packed by packEntry().
+// 
+// PRE: data was returned by packEntry()
+// POST: none
+static TranspositionEntry
+unpackEntry( uint64_t data )
+{
+    TranspositionEntry entry;
+    entry.value = short( uint16_t( data ) );
+    entry.depth = data >> 16;
+    entry.bound = data >> 24;
+    entry.moveIndex = data >> 32;
+    return entry;
+}
+
+// Initializes an empty table with 2 ^ log2Size slots.
+// Each slot takes 16 bytes, so e.g. a log2Size of 20 takes 16 MiB.
+// 
+// PRE: 1 <= log2Size <= 30
+// POST: getSize() == 2 ^ log2Size
+TranspositionTable::TranspositionTable( int log2Size )
+    : slots( size_t( 1 ) << log2Size )
+{
+    // Assert the preconditions
+    assert( log2Size >= 1 );
+    assert( log2Size <= 30 );
+
+    indexMask = slots.size() - 1;
+    clear();
+}
+
+// Returns the number of slots in the table.
+// 
+// PRE: none
+// POST: return value is a power of 2
+int
+TranspositionTable::getSize() const
+{
+    return slots.size();
+}
+
+// Empties every slot.
+// 
+// PRE: no other thread is using the table
+// POST: every probe() will miss until something is stored
+void
+TranspositionTable::clear()
+{
+    for ( Slot& slot : slots )
+    {
+        slot.check.store( 0, memory_order_relaxed );
+        slot.data.store( 0, memory_order_relaxed );
+    }
+}
+
+// Looks up the position with the given hash, copying what is known about it into entry.
+// Returns false if the table holds nothing for the position.
+// 
+// PRE: none
+// POST: if the return value is false, entry is unchanged
+bool
+TranspositionTable::probe( uint64_t hash, TranspositionEntry& entry ) const
+{
+    const Slot& slot = slots[ hash & indexMask ];
+    uint64_t data = slot.data.load( memory_order_relaxed );
+    uint64_t check = slot.check.load( memory_order_relaxed );
+    if ( ( check ^ data ) != hash || ( data & ENTRY_PRESENT ) == 0 )
+    {
+        return false;
+    }
+
+    entry = unpackEntry( data );
+    return true;
+}
+
+// Stores what is known about the position with the given hash, unless its slot holds a deeper search of the same position.
+// 
+// PRE: none
+// POST: none
+void
+TranspositionTable::store( uint64_t hash, const TranspositionEntry& entry )
+{
+    Slot& slot = slots[ hash & indexMask ];
+    uint64_t oldData = slot.data.load( memory_order_relaxed );
+    uint64_t oldCheck = slot.check.load( memory_order_relaxed );
+    if ( ( oldCheck ^ oldData ) == hash && ( oldData & ENTRY_PRESENT ) != 0 && unpackEntry( oldData ).depth > entry.depth )
+    {
+        return;
+    }
+
+    uint64_t data = packEntry( entry );
+    slot.data.store( data, memory_order_relaxed );
+    slot.check.store( data ^ hash, memory_order_relaxed );
+}
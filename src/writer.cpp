@@ -0,0 +1,131 @@
+#include <assert.h>
+#include <string.h>
+#include "writer.hpp"
+using namespace std;
+
+// Initializes a writer with a buffer of the given size and no file.
+// 
+// PRE: capacity >= 1
+// POST: isOpen() == false
+BufferedWriter::BufferedWriter( size_t capacity )
+    : buffer( capacity )
+{
+    // Assert the preconditions
+    assert( capacity >= 1 );
+
+    file = NULL;
+    size = 0;
+    bytesWritten = 0;
+    failed = false;
+}
+
+// Flushes and closes the file, if one is open.
+// 
+// PRE: none
+// POST: none
+BufferedWriter::~BufferedWriter()
+{
+    close();
+}
+
+// Opens the file at the given path for appending, creating it if necessary, after closing any file already open.
+// Returns false if the file cannot be opened.
+// 
+// PRE: none
+// POST: if the return value is true, isOpen() and getBytesWritten() == 0
+bool
+BufferedWriter::open( const string& path )
+{
+    close();
+    file = fopen( path.c_str(), "ab" );
+    bytesWritten = 0;
+    failed = false;
+    return file != NULL;
+}
+
+// Returns true if a file is open.
+// 
+// PRE: none
+// POST: none
+bool
+BufferedWriter::isOpen() const
+{
+    return file != NULL;
+}
+
+// Returns true if a write to the current file has failed, in which case some of what was written is missing from it.
+// 
+// PRE: none
+// POST: none
+bool
+BufferedWriter::hasFailed() const
+{
+    return failed;
+}
+
+// Appends the given bytes to the file. They are buffered, and only reach the file once the buffer fills or is flushed.
+// 
+// PRE: isOpen()
+// POST: getBytesWritten() increases by nBytes
+void
+BufferedWriter::write( const void* data, size_t nBytes )
+{
+    // Assert the preconditions
+    assert( isOpen() );
+
+    // Writes larger than the buffer skip it, once whatever is buffered has gone ahead of them
+    const char* bytes = static_cast< const char* >( data );
+    bytesWritten += nBytes;
+    if ( size + nBytes > buffer.size() )
+    {
+        flush();
+        if ( nBytes >= buffer.size() )
+        {
+            failed |= fwrite( bytes, 1, nBytes, file ) != nBytes;
+            return;
+        }
+    }
+
+    memcpy( &buffer[ size ], bytes, nBytes );
+    size += nBytes;
+}
+
+// Hands every buffered byte to the file.
+// 
+// PRE: none
+// POST: the buffer is empty
+void
+BufferedWriter::flush()
+{
+    if ( file != NULL && size > 0 )
+    {
+        failed |= fwrite( &buffer[ 0 ], 1, size, file ) != size;
+        failed |= fflush( file ) != 0;
+    }
+    size = 0;
+}
+
+// Flushes and closes the file, if one is open.
+// 
+// PRE: none
+// POST: isOpen() == false
+void
+BufferedWriter::close()
+{
+    if ( file != NULL )
+    {
+        flush();
+        failed |= fclose( file ) != 0;
+        file = NULL;
+    }
+}
+
+// Returns the number of bytes written since the file was opened, including any still in the buffer.
+// 
+// PRE: none
+// POST: none
+uint64_t
+BufferedWriter::getBytesWritten() const
+{
+    return bytesWritten;
+}
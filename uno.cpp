@@ -1,27 +1,55 @@
 #include <cstdlib>
 #include <iostream>
 #include <string>
+#include <thread>
 #include <time.h>
+#include <vector>
+#include "belief.hpp"
 #include "card.hpp"
+#include "console.hpp"
 #include "deck.hpp"
 #include "game.hpp"
 #include "hand.hpp"
+#include "log.hpp"
+#include "mcts.hpp"
 #include "player.hpp"
 #include "table.hpp"
+#include "writer.hpp"
 using namespace std;
 
 void printInstructions();
 
 // Simulates the card game Uno
-int main()
+// Given --log and a file, also appends the game to that file as an event log
+int main( int argc, char* argv[] )
 {
-    // Seed the random number generator (necessary for shuffling the deck)
-    srand( time( 0 ) );
-
     ////////////////////////////////////////////////////////////////////////////////
     // INITIAL INPUT
     ////////////////////////////////////////////////////////////////////////////////
 
+    // Read the log file, if any, from the command line
+    string logPath;
+    for ( int i = 1; i < argc; i++ )
+    {
+        if ( string( argv[ i ] ) == "--log" && i + 1 < argc )
+        {
+            logPath = argv[ ++i ];
+        }
+        else
+        {
+            cout << "Usage: " << argv[ 0 ] << " [--log file]" << endl;
+            return 1;
+        }
+    }
+
+    // Open the log before anything is asked, so a bad path is reported straight away
+    BufferedWriter logWriter;
+    if ( !logPath.empty() && !logWriter.open( logPath ) )
+    {
+        cout << "Cannot open " << logPath << " for writing." << endl;
+        return 1;
+    }
+
     // Junk variable used to consume "enter to continue" input or trailing newlines
     string junk;
 
@@ -63,14 +91,19 @@ int main()
     // Consume the trailing newline from cin
     getline( cin, junk );
 
-    // Prompt for the names of each player and initialize the players array
+    // Prompt for the names of each player and initialize the players array, and whether the computer plays each seat
     string names[ nPlayers ];
+    bool computers[ nPlayers ];
     for ( int i = 0; i < nPlayers; i++ )
     {
         string name;
         cout << "Enter the name of Player " << i + 1 << ": ";
         getline( cin, name );
         names[ i ] = name;
+
+        cout << "Is " << name << " played by the computer? (y/N) ";
+        getline( cin, input );
+        computers[ i ] = input == "y" || input == "Y";
     }
 
     // Prompt for the number of points to play to
@@ -98,8 +131,46 @@ int main()
     // GAMEPLAY
     ////////////////////////////////////////////////////////////////////////////////
 
+    // Every person shares the terminal, so one console agent makes decisions for all of them
+    // One search agent plays every computer seat, each following the round through its own belief tracker
+    ConsoleAgent consoleAgent;
+    ConsoleEvents consoleEvents;
+    MctsAgent mctsAgent( max( 1u, thread::hardware_concurrency() ), DEFAULT_MCTS_MILLIS_PER_MOVE, time( 0 ) );
+    vector< BeliefTracker > trackers;
+    trackers.reserve( nPlayers );
+    // The log, when there is one, follows the game alongside the console
+    EventLog* log = NULL;
+    EventFanout events;
+    events.add( &consoleEvents );
+    if ( logWriter.isOpen() )
+    {
+        log = new EventLog( logWriter );
+        events.add( log );
+    }
+    PlayerAgent* agents[ nPlayers ];
+    for ( int i = 0; i < nPlayers; i++ )
+    {
+        trackers.push_back( BeliefTracker( i ) );
+        agents[ i ] = &consoleAgent;
+        if ( computers[ i ] )
+        {
+            agents[ i ] = &mctsAgent;
+            consoleEvents.hideHand( i );
+            events.add( &trackers[ i ] );
+            mctsAgent.setBeliefTracker( i, &trackers[ i ] );
+        }
+    }
+
     // Initialize the Game object
-    Game game( names, nPlayers );
+    Game game( names, agents, nPlayers, goalScore, &events );
+
+    // Seed the random number generator (necessary for shuffling the deck), and start the game in the log
+    uint64_t seed = time( 0 );
+    game.seed( seed, 0 );
+    if ( log != NULL )
+    {
+        log->beginGame( seed, 0, nPlayers, goalScore );
+    }
 
     // Game loop (each iteration is a round)
     bool endGame = false;
@@ -119,8 +190,17 @@ int main()
         while ( !endRound )
         {
             // Print information for the current player, get their input, and process their turn
+            // A computer's hand stays hidden, so only whose turn it is is printed for them
+            // Processing the turn moves on to the next player unless the round is over
             cout << endl;
-            game.printTurnHeader();
+            if ( computers[ game.getCurrentPlayerIndex() ] )
+            {
+                cout << "*** " << game.getPlayerName( game.getCurrentPlayerIndex() ) << "'s Turn ***" << endl;
+            }
+            else
+            {
+                game.printTurnHeader();
+            }
             game.processPlayerTurn();
 
             // If the round is over, exit the loop
@@ -128,11 +208,6 @@ int main()
             {
                 endRound = true;
             }
-            // Otherwise, continue to the next player's turn
-            else
-            {
-                game.nextPlayer();
-            }
         }
 
         // Score the round
@@ -144,17 +219,17 @@ int main()
         game.printScores();
 
         // If this player has won the game, print a message and end the game
-        Player& winner = game.getRoundWinner();
+        string winnerName = game.getPlayerName( game.getRoundWinnerIndex() );
         cout << endl;
-        if ( winner.getScore() >= goalScore )
+        if ( game.gameIsOver() )
         {
             endGame = true;
-            cout << winner.getName() << " has won the game!" << endl;
+            cout << winnerName << " has won the game!" << endl;
         }
         // If not, print a message and continue to the next round
         else
         {
-            cout << winner.getName() << " has won Round " << round << "!" << endl;
+            cout << winnerName << " has won Round " << round << "!" << endl;
             round++;
 
             cout << "Press enter to continue to round " << round << ".";
@@ -162,7 +237,8 @@ int main()
         }
     }
 
-    // The game has ended, meaning someone has won, so exit the program
+    // The game has ended, meaning someone has won, so finish the log (deleting it ends its session) and exit the program
+    delete log;
     return 0;
 }
 